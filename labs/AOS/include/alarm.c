@@ -0,0 +1,399 @@
+/**
+ * @file alarm.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Named alarms and countdowns on the RTC compare channel
+ */
+
+#include "alarm.h"
+#include "timekeep.h"
+#include "ui.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <string.h>
+
+// RTC second and count within it
+typedef struct {
+  uint32_t sec;
+  uint16_t cnt;
+} stamp_t;
+
+typedef struct {
+  char name[ALARM_NAME_LEN + 1];
+  uint8_t state; // alarm_state_t
+  bool daily;
+  uint8_t pos;  // Heap index while waiting
+  stamp_t due;  // Deadline, or the time left while paused
+  uint32_t sod; // Daily: wall second of day
+} entry_t;
+
+//================================
+// Internal State
+//================================
+static entry_t entries[ALARM_MAX];
+static uint8_t heap[ALARM_MAX]; // Entry indices, earliest deadline first
+static uint8_t heap_len = 0;
+static alarm_fn_t due_fn = NULL;
+
+//================================
+// Internal Helpers (interrupts disabled)
+//================================
+
+static stamp_t stamp_now(void) {
+  stamp_t t;
+  t.cnt = RTC.CNT;
+  t.sec = rtc_interrupt_count;
+  if ((RTC.INTFLAGS & RTC_OVF_bm) && t.cnt < timekeep_period() / 2) {
+    t.sec++; // Overflowed, ISR not run yet
+  }
+  return t;
+}
+
+static bool earlier(const stamp_t *a, const stamp_t *b) {
+  int32_t d = (int32_t)(a->sec - b->sec);
+  return d < 0 || (d == 0 && a->cnt < b->cnt);
+}
+
+// a - b, for a not earlier than b
+static stamp_t stamp_diff(const stamp_t *a, const stamp_t *b) {
+  stamp_t d;
+  d.sec = a->sec - b->sec;
+  if (a->cnt < b->cnt) {
+    d.sec--;
+    d.cnt = (uint16_t)(a->cnt + timekeep_period() - b->cnt);
+  } else {
+    d.cnt = a->cnt - b->cnt;
+  }
+  return d;
+}
+
+static void heap_swap(uint8_t i, uint8_t j) {
+  uint8_t a = heap[i];
+  uint8_t b = heap[j];
+  heap[i] = b;
+  heap[j] = a;
+  entries[b].pos = i;
+  entries[a].pos = j;
+}
+
+static bool heap_before(uint8_t i, uint8_t j) {
+  return earlier(&entries[heap[i]].due, &entries[heap[j]].due);
+}
+
+static void sift_up(uint8_t i) {
+  while (i > 0) {
+    uint8_t parent = (i - 1) / 2;
+    if (!heap_before(i, parent)) {
+      break;
+    }
+    heap_swap(i, parent);
+    i = parent;
+  }
+}
+
+static void sift_down(uint8_t i) {
+  while (1) {
+    uint8_t least = i;
+    uint8_t left = 2 * i + 1;
+    if (left < heap_len && heap_before(left, least)) {
+      least = left;
+    }
+    if (left + 1 < heap_len && heap_before(left + 1, least)) {
+      least = left + 1;
+    }
+    if (least == i) {
+      return;
+    }
+    heap_swap(i, least);
+    i = least;
+  }
+}
+
+static void heap_insert(uint8_t id) {
+  heap[heap_len] = id;
+  entries[id].pos = heap_len;
+  heap_len++;
+  sift_up(heap_len - 1);
+}
+
+static void heap_remove(uint8_t id) {
+  uint8_t i = entries[id].pos;
+  heap_len--;
+  if (i != heap_len) {
+    heap[i] = heap[heap_len];
+    entries[heap[i]].pos = i;
+    sift_down(i);
+    sift_up(i);
+  }
+}
+
+// Next occurrence of a daily alarm's time of day, as an RTC second
+static void schedule_daily(entry_t *e) {
+  uint32_t wall = timekeep_seconds();
+  uint32_t at = wall - wall % TIMEKEEP_DAY + e->sod;
+  if (at <= wall) {
+    at += TIMEKEEP_DAY;
+  }
+  e->due.sec = at - timekeep_offset();
+  e->due.cnt = 0;
+}
+
+// Program the compare for the earliest deadline if it falls in the
+// running second, otherwise leave it to the overflow that starts that
+// second. Returns false if the earliest entry is already due.
+static bool arm(void) {
+  if (heap_len > 0) {
+    const stamp_t *due = &entries[heap[0]].due;
+    stamp_t now = stamp_now();
+    if (!earlier(&now, due)) {
+      return false;
+    }
+    if (due->sec == now.sec) {
+      while (RTC.STATUS & RTC_CMPBUSY_bm)
+        ; // Wait for compare sync, as RTC_WriteCompare() does
+      RTC.CMP = due->cnt;
+      RTC.INTFLAGS = RTC_CMP_bm;
+      RTC.INTCTRL |= RTC_CMP_bm;
+
+      // The count may have passed the compare while it synchronized
+      now = stamp_now();
+      return earlier(&now, due);
+    }
+  }
+  RTC.INTCTRL &= ~RTC_CMP_bm;
+  return true;
+}
+
+// Fire everything due, then arm for what is left
+static void service(void) {
+  while (!arm()) {
+    uint8_t id = heap[0];
+    entry_t *e = &entries[id];
+    heap_remove(id);
+    if (e->daily) {
+      // From the wall clock again: slewing moves the offset by whole
+      // seconds now and then. It may read a second short of this one.
+      uint32_t fired = e->due.sec;
+      schedule_daily(e);
+      if ((int32_t)(e->due.sec - fired) < (int32_t)(TIMEKEEP_DAY / 2)) {
+        e->due.sec += TIMEKEEP_DAY;
+      }
+      heap_insert(id);
+    } else {
+      e->state = ALARM_DONE;
+    }
+    if (due_fn != NULL) {
+      due_fn(id);
+    }
+  }
+}
+
+static uint8_t find(const char *name) {
+  for (uint8_t i = 0; i < ALARM_MAX; i++) {
+    if (entries[i].state != ALARM_FREE &&
+        strncasecmp(entries[i].name, name, ALARM_NAME_LEN) == 0) {
+      return i;
+    }
+  }
+  return ALARM_NONE;
+}
+
+static uint8_t first_in(uint8_t state) {
+  for (uint8_t i = 0; i < ALARM_MAX; i++) {
+    if (entries[i].state == state) {
+      return i;
+    }
+  }
+  return ALARM_NONE;
+}
+
+// The entry with this name (taken out of the heap), else a free one, else
+// a finished countdown
+static uint8_t claim(const char *name) {
+  uint8_t id = find(name);
+  if (id != ALARM_NONE) {
+    if (entries[id].state == ALARM_WAITING) {
+      heap_remove(id);
+    }
+    return id;
+  }
+  id = first_in(ALARM_FREE);
+  if (id == ALARM_NONE) {
+    id = first_in(ALARM_DONE);
+  }
+  if (id != ALARM_NONE) {
+    strncpy(entries[id].name, name, ALARM_NAME_LEN);
+    entries[id].name[ALARM_NAME_LEN] = '\0';
+  }
+  return id;
+}
+
+//================================
+// Public Interface
+//================================
+
+void alarm_init(alarm_fn_t on_due) {
+  uint8_t sreg = SREG;
+  cli();
+  memset(entries, 0, sizeof(entries));
+  heap_len = 0;
+  due_fn = on_due;
+  RTC.INTCTRL &= ~RTC_CMP_bm;
+  SREG = sreg;
+}
+
+uint8_t alarm_daily(const char *name, uint32_t second_of_day) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t id = claim(name);
+  if (id != ALARM_NONE) {
+    entry_t *e = &entries[id];
+    e->daily = true;
+    e->sod = second_of_day % TIMEKEEP_DAY;
+    e->state = ALARM_WAITING;
+    schedule_daily(e);
+    heap_insert(id);
+    service();
+  }
+  SREG = sreg;
+  return id;
+}
+
+uint8_t alarm_countdown(const char *name, uint32_t seconds) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t id = claim(name);
+  if (id != ALARM_NONE) {
+    entry_t *e = &entries[id];
+    e->daily = false;
+    e->state = ALARM_WAITING;
+    e->due = stamp_now();
+    e->due.sec += seconds;
+    heap_insert(id);
+    service();
+  }
+  SREG = sreg;
+  return id;
+}
+
+bool alarm_cancel(const char *name) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t id = find(name);
+  if (id != ALARM_NONE) {
+    if (entries[id].state == ALARM_WAITING) {
+      heap_remove(id);
+      service();
+    }
+    entries[id].state = ALARM_FREE;
+  }
+  SREG = sreg;
+  return id != ALARM_NONE;
+}
+
+bool alarm_pause(const char *name) {
+  uint8_t sreg = SREG;
+  cli();
+  service(); // Fire it first if it is already due
+  uint8_t id = find(name);
+  bool ok = id != ALARM_NONE && !entries[id].daily &&
+            entries[id].state == ALARM_WAITING;
+  if (ok) {
+    entry_t *e = &entries[id];
+    stamp_t now = stamp_now();
+    heap_remove(id);
+    e->due = stamp_diff(&e->due, &now);
+    e->state = ALARM_PAUSED;
+    service();
+  }
+  SREG = sreg;
+  return ok;
+}
+
+bool alarm_resume(const char *name) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t id = find(name);
+  bool ok = id != ALARM_NONE && entries[id].state == ALARM_PAUSED;
+  if (ok) {
+    entry_t *e = &entries[id];
+    stamp_t now = stamp_now();
+    uint32_t period = timekeep_period();
+    uint32_t cnt = (uint32_t)now.cnt + e->due.cnt;
+    e->due.sec += now.sec;
+    if (cnt >= period) {
+      cnt -= period;
+      e->due.sec++;
+    }
+    e->due.cnt = (uint16_t)cnt;
+    e->state = ALARM_WAITING;
+    heap_insert(id);
+    service();
+  }
+  SREG = sreg;
+  return ok;
+}
+
+uint8_t alarm_find(const char *name) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t id = find(name);
+  SREG = sreg;
+  return id;
+}
+
+uint8_t alarm_next(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t id = heap_len ? heap[0] : ALARM_NONE;
+  SREG = sreg;
+  return id;
+}
+
+bool alarm_get(uint8_t id, alarm_info_t *info) {
+  if (id >= ALARM_MAX) {
+    return false;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  entry_t e = entries[id];
+  stamp_t now = stamp_now();
+  uint32_t offset = timekeep_offset();
+  SREG = sreg;
+
+  if (e.state == ALARM_FREE) {
+    return false;
+  }
+  memcpy(info->name, e.name, sizeof(info->name));
+  info->state = e.state;
+  info->daily = e.daily;
+  info->at = 0;
+  info->left = 0;
+  if (e.state == ALARM_WAITING) {
+    info->at = e.due.sec + offset;
+    if (earlier(&now, &e.due)) {
+      stamp_t d = stamp_diff(&e.due, &now);
+      info->left = d.sec + (d.cnt != 0);
+    }
+  } else if (e.state == ALARM_PAUSED) {
+    info->left = e.due.sec + (e.due.cnt != 0);
+  }
+  return true;
+}
+
+void alarm_rebase(void) {
+  uint8_t sreg = SREG;
+  cli();
+  for (uint8_t i = 0; i < ALARM_MAX; i++) {
+    entry_t *e = &entries[i];
+    if (e->daily && e->state == ALARM_WAITING) {
+      heap_remove(i);
+      schedule_daily(e);
+      heap_insert(i);
+    }
+  }
+  service();
+  SREG = sreg;
+}
+
+void alarm_rtc_isr(void) { service(); }
@@ -0,0 +1,133 @@
+#ifndef ALARM_H_
+#define ALARM_H_
+
+/**
+ * @file alarm.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Named alarms and countdowns on the RTC compare channel
+ *
+ * Entries wait in a min-heap ordered by deadline. A deadline is an RTC
+ * second (rtc_interrupt_count) plus a count within it, so a countdown ends
+ * exactly its length after it was started, not on the next whole second.
+ * Only the earliest deadline is programmed into RTC.CMP, and only during
+ * the second it falls in: the overflow interrupt that starts that second
+ * arms the compare, and the compare interrupt fires the entry. Nothing
+ * polls the entries every second, and the cost of a deadline does not
+ * grow with the number of entries waiting (O(log n) per insert and fire).
+ *
+ * A daily alarm fires at a wall-clock time of day and re-arms itself 24 h
+ * later; alarm_rebase() moves daily alarms after the clock is stepped. A
+ * countdown fires once and stays listed as done until it is cancelled or
+ * started again. Paused countdowns leave the heap and keep their time left.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Number of entries */
+#define ALARM_MAX 8
+
+/** @brief Longest name (characters) */
+#define ALARM_NAME_LEN 7
+
+/** @brief No entry */
+#define ALARM_NONE 0xFF
+
+/**
+ * @brief Entry states
+ */
+typedef enum {
+  ALARM_FREE,
+  ALARM_WAITING, ///< In the heap
+  ALARM_PAUSED,  ///< Countdown holding its time left
+  ALARM_DONE     ///< Countdown that has fired
+} alarm_state_t;
+
+/**
+ * @brief Entry details for listing
+ */
+typedef struct {
+  char name[ALARM_NAME_LEN + 1];
+  uint8_t state; ///< alarm_state_t
+  bool daily;    ///< Daily alarm (true) or countdown
+  uint32_t at;   ///< Wall seconds when due (waiting)
+  uint32_t left; ///< Seconds left, rounded up (waiting or paused)
+} alarm_info_t;
+
+/**
+ * @brief Called when an entry fires (interrupt context)
+ * @param id Entry index, for alarm_get()
+ */
+typedef void (*alarm_fn_t)(uint8_t id);
+
+/**
+ * @brief Clear all entries (call after timekeep_init())
+ * @param on_due Called for every entry that fires
+ */
+void alarm_init(alarm_fn_t on_due);
+
+/**
+ * @brief Set a daily alarm, replacing any entry with the same name
+ * @param second_of_day Wall time of day, 0..86399
+ * @return Entry index, or ALARM_NONE if the table is full
+ */
+uint8_t alarm_daily(const char *name, uint32_t second_of_day);
+
+/**
+ * @brief Start a countdown, replacing any entry with the same name
+ * @param seconds Length, at least 1
+ * @return Entry index, or ALARM_NONE if the table is full
+ */
+uint8_t alarm_countdown(const char *name, uint32_t seconds);
+
+/**
+ * @brief Remove an entry
+ * @return false if there is no entry with this name
+ */
+bool alarm_cancel(const char *name);
+
+/**
+ * @brief Hold a waiting countdown
+ * @return false if there is no waiting countdown with this name
+ */
+bool alarm_pause(const char *name);
+
+/**
+ * @brief Continue a paused countdown from its time left
+ * @return false if there is no paused countdown with this name
+ */
+bool alarm_resume(const char *name);
+
+/**
+ * @brief Look up an entry by name (case-insensitive)
+ * @return Entry index, or ALARM_NONE
+ */
+uint8_t alarm_find(const char *name);
+
+/**
+ * @brief Entry with the earliest deadline
+ * @return Entry index, or ALARM_NONE if nothing is waiting
+ */
+uint8_t alarm_next(void);
+
+/**
+ * @brief Copy an entry's details
+ * @param id Entry index, 0..ALARM_MAX-1
+ * @return false if the entry is free
+ */
+bool alarm_get(uint8_t id, alarm_info_t *info);
+
+/**
+ * @brief Move daily alarms to the new wall time (after timekeep_set())
+ */
+void alarm_rebase(void);
+
+/**
+ * @brief Fire due entries and arm the compare for the next one
+ *
+ * Call from ISR(RTC_CNT_vect) on the overflow and on the compare match.
+ */
+void alarm_rtc_isr(void);
+
+#endif /* ALARM_H_ */
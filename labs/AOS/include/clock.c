@@ -0,0 +1,78 @@
+/**
+ * @file clock.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Monotonic uptime clock on the TCB0 cycle counter
+ */
+
+#include "clock.h"
+#include "perf.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+//================================
+// Internal State
+//================================
+static uint8_t cycles_per_us = 16;
+static uint32_t skip_hi = 0; // Cycles spent in STANDBY, upper 32 bits
+static uint16_t skip_lo = 0; // and lower 16 bits
+
+//================================
+// Internal Helpers
+//================================
+
+// Ticks as upper 32 and lower 16 bits (interrupts disabled)
+static void read_ticks(uint32_t *hi, uint16_t *lo) {
+  uint16_t cnt = TCB0.CNT;
+  uint32_t wraps = perf_overflows;
+  if ((TCB0.INTFLAGS & TCB_CAPT_bm) && cnt < 0x8000) {
+    wraps++; // Overflowed, ISR not run yet
+  }
+  uint32_t sum = (uint32_t)cnt + skip_lo;
+  *hi = wraps + skip_hi + (uint16_t)(sum >> 16);
+  *lo = (uint16_t)sum;
+}
+
+//================================
+// Public Interface
+//================================
+
+void clock_init(uint32_t f_clk_per) {
+  uint32_t mhz = f_clk_per / 1000000UL;
+  cycles_per_us = (mhz > 0 && mhz < 256) ? (uint8_t)mhz : 1;
+}
+
+uint64_t clock_now_ticks(void) {
+  uint32_t hi;
+  uint16_t lo;
+  uint8_t sreg = SREG;
+  cli();
+  read_ticks(&hi, &lo);
+  SREG = sreg;
+  return ((uint64_t)hi << 16) | lo;
+}
+
+uint32_t clock_now_us(void) {
+  uint32_t hi;
+  uint16_t lo;
+  uint8_t sreg = SREG;
+  cli();
+  read_ticks(&hi, &lo);
+  SREG = sreg;
+
+  // (hi * 65536 + lo) / cycles_per_us in 32-bit steps: the remainder of
+  // the upper part is below cycles_per_us, so the second step fits
+  uint32_t q = hi / cycles_per_us;
+  uint32_t r = hi % cycles_per_us;
+  return (q << 16) + (((r << 16) | lo) / cycles_per_us);
+}
+
+uint32_t clock_elapsed_us(uint32_t since) { return clock_now_us() - since; }
+
+uint64_t clock_ticks_to_us(uint64_t ticks) { return ticks / cycles_per_us; }
+
+void clock_skip(uint32_t cycles) {
+  uint32_t sum = (uint32_t)skip_lo + (uint16_t)cycles;
+  skip_hi += (cycles >> 16) + (sum >> 16);
+  skip_lo = (uint16_t)sum;
+}
@@ -0,0 +1,66 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+/**
+ * @file clock.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Monotonic uptime clock with CPU-cycle resolution
+ *
+ * Built on the PERF cycle counter: TCB0 free-runs at the CPU clock and its
+ * overflow interrupt counts the upper 32 bits, giving a 48-bit tick count
+ * (about 203 days at 16 MHz) that never goes backwards. Time spent in
+ * STANDBY, where TCB0 stands still, is added back from the RTC by idle.c,
+ * so uptime keeps pace with the wall clock.
+ *
+ * Reads disable interrupts for a few cycles and account for an overflow
+ * that is pending but not yet serviced, so they are safe from ISRs and
+ * from code that already runs with interrupts disabled.
+ *
+ * clock_now_us() is a wrap-safe 32-bit value (it wraps every 71 minutes):
+ * compare timestamps only through differences, e.g. CLOCK_AFTER(), never
+ * with < or >.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Check if 32-bit timestamp a is later than b (wrap-safe)
+ */
+#define CLOCK_AFTER(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)) > 0)
+
+/**
+ * @brief Set the tick rate (call after perf_init())
+ * @param f_clk_per CPU clock in Hz, a whole number of MHz
+ */
+void clock_init(uint32_t f_clk_per);
+
+/**
+ * @brief CPU cycles since boot (48 significant bits)
+ */
+uint64_t clock_now_ticks(void);
+
+/**
+ * @brief Microseconds since boot, modulo 2^32
+ */
+uint32_t clock_now_us(void);
+
+/**
+ * @brief Microseconds elapsed since an earlier clock_now_us() value
+ */
+uint32_t clock_elapsed_us(uint32_t since);
+
+/**
+ * @brief Convert CPU cycles to microseconds
+ */
+uint64_t clock_ticks_to_us(uint64_t ticks);
+
+/**
+ * @brief Add cycles that passed while the counter was stopped
+ *
+ * Called by idle.c after STANDBY, with interrupts disabled.
+ */
+void clock_skip(uint32_t cycles);
+
+#endif /* CLOCK_H_ */
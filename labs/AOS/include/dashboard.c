@@ -0,0 +1,150 @@
+/**
+ * @file dashboard.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Incremental VT100 status dashboard
+ */
+
+#include "dashboard.h"
+#include "ui.h"
+#include <stdio.h>
+#include <string.h>
+
+//================================
+// VT100 Sequences
+//================================
+#define VT_SAVE_CURSOR "\x1b" "7"
+#define VT_RESTORE_CURSOR "\x1b" "8"
+#define VT_CLEAR_SCREEN "\x1b[2J"
+#define VT_RESET_SCROLL "\x1b[r"
+#define VT_HOME "\x1b[H"
+
+//================================
+// Internal State
+//================================
+static const dash_field_t *dash_fields = NULL;
+static uint8_t dash_count = 0;
+static uint8_t dash_last_row = 0;
+static bool dash_on = false;
+static char dash_cache[DASH_MAX_FIELDS][DASH_VALUE_LEN + 1];
+static uint32_t dash_bytes = 0;
+static uint32_t dash_updates = 0;
+
+// Send a string and account for it in the bandwidth counter
+static void dash_put(const char *str) {
+  dash_bytes += strlen(str);
+  aos_send(str);
+}
+
+static void dash_goto(uint8_t row, uint8_t col) {
+  char seq[12];
+  snprintf(seq, sizeof(seq), "\x1b[%u;%uH", row, col);
+  dash_put(seq);
+}
+
+//================================
+// Public Interface
+//================================
+
+void dash_init(const dash_field_t *fields, uint8_t count) {
+  dash_fields = fields;
+  dash_count = (count > DASH_MAX_FIELDS) ? DASH_MAX_FIELDS : count;
+  dash_last_row = 0;
+  for (uint8_t i = 0; i < dash_count; i++) {
+    if (fields[i].row > dash_last_row) {
+      dash_last_row = fields[i].row;
+    }
+  }
+}
+
+void dash_start(void) {
+  if (dash_fields == NULL) {
+    return;
+  }
+
+  aos_send(VT_RESET_SCROLL VT_CLEAR_SCREEN);
+  for (uint8_t i = 0; i < dash_count; i++) {
+    dash_goto(dash_fields[i].row, dash_fields[i].col);
+    dash_put(dash_fields[i].label);
+    dash_cache[i][0] = '\0'; // Forces a full draw on first update
+  }
+
+  // Console scrolls below the dashboard, separated by one blank row
+  aos_printf("\x1b[%u;r\x1b[%u;1H", dash_last_row + 2, dash_last_row + 2);
+
+  dash_bytes = 0;
+  dash_updates = 0;
+  dash_on = true;
+  dash_update();
+}
+
+void dash_stop(void) {
+  if (!dash_on) {
+    return;
+  }
+  dash_on = false;
+  aos_send(VT_RESET_SCROLL VT_CLEAR_SCREEN VT_HOME);
+}
+
+bool dash_active(void) { return dash_on; }
+
+void dash_update(void) {
+  if (!dash_on) {
+    return;
+  }
+
+  bool cursor_saved = false;
+  char now[DASH_VALUE_LEN + 1];
+
+  for (uint8_t i = 0; i < dash_count; i++) {
+    const dash_field_t *field = &dash_fields[i];
+    char *old = dash_cache[i];
+    if (field->render == NULL) {
+      continue;
+    }
+
+    now[0] = '\0';
+    field->render(now);
+    now[DASH_VALUE_LEN] = '\0';
+
+    // Find the changed span; shorter strings are compared as space-padded
+    uint8_t new_len = strlen(now);
+    uint8_t old_len = strlen(old);
+    uint8_t len = (new_len > old_len) ? new_len : old_len;
+    int8_t first = -1;
+    int8_t last = -1;
+    for (uint8_t j = 0; j < len; j++) {
+      char a = (j < new_len) ? now[j] : ' ';
+      char b = (j < old_len) ? old[j] : ' ';
+      if (a != b) {
+        if (first < 0) {
+          first = j;
+        }
+        last = j;
+      }
+    }
+    if (first < 0) {
+      continue;
+    }
+
+    if (!cursor_saved) {
+      dash_put(VT_SAVE_CURSOR);
+      cursor_saved = true;
+    }
+    dash_goto(field->row, field->col + strlen(field->label) + first);
+    for (uint8_t j = first; j <= (uint8_t)last; j++) {
+      char c[2] = {(j < new_len) ? now[j] : ' ', '\0'};
+      dash_put(c);
+    }
+    strcpy(old, now);
+  }
+
+  if (cursor_saved) {
+    dash_put(VT_RESTORE_CURSOR);
+  }
+  dash_updates++;
+}
+
+uint32_t dash_bytes_sent(void) { return dash_bytes; }
+
+uint32_t dash_update_count(void) { return dash_updates; }
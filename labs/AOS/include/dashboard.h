@@ -0,0 +1,85 @@
+#ifndef DASHBOARD_H_
+#define DASHBOARD_H_
+
+/**
+ * @file dashboard.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Incremental VT100 status dashboard
+ *
+ * Draws a fixed layout of labelled fields at the top of the terminal once,
+ * then on every update re-renders each field into a small cache and sends
+ * only a cursor move plus the characters that actually changed. The rest of
+ * the screen becomes a scroll region, so the AOS> console keeps working
+ * underneath the dashboard.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Maximum number of fields in a layout */
+#define DASH_MAX_FIELDS 10
+
+/** @brief Maximum rendered length of one field value */
+#define DASH_VALUE_LEN 20 // "name -HH:MM:SS" of a 7-character alarm is 17
+
+/**
+ * @brief Render callback: write the field value (NUL-terminated) into buf
+ * @param buf Destination, DASH_VALUE_LEN + 1 bytes
+ */
+typedef void (*dash_render_t)(char *buf);
+
+/**
+ * @brief One dashboard field: static label followed by a live value
+ */
+typedef struct {
+  uint8_t row;          ///< Screen row (1-based)
+  uint8_t col;          ///< Screen column of the label (1-based)
+  const char *label;    ///< Static label text, drawn once
+  dash_render_t render; ///< Produces the value text (NULL: label only)
+} dash_field_t;
+
+/**
+ * @brief Register the dashboard layout (does not draw anything)
+ *
+ * @param fields Field table, must stay valid while the dashboard is in use
+ * @param count Number of fields (at most DASH_MAX_FIELDS)
+ */
+void dash_init(const dash_field_t *fields, uint8_t count);
+
+/**
+ * @brief Clear the screen, draw labels and reserve the top rows
+ *
+ * Everything below the last field row becomes the scroll region for
+ * normal console output.
+ */
+void dash_start(void);
+
+/**
+ * @brief Release the scroll region and return to plain console output
+ */
+void dash_stop(void);
+
+/**
+ * @brief Check if the dashboard is currently drawn
+ */
+bool dash_active(void);
+
+/**
+ * @brief Re-render all fields and send only the changed characters
+ *
+ * Cheap when nothing changed: no bytes are sent at all.
+ */
+void dash_update(void);
+
+/**
+ * @brief Total bytes sent by dash_update() since dash_start()
+ */
+uint32_t dash_bytes_sent(void);
+
+/**
+ * @brief Number of dash_update() calls since dash_start()
+ */
+uint32_t dash_update_count(void);
+
+#endif /* DASHBOARD_H_ */
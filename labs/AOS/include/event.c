@@ -0,0 +1,110 @@
+/**
+ * @file event.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Event queue and dispatch table for the main loop
+ */
+
+#include "event.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stddef.h>
+
+#define QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+typedef struct {
+  uint8_t type;
+  uint8_t arg;
+} event_t;
+
+//================================
+// Internal State
+//================================
+static event_handler_t handlers[EV_COUNT];
+static event_t queue[EVENT_QUEUE_SIZE];
+static volatile uint8_t head = 0; // Next free slot
+static volatile uint8_t tail = 0; // Oldest event
+static volatile uint8_t count = 0;
+static uint8_t queued[EV_COUNT]; // Per type, for event_post_once()
+static event_stats_t stats;
+static void (*notify_hook)(void) = NULL;
+
+//================================
+// Public Interface
+//================================
+
+void event_register(uint8_t type, event_handler_t handler) {
+  if (type < EV_COUNT) {
+    handlers[type] = handler;
+  }
+}
+
+bool event_post(uint8_t type, uint8_t arg) {
+  bool posted = false;
+  uint8_t sreg = SREG;
+  cli();
+  if (count < EVENT_QUEUE_SIZE) {
+    queue[head].type = type;
+    queue[head].arg = arg;
+    head = (head + 1) & QUEUE_MASK;
+    if (type < EV_COUNT) {
+      queued[type]++;
+    }
+    if (++count > stats.peak) {
+      stats.peak = count;
+    }
+    posted = true;
+  } else {
+    stats.dropped++;
+  }
+  SREG = sreg;
+  if (posted && notify_hook != NULL) {
+    notify_hook();
+  }
+  return posted;
+}
+
+bool event_post_once(uint8_t type, uint8_t arg) {
+  uint8_t sreg = SREG;
+  cli();
+  bool waiting = type < EV_COUNT && queued[type] != 0;
+  SREG = sreg;
+  // An ISR could post in between: at worst one extra event, never none
+  return waiting || event_post(type, arg);
+}
+
+uint8_t event_dispatch(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t todo = count;
+  SREG = sreg;
+
+  for (uint8_t i = 0; i < todo; i++) {
+    sreg = SREG;
+    cli();
+    event_t ev = queue[tail];
+    tail = (tail + 1) & QUEUE_MASK;
+    count--;
+    if (ev.type < EV_COUNT) {
+      queued[ev.type]--;
+    }
+    stats.dispatched++;
+    SREG = sreg;
+
+    if (ev.type < EV_COUNT && handlers[ev.type] != NULL) {
+      handlers[ev.type](ev.arg);
+    }
+  }
+  return todo;
+}
+
+void event_set_notify(void (*notify)(void)) { notify_hook = notify; }
+
+bool event_pending(void) { return count != 0; }
+
+void event_get_stats(event_stats_t *out) {
+  uint8_t sreg = SREG;
+  cli();
+  *out = stats;
+  SREG = sreg;
+}
@@ -0,0 +1,95 @@
+#ifndef EVENT_H_
+#define EVENT_H_
+
+/**
+ * @file event.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Event queue and dispatch table for the main loop
+ *
+ * ISRs (and handlers) post small typed events into a FIFO; the main loop
+ * pops them in posting order and calls the handler registered for each
+ * type, with interrupts enabled. Every post is a separate event, so two
+ * button presses during a long aos_printf() are two calls, not one flag.
+ *
+ * A full queue rejects the post and counts it in the dropped statistic.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Queue depth (power of two) */
+#define EVENT_QUEUE_SIZE 32
+
+//================================
+// Event Types
+//================================
+#define EV_CONSOLE 0 ///< UART input or console work left (posted once)
+#define EV_BUTTON 1  ///< Button held for one second
+#define EV_SECOND 2  ///< RTC second elapsed (arg: seconds)
+#define EV_ALARM 3   ///< Alarm time reached
+#define EV_STATUS 4  ///< Periodic status report due
+#define EV_COUNT 5   ///< Number of event types
+
+typedef void (*event_handler_t)(uint8_t arg);
+
+/**
+ * @brief Queue statistics since boot
+ */
+typedef struct {
+  uint32_t dispatched; ///< Events handled
+  uint16_t dropped;    ///< Posts rejected because the queue was full
+  uint8_t peak;        ///< Highest queue depth seen
+} event_stats_t;
+
+/**
+ * @brief Set (or clear with NULL) the handler for an event type
+ */
+void event_register(uint8_t type, event_handler_t handler);
+
+/**
+ * @brief Queue an event (ISR-safe)
+ * @return false if the queue is full
+ */
+bool event_post(uint8_t type, uint8_t arg);
+
+/**
+ * @brief Queue an event unless one of that type is already waiting
+ *
+ * For events that mean "there is work": a pasted line posts one console
+ * event instead of filling the queue with one per byte. An event counts as
+ * waiting until its handler is called, so a post while the handler runs
+ * queues a new one.
+ *
+ * @return true if the event is queued, by this call or before it
+ */
+bool event_post_once(uint8_t type, uint8_t arg);
+
+/**
+ * @brief Handle the events queued at the time of the call
+ *
+ * Events posted by the handlers themselves wait for the next call, so a
+ * handler that re-posts its own type cannot starve the others.
+ *
+ * @return Number of events handled
+ */
+uint8_t event_dispatch(void);
+
+/**
+ * @brief Set a function to call after every successful post
+ * @param notify Must be safe to call from ISRs, e.g. a semaphore post
+ *               that wakes a consumer task (NULL removes it)
+ */
+void event_set_notify(void (*notify)(void));
+
+/**
+ * @brief Check if any event is queued
+ */
+bool event_pending(void);
+
+/**
+ * @brief Copy the queue statistics
+ */
+void event_get_stats(event_stats_t *stats);
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,232 @@
+/**
+ * @file idle.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Tickless idle: sleep the main loop until the next event
+ */
+
+#include "idle.h"
+#include "clock.h"
+#include "loadmon.h"
+#include "perf.h"
+#include "swtimer.h"
+#include "timekeep.h"
+#include "trace.h"
+#include "uart.h"
+#include "ui.h"
+#include <avr/cpufunc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/sleep.h>
+
+// TCA0 counts that must remain before the overflow to stretch the period
+#define STRETCH_GUARD 2
+
+#ifdef AOS_IDLE_PROBE
+#define PROBE_ASLEEP() (PORTC.OUTCLR = PIN6_bm)
+#define PROBE_AWAKE() (PORTC.OUTSET = PIN6_bm)
+#else
+#define PROBE_ASLEEP()
+#define PROBE_AWAKE()
+#endif
+
+//================================
+// Internal State
+//================================
+static uint16_t tick_counts = 625;     // TCA0 counts per swtimer tick
+static uint8_t max_stretch = 1;        // Ticks that fit in a 16-bit period
+static volatile uint8_t stretch = 1;   // Ticks covered by the running period
+static uint32_t tca_hz = 62500;        // TCA0 count rate
+static uint16_t cycles_per_count = 256;
+static uint16_t rtc_hz = 32768;
+static uint16_t rtc_residue = 0;       // Carried conversion remainder
+static uint16_t pit_ticks = 0xFFFF;    // STANDBY only if due beyond this
+static idle_stats_t stats;
+static bool (*work_pending)(void) = NULL;
+
+//================================
+// Internal Helpers (interrupts disabled)
+//================================
+
+// RTC counts since boot (mod 2^32), including a pending overflow. Both
+// ends of a sleep use the same period, which rtccal.c may change.
+static uint32_t rtc_stamp(uint32_t period) {
+  uint16_t cnt = RTC.CNT;
+  uint32_t wraps = rtc_interrupt_count;
+  if ((RTC.INTFLAGS & RTC_OVF_bm) && cnt < period / 2) {
+    wraps++;
+  }
+  return wraps * period + cnt;
+}
+
+// Move the wheel forward by elapsed TCA0 counts, keeping the tick phase,
+// and put back the normal one-tick period
+static void advance(uint32_t counts) {
+  counts += TCA0.SINGLE.CNT;
+  uint16_t ticks = counts / tick_counts;
+  TCA0.SINGLE.CNT = counts % tick_counts;
+  TCA0.SINGLE.PER = tick_counts - 1;
+  stretch = 1;
+
+  stats.ticks_skipped += ticks;
+  while (ticks--) {
+    swtimer_tick();
+  }
+}
+
+static void sleep_idle(uint16_t due) {
+  if (due > 1 && TCA0.SINGLE.CNT < tick_counts - STRETCH_GUARD) {
+    stretch = (due > max_stretch) ? max_stretch : (uint8_t)due;
+    TCA0.SINGLE.PER = stretch * tick_counts - 1;
+  }
+  stats.idle_sleeps++;
+  TRACE_SLEEP(false);
+
+  uint32_t start = perf_now();
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  PROBE_ASLEEP();
+  sleep_enable();
+  sei();
+  sleep_cpu(); // The waking ISR runs before this returns
+  sleep_disable();
+  PROBE_AWAKE();
+  loadmon_sleep(perf_now() - start, false);
+  TRACE_WAKE(0);
+
+  // Woken before the stretched period ended: fold in the ticks so far
+  cli();
+  if (stretch > 1 && !(TCA0.SINGLE.INTFLAGS & TCA_SINGLE_OVF_bm)) {
+    advance(0);
+  }
+  sei();
+}
+
+static void sleep_standby(bool timed) {
+  uint32_t period = timekeep_period(); // RTC counts per second
+  uint32_t start = rtc_stamp(period);
+  if (timed) {
+    RTC.PITINTFLAGS = RTC_PI_bm;
+    RTC.PITINTCTRL = RTC_PI_bm;
+  }
+  stats.standby_sleeps++;
+  TRACE_SLEEP(true);
+
+  set_sleep_mode(SLEEP_MODE_STANDBY);
+  PROBE_ASLEEP();
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+  PROBE_AWAKE();
+
+  // TCA0 and the cycle counter stood still; the RTC kept counting
+  cli();
+  RTC.PITINTCTRL = 0;
+  uint32_t elapsed = rtc_stamp(period) - start;
+  if (elapsed > 0xFFFF) {
+    elapsed = 0xFFFF; // Cannot happen while the RTC overflow wakes us
+  }
+  uint32_t scaled = elapsed * tca_hz + rtc_residue;
+  uint32_t counts = scaled / period;
+  rtc_residue = scaled % period;
+  loadmon_sleep(counts * cycles_per_count, true);
+  clock_skip(counts * cycles_per_count);
+  TRACE_WAKE(counts * cycles_per_count);
+  advance(counts);
+  sei();
+}
+
+//================================
+// Public Interface
+//================================
+
+void idle_init(uint32_t f_cpu_hz, uint16_t rtc_clock_hz) {
+  tick_counts = TCA0.SINGLE.PER + 1;
+  max_stretch = (uint8_t)(0xFFFFU / tick_counts);
+  tca_hz = (uint32_t)tick_counts * (1000 / SWTIMER_TICK_MS);
+  cycles_per_count = (uint16_t)(f_cpu_hz / tca_hz);
+  rtc_hz = rtc_clock_hz;
+
+  // PIT paces long STANDBY sleeps at about 1/8 s (CYC4 is 2^2 cycles)
+  uint8_t shift = 2;
+  while ((1UL << (shift + 1)) <= rtc_hz / 8) {
+    shift++;
+  }
+  pit_ticks = (uint16_t)((((1UL << shift) * (1000 / SWTIMER_TICK_MS)) +
+                          rtc_hz - 1) / rtc_hz + 1);
+  while (RTC.PITSTATUS & RTC_CTRLBUSY_bm) {
+    ; // Wait for synchronization
+  }
+  RTC.PITCTRLA = ((shift - 1) << RTC_PERIOD_gp) | RTC_PITEN_bm;
+
+  // An RX start bit wakes the CPU from STANDBY
+  IDLE_USART.CTRLB |= USART_SFDEN_bm;
+  IDLE_USART.CTRLA |= USART_RXSIE_bm;
+
+  // cpu.c clears RUNSTDBY; keep the crystal up so wakeups are immediate
+  ccp_write_io((uint8_t *)&CLKCTRL.XOSCHFCTRLA,
+               CLKCTRL.XOSCHFCTRLA | CLKCTRL_RUNSTDBY_bm);
+
+#ifdef AOS_IDLE_PROBE
+  PORTC.DIRSET = PIN6_bm;
+  PORTC.OUTSET = PIN6_bm;
+#endif
+}
+
+void idle_set_work_check(bool (*pending)(void)) { work_pending = pending; }
+
+void idle_sleep(bool allow_standby) {
+  cli();
+  if (swtimer_deferred_pending() || uart_rx_available() ||
+      (TCA0.SINGLE.INTFLAGS & TCA_SINGLE_OVF_bm) ||
+      (work_pending != NULL && work_pending())) {
+    sei();
+    return; // Work already waiting
+  }
+
+  // STANDBY would cut off a frame still in the shift register
+  bool tx_idle = !(IDLE_USART.CTRLA & USART_DREIE_bm) &&
+                 (IDLE_USART.STATUS & USART_TXCIF_bm);
+  uint16_t due = swtimer_next_due();
+
+  if (allow_standby && tx_idle && due > pit_ticks) {
+    sleep_standby(due != SWTIMER_NEVER);
+  } else {
+    sleep_idle(due);
+  }
+}
+
+void idle_tick(void) {
+  uint8_t ticks = stretch;
+  if (ticks > 1) {
+    TCA0.SINGLE.PER = tick_counts - 1;
+    stretch = 1;
+    stats.ticks_skipped += ticks - 1;
+  }
+  while (ticks--) {
+    swtimer_tick();
+  }
+}
+
+void idle_get_stats(idle_stats_t *out) {
+  uint8_t sreg = SREG;
+  cli();
+  *out = stats;
+  SREG = sreg;
+}
+
+void idle_reset(void) {
+  uint8_t sreg = SREG;
+  cli();
+  stats.idle_sleeps = 0;
+  stats.standby_sleeps = 0;
+  stats.ticks_skipped = 0;
+  SREG = sreg;
+}
+
+//================================
+// PIT ISR
+//================================
+
+// Only ends a STANDBY; idle_sleep() accounts for the time
+ISR(RTC_PIT_vect) { RTC.PITINTFLAGS = RTC_PI_bm; }
@@ -0,0 +1,469 @@
+/**
+ * @file kernel.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Small preemptive priority kernel (make KERNEL=1)
+ */
+
+#include "kernel.h"
+#include "memmon.h"
+#include "perf.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stddef.h>
+#include <string.h>
+
+#define IDLE_TASK 0
+
+/**
+ * Task control block. sp must stay first: the context switch code stores
+ * the stack pointer through kernel_current directly.
+ */
+typedef struct {
+  uint8_t *sp;
+  const char *name;
+  uint8_t *stack;
+  uint16_t stack_size;
+  uint8_t priority;
+  uint8_t state;
+  bool timed;       // WAITING with a timeout (wake is valid)
+  bool timed_out;   // Result of the last wait
+  uint16_t wake;    // Tick to become ready at
+  ksem_t *wait;     // Semaphore blocked on, NULL for a plain delay
+  uint32_t runs;
+} ktask_t;
+
+//================================
+// Internal State
+//================================
+ktask_t *volatile kernel_current; // Referenced by name from the asm below
+
+static ktask_t tasks[KERNEL_MAX_TASKS];
+static uint8_t task_count = 1; // Slot 0 is the idle task
+static volatile uint16_t ticks = 0;
+static bool started = false;
+
+// Yield-to-resume timing for the SWITCH profiling site
+static volatile bool measure_switch = false;
+static uint32_t switch_start = 0;
+
+//================================
+// Context Switch
+//================================
+
+// Push r0, SREG (then cli), RAMPZ, r1..r31 and store SP in the TCB
+#define SAVE_CONTEXT()                                                      \
+  asm volatile("push r0                  \n\t"                            \
+               "in   r0, __SREG__        \n\t"                            \
+               "cli                      \n\t"                            \
+               "push r0                  \n\t"                            \
+               "in   r0, %[rampz]        \n\t"                            \
+               "push r0                  \n\t"                            \
+               "push r1                  \n\t"                            \
+               "clr  r1                  \n\t"                            \
+               "push r2                  \n\t"                            \
+               "push r3                  \n\t"                            \
+               "push r4                  \n\t"                            \
+               "push r5                  \n\t"                            \
+               "push r6                  \n\t"                            \
+               "push r7                  \n\t"                            \
+               "push r8                  \n\t"                            \
+               "push r9                  \n\t"                            \
+               "push r10                 \n\t"                            \
+               "push r11                 \n\t"                            \
+               "push r12                 \n\t"                            \
+               "push r13                 \n\t"                            \
+               "push r14                 \n\t"                            \
+               "push r15                 \n\t"                            \
+               "push r16                 \n\t"                            \
+               "push r17                 \n\t"                            \
+               "push r18                 \n\t"                            \
+               "push r19                 \n\t"                            \
+               "push r20                 \n\t"                            \
+               "push r21                 \n\t"                            \
+               "push r22                 \n\t"                            \
+               "push r23                 \n\t"                            \
+               "push r24                 \n\t"                            \
+               "push r25                 \n\t"                            \
+               "push r26                 \n\t"                            \
+               "push r27                 \n\t"                            \
+               "push r28                 \n\t"                            \
+               "push r29                 \n\t"                            \
+               "push r30                 \n\t"                            \
+               "push r31                 \n\t"                            \
+               "lds  r26, kernel_current \n\t"                            \
+               "lds  r27, kernel_current+1 \n\t"                          \
+               "in   r0, __SP_L__        \n\t"                            \
+               "st   x+, r0              \n\t"                            \
+               "in   r0, __SP_H__        \n\t"                            \
+               "st   x+, r0              \n\t"                            \
+               ::[rampz] "I"(_SFR_IO_ADDR(RAMPZ)))
+
+// Load SP from the TCB and pop everything SAVE_CONTEXT() pushed
+#define RESTORE_CONTEXT()                                                   \
+  asm volatile("lds  r26, kernel_current \n\t"                            \
+               "lds  r27, kernel_current+1 \n\t"                          \
+               "ld   r28, x+             \n\t"                            \
+               "out  __SP_L__, r28       \n\t"                            \
+               "ld   r29, x+             \n\t"                            \
+               "out  __SP_H__, r29       \n\t"                            \
+               "pop  r31                 \n\t"                            \
+               "pop  r30                 \n\t"                            \
+               "pop  r29                 \n\t"                            \
+               "pop  r28                 \n\t"                            \
+               "pop  r27                 \n\t"                            \
+               "pop  r26                 \n\t"                            \
+               "pop  r25                 \n\t"                            \
+               "pop  r24                 \n\t"                            \
+               "pop  r23                 \n\t"                            \
+               "pop  r22                 \n\t"                            \
+               "pop  r21                 \n\t"                            \
+               "pop  r20                 \n\t"                            \
+               "pop  r19                 \n\t"                            \
+               "pop  r18                 \n\t"                            \
+               "pop  r17                 \n\t"                            \
+               "pop  r16                 \n\t"                            \
+               "pop  r15                 \n\t"                            \
+               "pop  r14                 \n\t"                            \
+               "pop  r13                 \n\t"                            \
+               "pop  r12                 \n\t"                            \
+               "pop  r11                 \n\t"                            \
+               "pop  r10                 \n\t"                            \
+               "pop  r9                  \n\t"                            \
+               "pop  r8                  \n\t"                            \
+               "pop  r7                  \n\t"                            \
+               "pop  r6                  \n\t"                            \
+               "pop  r5                  \n\t"                            \
+               "pop  r4                  \n\t"                            \
+               "pop  r3                  \n\t"                            \
+               "pop  r2                  \n\t"                            \
+               "pop  r1                  \n\t"                            \
+               "pop  r0                  \n\t"                            \
+               "out  %[rampz], r0        \n\t"                            \
+               "pop  r0                  \n\t"                            \
+               "out  __SREG__, r0        \n\t"                            \
+               "pop  r0                  \n\t"                            \
+               ::[rampz] "I"(_SFR_IO_ADDR(RAMPZ)))
+
+// Called by name from the asm below, so not static
+void kernel_select_next(void);
+void kernel_tick_isr(void);
+
+// Pick the highest-priority ready task; scanning from the one after the
+// current task rotates tasks of equal priority
+void kernel_select_next(void) {
+  uint8_t current = kernel_current - tasks;
+  ktask_t *best = &tasks[IDLE_TASK];
+  uint8_t index = current;
+  for (uint8_t i = 0; i < task_count; i++) {
+    if (++index >= task_count) {
+      index = 0;
+    }
+    ktask_t *t = &tasks[index];
+    if (t->state == KTASK_READY && t->priority > best->priority) {
+      best = t;
+    }
+  }
+  if (best != kernel_current) {
+    best->runs++;
+    kernel_current = best;
+  }
+}
+
+// Called with interrupts disabled from the tick ISR
+void kernel_tick_isr(void) {
+  TCB2.INTFLAGS = TCB_CAPT_bm;
+  uint16_t now = ++ticks;
+  for (uint8_t i = 1; i < task_count; i++) {
+    ktask_t *t = &tasks[i];
+    if (t->state == KTASK_WAITING && t->timed && t->wake == now) {
+      t->timed_out = (t->wait != NULL);
+      t->wait = NULL;
+      t->state = KTASK_READY;
+    }
+  }
+  measure_switch = false; // A preemption is not a timed yield
+  kernel_select_next();
+}
+
+static void switch_context(void) __attribute__((naked, noinline));
+static void switch_context(void) {
+  SAVE_CONTEXT();
+  asm volatile("call kernel_select_next");
+  RESTORE_CONTEXT();
+  asm volatile("ret");
+}
+
+ISR(TCB2_INT_vect, ISR_NAKED) {
+  SAVE_CONTEXT();
+  asm volatile("call kernel_tick_isr");
+  RESTORE_CONTEXT();
+  reti();
+}
+
+//================================
+// Internal Helpers
+//================================
+
+static bool in_isr(void) {
+  return (CPUINT.STATUS &
+          (CPUINT_LVL0EX_bm | CPUINT_LVL1EX_bm | CPUINT_NMIEX_bm)) != 0;
+}
+
+// Runs the task function, then parks the task for good
+static void trampoline(void *arg, ktask_entry_t entry) {
+  entry(arg);
+  cli();
+  kernel_current->state = KTASK_DONE;
+  ktask_yield();
+  while (1) {
+    ; // Never scheduled again
+  }
+}
+
+// Mark the caller waiting (interrupts disabled)
+static void block(ksem_t *sem, uint16_t timeout) {
+  kernel_current->wait = sem;
+  kernel_current->timed = (timeout != KERNEL_FOREVER);
+  kernel_current->timed_out = false;
+  kernel_current->wake = ticks + timeout;
+  kernel_current->state = KTASK_WAITING;
+}
+
+//================================
+// Public Interface
+//================================
+
+int8_t ktask_create(const char *name, ktask_entry_t entry, void *arg,
+                    uint8_t priority, uint8_t *stack, uint16_t stack_size) {
+  if (task_count >= KERNEL_MAX_TASKS || stack_size < KERNEL_MIN_STACK ||
+      priority == 0) {
+    return -1;
+  }
+
+  // Painted so TASKS can report the high-water mark
+  memset(stack, MEMMON_CANARY, stack_size);
+
+  // Initial frame as SAVE_CONTEXT() would leave it, returning into the
+  // trampoline with arg in r25:r24 and entry in r23:r22
+  uint16_t pc = (uint16_t)trampoline;
+  uint8_t *sp = stack + stack_size - 1;
+  *sp-- = pc & 0xFF;
+  *sp-- = pc >> 8;
+  *sp-- = 0x00;            // r0
+  *sp-- = CPU_I_bm;        // SREG: interrupts enabled
+  *sp-- = 0x00;            // RAMPZ
+  for (uint8_t r = 1; r <= 31; r++) {
+    uint8_t value = 0;
+    if (r == 22) {
+      value = (uint16_t)entry & 0xFF;
+    } else if (r == 23) {
+      value = (uint16_t)entry >> 8;
+    } else if (r == 24) {
+      value = (uint16_t)arg & 0xFF;
+    } else if (r == 25) {
+      value = (uint16_t)arg >> 8;
+    }
+    *sp-- = value;
+  }
+
+  uint8_t sreg = SREG;
+  cli();
+  int8_t index = task_count;
+  ktask_t *t = &tasks[index];
+  t->sp = sp;
+  t->name = name;
+  t->stack = stack;
+  t->stack_size = stack_size;
+  t->priority = priority;
+  t->wait = NULL;
+  t->timed = false;
+  t->runs = 0;
+  t->state = KTASK_READY;
+  task_count++;
+  SREG = sreg;
+  return index;
+}
+
+void kernel_start(uint32_t f_clk_per, void (*idle_hook)(void)) {
+  ktask_t *idle = &tasks[IDLE_TASK];
+  idle->name = "idle";
+  idle->priority = 0;
+  idle->state = KTASK_READY;
+  kernel_current = idle;
+
+  // TCB2 periodic interrupt at KERNEL_TICK_HZ from CLK_PER/2
+  TCB2.CTRLA = 0;
+  TCB2.CTRLB = TCB_CNTMODE_INT_gc;
+  TCB2.CNT = 0;
+  TCB2.CCMP = (uint16_t)(f_clk_per / 2 / KERNEL_TICK_HZ - 1);
+  TCB2.INTFLAGS = TCB_CAPT_bm;
+  TCB2.INTCTRL = TCB_CAPT_bm;
+  TCB2.CTRLA = TCB_CLKSEL_DIV2_gc | TCB_ENABLE_bm;
+
+  started = true;
+  sei();
+  ktask_yield(); // Highest-priority task runs first
+
+  while (1) {
+    if (idle_hook) {
+      idle_hook();
+    }
+    // Woken by an ISR that readied a task: switch now, not at the tick
+    for (uint8_t i = 1; i < task_count; i++) {
+      if (tasks[i].state == KTASK_READY) {
+        ktask_yield();
+        break;
+      }
+    }
+  }
+}
+
+uint16_t kernel_ticks(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t now = ticks;
+  SREG = sreg;
+  return now;
+}
+
+void ktask_yield(void) {
+  uint8_t sreg = SREG;
+  cli();
+  switch_start = perf_now();
+  measure_switch = true;
+  switch_context();
+
+  // Resumed: time it if the previous task got here by yielding too
+  if (measure_switch) {
+    measure_switch = false;
+    perf_record(PERF_SITE_SWITCH, perf_now() - switch_start);
+  }
+  SREG = sreg;
+}
+
+void ktask_delay(uint16_t delay) {
+  if (delay == 0) {
+    ktask_yield();
+    return;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  block(NULL, delay);
+  ktask_yield();
+  SREG = sreg;
+}
+
+bool ktask_info(uint8_t index, ktask_info_t *info) {
+  if (index >= task_count) {
+    return false;
+  }
+  const ktask_t *t = &tasks[index];
+  info->name = t->name;
+  info->priority = t->priority;
+  info->state = t->state;
+  info->stack_size = t->stack_size;
+  info->stack_used = 0;
+  if (t->stack) {
+    uint16_t untouched = 0;
+    while (untouched < t->stack_size && t->stack[untouched] == MEMMON_CANARY) {
+      untouched++;
+    }
+    info->stack_used = t->stack_size - untouched;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  info->runs = t->runs;
+  SREG = sreg;
+  return true;
+}
+
+uint16_t ktask_overhead(void) { return sizeof(ktask_t); }
+
+bool ksem_wait(ksem_t *sem, uint16_t timeout) {
+  uint8_t sreg = SREG;
+  cli();
+  if (sem->count) {
+    sem->count--;
+    SREG = sreg;
+    return true;
+  }
+  if (timeout == KERNEL_NO_WAIT || !started || in_isr()) {
+    SREG = sreg;
+    return false;
+  }
+  block(sem, timeout);
+  ktask_yield();
+  bool taken = !kernel_current->timed_out;
+  SREG = sreg;
+  return taken;
+}
+
+void ksem_post(ksem_t *sem) {
+  uint8_t sreg = SREG;
+  cli();
+  ktask_t *best = NULL;
+  for (uint8_t i = 1; i < task_count; i++) {
+    ktask_t *t = &tasks[i];
+    if (t->state == KTASK_WAITING && t->wait == sem &&
+        (best == NULL || t->priority > best->priority)) {
+      best = t;
+    }
+  }
+
+  if (best) {
+    // Hand the count straight to the waiter
+    best->wait = NULL;
+    best->timed_out = false;
+    best->state = KTASK_READY;
+    if (started && !in_isr() && best->priority > kernel_current->priority) {
+      ktask_yield();
+    }
+  } else if (sem->count < 0xFF) {
+    sem->count++;
+  }
+  SREG = sreg;
+}
+
+void kqueue_init(kqueue_t *queue, void *storage, uint8_t item_size,
+                 uint8_t capacity) {
+  queue->buffer = storage;
+  queue->item_size = item_size;
+  queue->capacity = capacity;
+  queue->head = 0;
+  queue->tail = 0;
+  queue->items.count = 0;
+  queue->spaces.count = capacity;
+}
+
+bool kqueue_send(kqueue_t *queue, const void *item, uint16_t timeout) {
+  if (!ksem_wait(&queue->spaces, timeout)) {
+    return false;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  memcpy(&queue->buffer[queue->head * queue->item_size], item,
+         queue->item_size);
+  if (++queue->head == queue->capacity) {
+    queue->head = 0;
+  }
+  SREG = sreg;
+  ksem_post(&queue->items);
+  return true;
+}
+
+bool kqueue_receive(kqueue_t *queue, void *item, uint16_t timeout) {
+  if (!ksem_wait(&queue->items, timeout)) {
+    return false;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  memcpy(item, &queue->buffer[queue->tail * queue->item_size],
+         queue->item_size);
+  if (++queue->tail == queue->capacity) {
+    queue->tail = 0;
+  }
+  SREG = sreg;
+  ksem_post(&queue->spaces);
+  return true;
+}
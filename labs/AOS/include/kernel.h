@@ -0,0 +1,167 @@
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+/**
+ * @file kernel.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Small preemptive priority kernel (make KERNEL=1)
+ *
+ * A fixed table of tasks, each with its own statically allocated stack.
+ * The highest-priority ready task runs; tasks of equal priority take
+ * turns at every tick. TCB2 provides the 1 ms tick. The task calling
+ * kernel_start() becomes the idle task (priority 0, on the main stack).
+ *
+ * Blocking primitives are counting semaphores and fixed-size queues built
+ * on them. ksem_post() and the KERNEL_NO_WAIT forms may be used from ISRs;
+ * a task made ready by an ISR runs when that ISR wakes the idle task, or
+ * at the latest on the next tick if another task was running.
+ *
+ * A context saves 35 bytes (r0-r31, SREG, RAMPZ) plus the return
+ * address on the task's stack. TASKS lists each task's stack high-water
+ * mark; the PERF site SWITCH times a full yield (save, select, restore).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Task table size, including the idle task */
+#define KERNEL_MAX_TASKS 5
+
+/** @brief Tick rate (TCB2 periodic interrupt) */
+#define KERNEL_TICK_HZ 1000
+
+/** @brief Convert milliseconds to ticks */
+#define KERNEL_MS(ms) ((uint16_t)((ms) * KERNEL_TICK_HZ / 1000))
+
+/** @brief Smallest useful stack: one context plus a few call frames */
+#define KERNEL_MIN_STACK 96
+
+//================================
+// Timeouts (in ticks)
+//================================
+#define KERNEL_NO_WAIT 0       ///< Fail at once instead of blocking
+#define KERNEL_FOREVER 0xFFFF  ///< Block without timeout
+
+//================================
+// Task States
+//================================
+#define KTASK_UNUSED 0
+#define KTASK_READY 1   ///< Running or waiting for the CPU
+#define KTASK_WAITING 2 ///< Delayed or blocked on a semaphore
+#define KTASK_DONE 3    ///< Entry function returned
+
+typedef void (*ktask_entry_t)(void *arg);
+
+/**
+ * @brief Counting semaphore
+ */
+typedef struct {
+  volatile uint8_t count;
+} ksem_t;
+
+/** @brief Static initializer: ksem_t s = KSEM_INIT(0); */
+#define KSEM_INIT(n) { (n) }
+
+/**
+ * @brief Fixed-size item queue (treat fields as private)
+ */
+typedef struct {
+  uint8_t *buffer;
+  uint8_t item_size;
+  uint8_t capacity;
+  uint8_t head;
+  uint8_t tail;
+  ksem_t items;
+  ksem_t spaces;
+} kqueue_t;
+
+/**
+ * @brief Task snapshot for the TASKS command
+ */
+typedef struct {
+  const char *name;
+  uint8_t priority;
+  uint8_t state;
+  uint16_t stack_size; ///< 0 for the idle task (uses the main stack)
+  uint16_t stack_used; ///< High-water mark in bytes
+  uint32_t runs;       ///< Times the task was switched in
+} ktask_info_t;
+
+/**
+ * @brief Create a task (before or after kernel_start())
+ * @param name Short name for TASKS
+ * @param entry Task function; returning from it ends the task
+ * @param arg Passed to entry
+ * @param priority 1 (lowest) .. 255
+ * @param stack Stack storage, at least KERNEL_MIN_STACK bytes
+ * @param stack_size Size of stack
+ * @return Task index, or -1 if the table is full
+ */
+int8_t ktask_create(const char *name, ktask_entry_t entry, void *arg,
+                    uint8_t priority, uint8_t *stack, uint16_t stack_size);
+
+/**
+ * @brief Start the tick and turn the caller into the idle task
+ * @param f_clk_per Peripheral clock in Hz
+ * @param idle_hook Called repeatedly when no task is ready (may be NULL)
+ */
+void kernel_start(uint32_t f_clk_per, void (*idle_hook)(void))
+    __attribute__((noreturn));
+
+/**
+ * @brief Ticks since kernel_start() (wraps)
+ */
+uint16_t kernel_ticks(void);
+
+/**
+ * @brief Let another ready task of the same priority run
+ */
+void ktask_yield(void);
+
+/**
+ * @brief Block the calling task for a number of ticks
+ */
+void ktask_delay(uint16_t ticks);
+
+/**
+ * @brief Copy a task's details
+ * @return false if index is not a task
+ */
+bool ktask_info(uint8_t index, ktask_info_t *info);
+
+/**
+ * @brief Bytes of RAM the kernel spends per task besides its stack
+ */
+uint16_t ktask_overhead(void);
+
+/**
+ * @brief Take a semaphore, blocking up to timeout ticks (tasks only)
+ * @return false on timeout
+ */
+bool ksem_wait(ksem_t *sem, uint16_t timeout);
+
+/**
+ * @brief Release a semaphore (tasks and ISRs)
+ */
+void ksem_post(ksem_t *sem);
+
+/**
+ * @brief Set up a queue over caller storage (item_size x capacity bytes)
+ */
+void kqueue_init(kqueue_t *queue, void *storage, uint8_t item_size,
+                 uint8_t capacity);
+
+/**
+ * @brief Append an item, blocking up to timeout ticks while full
+ * @return false on timeout (ISRs must pass KERNEL_NO_WAIT)
+ */
+bool kqueue_send(kqueue_t *queue, const void *item, uint16_t timeout);
+
+/**
+ * @brief Remove the oldest item, blocking up to timeout ticks while empty
+ * @return false on timeout (ISRs must pass KERNEL_NO_WAIT)
+ */
+bool kqueue_receive(kqueue_t *queue, void *item, uint16_t timeout);
+
+#endif /* KERNEL_H_ */
@@ -0,0 +1,76 @@
+#ifndef LOADMON_H_
+#define LOADMON_H_
+
+/**
+ * @file loadmon.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief CPU load and main-loop jitter meter
+ *
+ * The main loop calls loadmon_loop() once per pass and says whether the
+ * pass did any work. Passes are timed with the PERF cycle counter:
+ * - the fastest idle pass seen is the calibrated idle baseline,
+ * - idle time is (idle passes x baseline), everything else is load,
+ * - the excess of idle passes over the baseline is time stolen by ISRs.
+ *
+ * Time spent asleep (see idle.h) is reported through loadmon_sleep() and
+ * counts as idle. Standby sleep stops the cycle counter, so that time is
+ * added to the window as well; windows stay one second of wall time.
+ *
+ * Load and ISR share are published once per one-second window; the
+ * pass-time histogram and worst case accumulate until loadmon_reset().
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Histogram buckets: <16us, <64us, ... x4 each, last is open */
+#define LOADMON_BUCKETS 8
+
+/**
+ * @brief Published load figures
+ */
+typedef struct {
+  uint16_t cpu_permille;            ///< Busy share of the last window
+  uint16_t isr_permille;            ///< ISR share of idle time, last window
+  uint16_t sleep_permille;          ///< Time asleep, last window
+  uint32_t worst_us;                ///< Longest main-loop pass
+  uint16_t baseline_cycles;         ///< Calibrated empty-pass cost
+  uint16_t hist[LOADMON_BUCKETS];   ///< Pass-time histogram (saturating)
+} loadmon_stats_t;
+
+/**
+ * @brief Start measuring (perf_init() must have run)
+ * @param f_cpu_hz CPU clock in Hz
+ */
+void loadmon_init(uint32_t f_cpu_hz);
+
+/**
+ * @brief Account for one main-loop pass
+ * @param busy true if the pass handled input, a command or other work
+ */
+void loadmon_loop(bool busy);
+
+/**
+ * @brief Account for time asleep in the current pass
+ * @param cycles Sleep duration in CPU cycles
+ * @param clock_stopped true if the cycle counter did not run meanwhile
+ */
+void loadmon_sleep(uint32_t cycles, bool clock_stopped);
+
+/**
+ * @brief Copy the current figures
+ */
+void loadmon_get(loadmon_stats_t *stats);
+
+/**
+ * @brief Upper bound of a histogram bucket in microseconds (0 = open)
+ */
+uint32_t loadmon_bucket_limit_us(uint8_t bucket);
+
+/**
+ * @brief Clear histogram and worst case
+ */
+void loadmon_reset(void);
+
+#endif /* LOADMON_H_ */
@@ -0,0 +1,66 @@
+/**
+ * @file memmon.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Stack painting and RAM usage accounting
+ */
+
+#include "memmon.h"
+#include <avr/io.h>
+
+// Linker-provided section boundaries (avr-libc default scripts)
+extern uint8_t __data_start, __data_end;
+extern uint8_t __bss_start, __bss_end;
+extern uint8_t __noinit_start, __noinit_end;
+extern uint8_t __heap_start;
+extern char *__brkval;
+extern uint8_t _end;
+
+//================================
+// Stack Painting
+//================================
+
+// Runs from .init3: SP and r1 are set up and nothing is on the stack yet.
+// In assembly, as in avr-libc's StackPaint example: a C loop may become a
+// memset() call, whose return address is on the stack being painted, and a
+// naked function has no frame to protect it.
+void memmon_paint(void) __attribute__((naked, used, section(".init3")));
+void memmon_paint(void) {
+  __asm__ volatile("    ldi r30, lo8(_end)\n"
+                   "    ldi r31, hi8(_end)\n"
+                   "    ldi r24, %[canary]\n"
+                   "    ldi r25, hi8(%[top])\n"
+                   "    rjmp 2f\n"
+                   "1:  st Z+, r24\n"
+                   "2:  cpi r30, lo8(%[top])\n"
+                   "    cpc r31, r25\n"
+                   "    brlo 1b\n"
+                   "    breq 1b\n" // Up to and including RAMEND
+                   :
+                   : [canary] "M"(MEMMON_CANARY), [top] "n"(RAMEND)
+                   : "r24", "r25", "r30", "r31", "memory");
+}
+
+//================================
+// Public Interface
+//================================
+
+void memmon_get(memmon_info_t *info) {
+  uint8_t *heap_end = __brkval ? (uint8_t *)__brkval : &__heap_start;
+  uint8_t *sp = (uint8_t *)SP;
+
+  // First byte above the heap that no longer holds the canary
+  uint8_t *p = heap_end;
+  while (p < sp && *p == MEMMON_CANARY) {
+    p++;
+  }
+
+  info->ram_size = RAMEND - (uint16_t)&__data_start + 1;
+  info->data = &__data_end - &__data_start;
+  info->bss = &__bss_end - &__bss_start;
+  info->noinit = &__noinit_end - &__noinit_start;
+  info->heap = heap_end - &__heap_start;
+  info->stack_now = RAMEND - (uint16_t)sp;
+  info->stack_peak = RAMEND - (uint16_t)p + 1;
+  info->unused = p - heap_end;
+}
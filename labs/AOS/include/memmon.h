@@ -0,0 +1,45 @@
+#ifndef MEMMON_H_
+#define MEMMON_H_
+
+/**
+ * @file memmon.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Stack and RAM high-water monitor (MEM command backend)
+ *
+ * At reset, before .data/.bss are initialized, everything between the
+ * end of static data and the top of RAM is painted with MEMMON_CANARY.
+ * The heap grows up from the bottom of that gap and the stack grows down
+ * from RAMEND, so the first overwritten byte above the heap break marks
+ * the deepest the stack has ever been.
+ *
+ * That is the main stack only. In KERNEL builds each task's stack is an
+ * array in .bss, painted by ktask_create() and measured by ktask_info();
+ * MEM lists those separately.
+ */
+
+#include <stdint.h>
+
+/** @brief Fill byte used for stack painting */
+#define MEMMON_CANARY 0xC5
+
+/**
+ * @brief RAM usage snapshot, all sizes in bytes
+ */
+typedef struct {
+  uint16_t ram_size;   ///< Total internal SRAM
+  uint16_t data;       ///< Initialized statics (.data)
+  uint16_t bss;        ///< Zeroed statics (.bss)
+  uint16_t noinit;     ///< Uninitialized statics (.noinit)
+  uint16_t heap;       ///< malloc() break above __heap_start
+  uint16_t stack_now;  ///< Current stack depth
+  uint16_t stack_peak; ///< Deepest stack since reset
+  uint16_t unused;     ///< Never-touched gap between heap and stack
+} memmon_info_t;
+
+/**
+ * @brief Collect a snapshot (scans the painted gap, a few hundred us)
+ */
+void memmon_get(memmon_info_t *info);
+
+#endif /* MEMMON_H_ */
@@ -0,0 +1,88 @@
+/**
+ * @file perf.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Cycle-accurate execution profiling on TCB0
+ */
+
+#include "perf.h"
+#include <string.h>
+
+//================================
+// Internal State
+//================================
+volatile uint32_t perf_overflows = 0;
+volatile uint32_t perf_isr_cycles = 0;
+
+static perf_stat_t stats[PERF_MAX_SITES];
+static uint16_t overhead = 0; // Cost of an empty PERF_BEGIN/PERF_END pair
+
+//================================
+// Public Interface
+//================================
+
+void perf_init(void) {
+  TCB0.CTRLA = 0;
+  TCB0.CNT = 0;
+  TCB0.CCMP = 0xFFFF; // Full 16-bit period
+  TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  TCB0.CTRLA = TCB_CLKSEL_DIV1_gc | TCB_ENABLE_bm;
+
+  PERF_BEGIN(start);
+  overhead = (uint16_t)(perf_now() - start);
+
+  perf_reset();
+}
+
+void perf_record(uint8_t site, uint32_t cycles) {
+  if (site >= PERF_MAX_SITES) {
+    return;
+  }
+  cycles = (cycles > overhead) ? cycles - overhead : 0;
+
+  uint8_t sreg = SREG;
+  cli();
+  perf_stat_t *s = &stats[site];
+  if (s->count == 0 || cycles < s->min) {
+    s->min = cycles;
+  }
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+  // Halve both on overflow: the average stays valid, old samples fade out
+  if (s->total + cycles < s->total) {
+    s->total >>= 1;
+    s->count >>= 1;
+  }
+  s->total += cycles;
+  s->count++;
+  SREG = sreg;
+}
+
+bool perf_get(uint8_t site, perf_stat_t *stat) {
+  if (site >= PERF_MAX_SITES) {
+    return false;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  *stat = stats[site];
+  SREG = sreg;
+  return stat->count != 0;
+}
+
+void perf_reset(void) {
+  uint8_t sreg = SREG;
+  cli();
+  memset(stats, 0, sizeof(stats));
+  SREG = sreg;
+}
+
+//================================
+// Cycle Counter Overflow
+//================================
+ISR(TCB0_INT_vect) {
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  perf_overflows++;
+}
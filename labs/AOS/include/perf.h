@@ -0,0 +1,139 @@
+#ifndef PERF_H_
+#define PERF_H_
+
+/**
+ * @file perf.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Cycle-accurate execution profiling (PERF command backend)
+ *
+ * TCB0 free-runs at the CPU clock (16-bit, period 65536) and its overflow
+ * interrupt extends it to a 32-bit cycle counter, so sites that block on
+ * the UART for tens of milliseconds still measure correctly. Each site
+ * keeps min/avg/max cycle counts.
+ *
+ * Command handlers and ui_process_commands() are always profiled. ISR
+ * entry/exit is profiled only when built with -DAOS_PERF_ISR
+ * (make PERF_ISR=1), since it adds a few dozen cycles to every interrupt.
+ * A level-1 handler (see irq.h) can run inside a level-0 one; its time is
+ * taken out of the level-0 handler's sample, so each ISR site counts only
+ * its own cycles.
+ */
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//================================
+// Profiling Sites
+//================================
+#define PERF_SITE_PROCESS 0    ///< ui_process_commands()
+#define PERF_SITE_TCA0_OVF 1   ///< ISR(TCA0_OVF_vect)
+#define PERF_SITE_RTC_CNT 2    ///< ISR(RTC_CNT_vect)
+#define PERF_SITE_USART3_RXC 3 ///< ISR(USART3_RXC_vect)
+#define PERF_SITE_USART3_DRE 4 ///< ISR(USART3_DRE_vect)
+#define PERF_SITE_SWITCH 5     ///< Kernel context switch (make KERNEL=1)
+#define PERF_SITE_COMMAND 6    ///< First command site (+ command index)
+
+/** @brief Total number of sites (system + commands) */
+#define PERF_MAX_SITES 40
+
+/**
+ * @brief Statistics for one site, all values in CPU cycles
+ */
+typedef struct {
+  uint32_t count; ///< Samples in total (halved together with total)
+  uint32_t total; ///< Sum of samples, for the average
+  uint32_t min;
+  uint32_t max;
+} perf_stat_t;
+
+/** @brief TCB0 overflows: bits 16..47 of the cycle count (see clock.h) */
+extern volatile uint32_t perf_overflows;
+
+/**
+ * @brief Read the 32-bit cycle counter
+ *
+ * Safe from ISRs and main code. A pending TCB0 overflow that has not been
+ * serviced yet is accounted for.
+ */
+static inline uint32_t perf_now(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t lo = TCB0.CNT;
+  uint16_t hi = (uint16_t)perf_overflows;
+  if ((TCB0.INTFLAGS & TCB_CAPT_bm) && lo < 0x8000) {
+    hi++;
+  }
+  SREG = sreg;
+  return ((uint32_t)hi << 16) | lo;
+}
+
+/**
+ * @brief Start TCB0 as the free-running cycle counter
+ */
+void perf_init(void);
+
+/**
+ * @brief Add one measurement to a site
+ * @param site Site index (< PERF_MAX_SITES)
+ * @param cycles Elapsed cycles including measurement overhead
+ */
+void perf_record(uint8_t site, uint32_t cycles);
+
+/**
+ * @brief Take a consistent copy of a site's statistics
+ * @return false if the site has no samples yet
+ */
+bool perf_get(uint8_t site, perf_stat_t *stat);
+
+/**
+ * @brief Clear all statistics
+ */
+void perf_reset(void);
+
+//================================
+// Instrumentation Macros
+//================================
+#define PERF_BEGIN(var) uint32_t var = perf_now()
+#define PERF_END(site, var) perf_record((site), perf_now() - (var))
+
+/** @brief Cycles spent in profiled ISRs, to discount nested ones */
+extern volatile uint32_t perf_isr_cycles;
+
+/** @brief Read perf_isr_cycles (level 1 may update it meanwhile) */
+static inline uint32_t perf_isr_total(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t total = perf_isr_cycles;
+  SREG = sreg;
+  return total;
+}
+
+/**
+ * @brief Record an ISR sample without the handlers nested in it
+ * @param nested perf_isr_total() at entry
+ */
+static inline void perf_isr_end(uint8_t site, uint32_t start,
+                                uint32_t nested) {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t elapsed = perf_now() - start;
+  uint32_t own = elapsed - (perf_isr_cycles - nested);
+  perf_isr_cycles += elapsed; // Whole time: an outer handler subtracts it
+  SREG = sreg;
+  perf_record(site, own);
+}
+
+#ifdef AOS_PERF_ISR
+#define PERF_ISR_BEGIN()                                                       \
+  uint32_t perf_isr_nested = perf_isr_total();                                 \
+  PERF_BEGIN(perf_isr_start)
+#define PERF_ISR_END(site) perf_isr_end((site), perf_isr_start, perf_isr_nested)
+#else
+#define PERF_ISR_BEGIN()
+#define PERF_ISR_END(site)
+#endif
+
+#endif /* PERF_H_ */
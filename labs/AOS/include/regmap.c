@@ -0,0 +1,136 @@
+/**
+ * @file regmap.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Binary-search lookup over the generated PROGMEM register map
+ */
+
+#include "regmap.h"
+#include <avr/pgmspace.h>
+#include <string.h>
+
+typedef struct {
+  uint16_t name;  // Offset into regmap_strings
+  uint16_t first; // Index of first register in regmap_regs
+  uint8_t count;  // Number of registers
+} regmap_periph_t;
+
+typedef struct {
+  uint16_t name;    // Offset into regmap_strings
+  uint16_t address; // Data-space address
+  uint8_t width;    // Width in bytes
+} regmap_reg_t;
+
+// Generated by tools/gen_regmap.py from ioavr128db48.h (see Makefile)
+#include "regmap_data.h"
+
+//================================
+// Internal Helpers
+//================================
+
+// Upper-case a symbolic name and turn '.' separators into '_'
+static uint8_t normalize(const char *src, char *dst) {
+  uint8_t n = 0;
+  while (*src && n < 2 * REGMAP_NAME_MAX) {
+    char c = *src++;
+    if (c == '.') {
+      c = '_';
+    } else if (c >= 'a' && c <= 'z') {
+      c = c - 'a' + 'A';
+    }
+    dst[n++] = c;
+  }
+  dst[n] = '\0';
+  return n;
+}
+
+static uint16_t periph_name(uint8_t index) {
+  return pgm_read_word(&regmap_periphs[index].name);
+}
+
+static uint16_t reg_name(uint16_t index) {
+  return pgm_read_word(&regmap_regs[index].name);
+}
+
+static uint8_t find_peripheral(const char *name) {
+  uint8_t lo = 0;
+  uint8_t hi = REGMAP_PERIPH_COUNT;
+  while (lo < hi) {
+    uint8_t mid = lo + (hi - lo) / 2;
+    int cmp = strcmp_P(name, &regmap_strings[periph_name(mid)]);
+    if (cmp == 0) {
+      return mid;
+    }
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return REGMAP_NOT_FOUND;
+}
+
+//================================
+// Public Interface
+//================================
+
+bool regmap_lookup(const char *symbol, uint16_t *address, uint8_t *width) {
+  char name[2 * REGMAP_NAME_MAX + 1];
+  normalize(symbol, name);
+
+  // Peripheral names never contain '_', so the first one splits the name
+  char *reg = strchr(name, '_');
+  if (reg == NULL) {
+    return false;
+  }
+  *reg++ = '\0';
+
+  uint8_t p = find_peripheral(name);
+  if (p == REGMAP_NOT_FOUND) {
+    return false;
+  }
+
+  uint16_t lo = pgm_read_word(&regmap_periphs[p].first);
+  uint16_t hi = lo + pgm_read_byte(&regmap_periphs[p].count);
+  while (lo < hi) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    int cmp = strcmp_P(reg, &regmap_strings[reg_name(mid)]);
+    if (cmp == 0) {
+      *address = pgm_read_word(&regmap_regs[mid].address);
+      *width = pgm_read_byte(&regmap_regs[mid].width);
+      return true;
+    }
+    if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return false;
+}
+
+uint8_t regmap_peripheral_count(void) { return REGMAP_PERIPH_COUNT; }
+
+uint8_t regmap_find_peripheral(const char *name) {
+  char buf[REGMAP_NAME_MAX + 1];
+  if (strlen(name) > REGMAP_NAME_MAX) {
+    return REGMAP_NOT_FOUND;
+  }
+  normalize(name, buf);
+  return find_peripheral(buf);
+}
+
+uint8_t regmap_peripheral_name(uint8_t index, char *buf) {
+  strncpy_P(buf, &regmap_strings[periph_name(index)], REGMAP_NAME_MAX);
+  buf[REGMAP_NAME_MAX] = '\0';
+  return pgm_read_byte(&regmap_periphs[index].count);
+}
+
+void regmap_register(uint8_t index, uint8_t reg, char *buf, uint16_t *address,
+                     uint8_t *width) {
+  uint16_t r = pgm_read_word(&regmap_periphs[index].first) + reg;
+  strncpy_P(buf, &regmap_strings[reg_name(r)], REGMAP_NAME_MAX);
+  buf[REGMAP_NAME_MAX] = '\0';
+  *address = pgm_read_word(&regmap_regs[r].address);
+  *width = pgm_read_byte(&regmap_regs[r].width);
+}
@@ -0,0 +1,72 @@
+#ifndef REGMAP_H_
+#define REGMAP_H_
+
+/**
+ * @file regmap.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Flash-resident register map for every AVR128DB48 peripheral
+ *
+ * The map is generated at build time from the device header by
+ * tools/gen_regmap.py and lives entirely in PROGMEM. Peripherals are sorted
+ * by name and registers are sorted by name inside each peripheral, so every
+ * lookup is a binary search and costs no SRAM.
+ *
+ * Symbolic names use the device header spelling with '.' or '_' as the
+ * separator, case-insensitive: "TCA0.SINGLE.PER", "rtc.cnt", "PORTD_OUT".
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Longest peripheral or register name accepted (without NUL) */
+#define REGMAP_NAME_MAX 23
+
+/** @brief Sentinel returned when a peripheral is not found */
+#define REGMAP_NOT_FOUND 0xFF
+
+/**
+ * @brief Resolve a symbolic register name to its data-space address
+ *
+ * @param symbol Name such as "TCA0.SINGLE.PER" (case-insensitive)
+ * @param address Filled with the register address on success
+ * @param width Filled with the register width in bytes (1, 2 or 4)
+ * @return true if the register exists, false otherwise
+ */
+bool regmap_lookup(const char *symbol, uint16_t *address, uint8_t *width);
+
+/**
+ * @brief Number of peripheral instances in the map
+ */
+uint8_t regmap_peripheral_count(void);
+
+/**
+ * @brief Find a peripheral instance by name (case-insensitive)
+ *
+ * @param name Peripheral name such as "TCA0"
+ * @return Peripheral index, or REGMAP_NOT_FOUND
+ */
+uint8_t regmap_find_peripheral(const char *name);
+
+/**
+ * @brief Copy a peripheral name out of flash
+ *
+ * @param index Peripheral index (0 to regmap_peripheral_count() - 1)
+ * @param buf Destination buffer, at least REGMAP_NAME_MAX + 1 bytes
+ * @return Number of registers belonging to the peripheral
+ */
+uint8_t regmap_peripheral_name(uint8_t index, char *buf);
+
+/**
+ * @brief Copy one register entry of a peripheral out of flash
+ *
+ * @param index Peripheral index
+ * @param reg Register index inside the peripheral
+ * @param buf Destination for the register name, REGMAP_NAME_MAX + 1 bytes
+ * @param address Filled with the register address
+ * @param width Filled with the register width in bytes
+ */
+void regmap_register(uint8_t index, uint8_t reg, char *buf, uint16_t *address,
+                     uint8_t *width);
+
+#endif /* REGMAP_H_ */
@@ -0,0 +1,188 @@
+/**
+ * @file rtccal.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief RTC calibration against the 16 MHz crystal
+ */
+
+#include "rtccal.h"
+#include "perf.h"
+#include "timekeep.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+// OSC32K nominal rate
+#define RTC_NOMINAL_HZ 32768UL
+
+typedef enum {
+  CAL_IDLE,
+  CAL_ARMED, // Gate opens at the next overflow
+  CAL_GATE,  // Counting RTC seconds on TCB0
+  CAL_DONE,  // Waiting for rtccal_process()
+  CAL_HOLD   // Repeat interval
+} cal_phase_t;
+
+//================================
+// Internal State
+//================================
+static uint32_t f_cpu = 16000000UL;
+static uint16_t cycles_per_count = 488; // CPU cycles per RTC count
+static volatile uint8_t phase = CAL_IDLE;
+static uint8_t gate_s = RTCCAL_GATE_S;
+static uint16_t repeat_s = 0;
+static uint8_t gates_left = 0; // Gates left in the run
+static uint16_t countdown = 0; // Gate or hold seconds left
+static uint32_t gate_start = 0;
+static uint32_t gate_cycles = 0;
+static volatile bool apply = false; // new_period/new_calib at next overflow
+static uint32_t new_period = RTC_NOMINAL_HZ;
+static uint8_t new_calib = 0;
+static rtccal_stats_t stats = {0, 0, 0, (uint16_t)RTC_NOMINAL_HZ, 0, 0, 0};
+
+//================================
+// Public Interface
+//================================
+
+void rtccal_init(uint32_t f_cpu_hz) {
+  f_cpu = f_cpu_hz;
+  cycles_per_count = (uint16_t)(f_cpu_hz / RTC_NOMINAL_HZ);
+  stats.period = (uint16_t)timekeep_period();
+}
+
+void rtccal_start(uint8_t gate, uint16_t repeat) {
+  uint8_t sreg = SREG;
+  cli();
+  gate_s = gate ? gate : 1;
+  repeat_s = repeat;
+  stats.gate_s = gate_s;
+  stats.repeat_s = repeat;
+  gates_left = 2;
+  phase = CAL_ARMED;
+  SREG = sreg;
+}
+
+void rtccal_stop(void) {
+  uint8_t sreg = SREG;
+  cli();
+  phase = CAL_IDLE;
+  gates_left = 0;
+  SREG = sreg;
+}
+
+bool rtccal_measuring(void) {
+  uint8_t p = phase;
+  return p == CAL_ARMED || p == CAL_GATE;
+}
+
+bool rtccal_active(void) { return phase != CAL_IDLE; }
+
+void rtccal_rtc_overflow(void) {
+  if (phase == CAL_IDLE && !apply) {
+    return;
+  }
+  // Entered late by RTC.CNT counts: take those back off the timestamp
+  uint32_t now = perf_now() - (uint32_t)RTC.CNT * cycles_per_count;
+
+  if (apply) {
+    timekeep_set_period(new_period);
+    RTC.CALIB = new_calib; // SIGN clear: the prescaler counts slower
+    while (RTC.STATUS & RTC_CTRLABUSY_bm) {
+      ; // Wait for synchronization
+    }
+    if (new_calib) {
+      RTC.CTRLA |= RTC_CORREN_bm;
+    } else {
+      RTC.CTRLA &= ~RTC_CORREN_bm;
+    }
+    stats.period = (uint16_t)new_period;
+    stats.calib = new_calib;
+    apply = false;
+  }
+
+  switch (phase) {
+  case CAL_ARMED:
+    gate_start = now;
+    countdown = gate_s;
+    phase = CAL_GATE;
+    break;
+  case CAL_GATE:
+    if (--countdown == 0) {
+      gate_cycles = now - gate_start;
+      phase = CAL_DONE;
+    }
+    break;
+  case CAL_HOLD:
+    if (--countdown == 0) {
+      gates_left = 1;
+      phase = CAL_ARMED;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+bool rtccal_process(void) {
+  if (phase != CAL_DONE) {
+    return false;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t cycles = gate_cycles;
+  uint8_t n = gate_s;
+  SREG = sreg;
+  uint32_t period = timekeep_period();
+
+  // Second error of the settings in use (+: the RTC second is short)
+  int64_t nominal = (int64_t)n * f_cpu;
+  stats.residual_dppm =
+      (int32_t)((nominal - (int64_t)cycles) * 10000000 / (int64_t)cycles);
+
+  // Oscillator rate in mHz: period counts per second, slowed by CALIB
+  uint64_t eff_mhz = (uint64_t)period * n * f_cpu * 1000 / cycles;
+  uint64_t osc_mhz = eff_mhz * 1000000 / (1000000 - stats.calib);
+  stats.osc_dppm = (int32_t)(((int64_t)osc_mhz -
+                              (int64_t)RTC_NOMINAL_HZ * 1000) *
+                             10000 / (int64_t)RTC_NOMINAL_HZ);
+
+  // Whole counts per second into PER, the fraction left into CALIB
+  uint32_t p = (uint32_t)(osc_mhz / 1000);
+  if (p < 2) {
+    p = 2;
+  } else if (p > 65535) {
+    p = 65535;
+  }
+  uint32_t c = 0;
+  if (osc_mhz > (uint64_t)p * 1000) {
+    c = (uint32_t)((osc_mhz - (uint64_t)p * 1000) * 1000000 / osc_mhz);
+  }
+  if (c > RTCCAL_CALIB_MAX) {
+    c = RTCCAL_CALIB_MAX;
+  }
+
+  cli();
+  new_period = p;
+  new_calib = (uint8_t)c;
+  apply = true;
+  stats.gates++;
+  if (phase == CAL_DONE) { // Not stopped meanwhile
+    if (--gates_left > 0) {
+      phase = CAL_ARMED;
+    } else if (repeat_s) {
+      countdown = repeat_s;
+      phase = CAL_HOLD;
+    } else {
+      phase = CAL_IDLE;
+    }
+  }
+  SREG = sreg;
+  return true;
+}
+
+bool rtccal_get(rtccal_stats_t *out) {
+  uint8_t sreg = SREG;
+  cli();
+  *out = stats;
+  SREG = sreg;
+  return out->gates != 0;
+}
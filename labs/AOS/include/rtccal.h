@@ -0,0 +1,99 @@
+#ifndef RTCCAL_H_
+#define RTCCAL_H_
+
+/**
+ * @file rtccal.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief RTC calibration against the 16 MHz crystal
+ *
+ * OSC32K is the internal ULP oscillator and can be off by a few percent;
+ * the CPU runs from the crystal. A gate of N RTC seconds is timed on the
+ * TCB0 cycle counter: the overflow ISR takes a timestamp, less the RTC
+ * counts it was entered late, at the first and the last overflow. The
+ * cycles counted against N times F_CPU give the error of the RTC second.
+ *
+ * The correction has two parts, both applied at an overflow so that the
+ * running second is never cut short:
+ * - RTC.PER takes the whole oscillator counts per second, rounded down
+ *   (steps of about 30 ppm, any size),
+ * - RTC.CALIB removes the remaining fraction (1 ppm steps, at most 127),
+ *   so the prescaler is only ever slowed down.
+ *
+ * One run is two gates: the first measures and corrects, the second
+ * measures what is left (the residual shown in SYSINFO) and corrects
+ * again. With a repeat interval, gates keep running at that interval to
+ * follow temperature drift. STANDBY stops TCB0, so the main loop must not
+ * use it while a gate is open (rtccal_measuring()).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Default gate length in seconds */
+#define RTCCAL_GATE_S 16
+
+/** @brief Largest correction RTC.CALIB can hold (ppm) */
+#define RTCCAL_CALIB_MAX 127
+
+/**
+ * @brief Calibration results
+ */
+typedef struct {
+  uint32_t gates;        ///< Gates completed
+  int32_t osc_dppm;      ///< Oscillator error vs 32768 Hz (0.1 ppm, + fast)
+  int32_t residual_dppm; ///< Second error, last gate (0.1 ppm, + short)
+  uint16_t period;       ///< RTC.PER + 1 in use
+  uint8_t calib;         ///< RTC.CALIB slowdown in use (ppm)
+  uint8_t gate_s;        ///< Gate length (s)
+  uint16_t repeat_s;     ///< Repeat interval (s), 0 if one run
+} rtccal_stats_t;
+
+/**
+ * @brief Set the crystal frequency
+ * @param f_cpu_hz CPU clock in Hz (crystal)
+ */
+void rtccal_init(uint32_t f_cpu_hz);
+
+/**
+ * @brief Start a calibration run at the next RTC overflow
+ * @param gate_s Gate length in seconds (1..255)
+ * @param repeat_s Seconds between gates after the run, 0 to stop after it
+ */
+void rtccal_start(uint8_t gate_s, uint16_t repeat_s);
+
+/**
+ * @brief Stop measuring (corrections in use stay)
+ */
+void rtccal_stop(void);
+
+/**
+ * @brief Check if a gate is open (STANDBY would spoil it)
+ */
+bool rtccal_measuring(void);
+
+/**
+ * @brief Check if a run or repeat is in progress
+ */
+bool rtccal_active(void);
+
+/**
+ * @brief Take the gate timestamps and apply corrections
+ *
+ * Call from ISR(RTC_CNT_vect) on the overflow, before anything else.
+ */
+void rtccal_rtc_overflow(void);
+
+/**
+ * @brief Evaluate a finished gate (main loop, once a second)
+ * @return true if a gate was evaluated
+ */
+bool rtccal_process(void);
+
+/**
+ * @brief Copy the results
+ * @return false if no gate has completed
+ */
+bool rtccal_get(rtccal_stats_t *stats);
+
+#endif /* RTCCAL_H_ */
@@ -0,0 +1,182 @@
+/**
+ * @file swtimer.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Software timer wheel driven by the TCA0 10 ms tick
+ */
+
+#include "swtimer.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+#define WHEEL_MASK (SWTIMER_WHEEL_SIZE - 1)
+
+//================================
+// Internal State
+//================================
+static swtimer_t *wheel[SWTIMER_WHEEL_SIZE];
+static volatile uint16_t ticks = 0;
+static swtimer_t *deferred_head = NULL;
+static swtimer_t *deferred_tail = NULL;
+
+//================================
+// Internal Helpers (interrupts disabled)
+//================================
+
+static void link(swtimer_t *t) {
+  swtimer_t **slot = &wheel[t->expires & WHEEL_MASK];
+  t->prev = NULL;
+  t->next = *slot;
+  if (*slot) {
+    (*slot)->prev = t;
+  }
+  *slot = t;
+  t->flags |= SWTIMER_ACTIVE;
+}
+
+static void unlink(swtimer_t *t) {
+  if (t->prev) {
+    t->prev->next = t->next;
+  } else {
+    wheel[t->expires & WHEEL_MASK] = t->next;
+  }
+  if (t->next) {
+    t->next->prev = t->prev;
+  }
+  t->next = NULL;
+  t->prev = NULL;
+  t->flags &= ~SWTIMER_ACTIVE;
+}
+
+static void defer(swtimer_t *t) {
+  t->flags |= SWTIMER_PENDING;
+  if (t->flags & SWTIMER_QUEUED) {
+    return; // Coalesce with the call already waiting
+  }
+  t->flags |= SWTIMER_QUEUED;
+  t->deferred_next = NULL;
+  if (deferred_tail) {
+    deferred_tail->deferred_next = t;
+  } else {
+    deferred_head = t;
+  }
+  deferred_tail = t;
+}
+
+//================================
+// Public Interface
+//================================
+
+void swtimer_start(swtimer_t *timer, uint16_t delay, uint16_t period) {
+  uint8_t sreg = SREG;
+  cli();
+  if (timer->flags & SWTIMER_ACTIVE) {
+    unlink(timer);
+  }
+  timer->expires = ticks + (delay ? delay : 1);
+  timer->period = period;
+  link(timer);
+  SREG = sreg;
+}
+
+void swtimer_stop(swtimer_t *timer) {
+  uint8_t sreg = SREG;
+  cli();
+  if (timer->flags & SWTIMER_ACTIVE) {
+    unlink(timer);
+  }
+  // Still queued is fine: swtimer_process() skips it without PENDING
+  timer->flags &= ~SWTIMER_PENDING;
+  SREG = sreg;
+}
+
+void swtimer_defer(swtimer_t *timer) {
+  uint8_t sreg = SREG;
+  cli();
+  defer(timer);
+  SREG = sreg;
+}
+
+bool swtimer_active(const swtimer_t *timer) {
+  return (timer->flags & SWTIMER_ACTIVE) != 0;
+}
+
+// Rescans the slot after every callback, so callbacks may start or stop
+// any timer; a re-armed timer never expires on the current tick again
+void swtimer_tick(void) {
+  uint16_t now = ++ticks;
+  swtimer_t *t = wheel[now & WHEEL_MASK];
+
+  while (t) {
+    if (t->expires != now) {
+      t = t->next;
+      continue;
+    }
+
+    unlink(t);
+    if (t->period) {
+      t->expires = now + t->period;
+      link(t);
+    }
+    if (t->flags & SWTIMER_DEFERRED) {
+      defer(t);
+    } else {
+      t->callback(t->ctx);
+    }
+    t = wheel[now & WHEEL_MASK];
+  }
+}
+
+uint8_t swtimer_process(void) {
+  uint8_t ran = 0;
+  while (1) {
+    cli();
+    swtimer_t *t = deferred_head;
+    if (t == NULL) {
+      sei();
+      break;
+    }
+    deferred_head = t->deferred_next;
+    if (deferred_head == NULL) {
+      deferred_tail = NULL;
+    }
+    bool run = (t->flags & SWTIMER_PENDING) != 0;
+    t->flags &= ~(SWTIMER_QUEUED | SWTIMER_PENDING);
+    sei();
+
+    if (run) {
+      t->callback(t->ctx);
+      ran++;
+    }
+  }
+  return ran;
+}
+
+// Walks the whole wheel; only the idle path calls this, when nothing
+// else is waiting to run
+uint16_t swtimer_next_due(void) {
+  uint16_t due = SWTIMER_NEVER;
+  uint8_t sreg = SREG;
+  cli();
+  for (uint8_t slot = 0; slot < SWTIMER_WHEEL_SIZE; slot++) {
+    for (swtimer_t *t = wheel[slot]; t; t = t->next) {
+      uint16_t left = t->expires - ticks;
+      if (left != 0 && left < due) {
+        due = left;
+      }
+    }
+  }
+  SREG = sreg;
+  return due;
+}
+
+bool swtimer_deferred_pending(void) { return deferred_head != NULL; }
+
+uint16_t swtimer_now(void) {
+  uint16_t now;
+  uint8_t sreg = SREG;
+  cli();
+  now = ticks;
+  SREG = sreg;
+  return now;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file timekeep.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Wall-clock time as 32-bit epoch seconds plus the RTC fraction
+ */
+
+#include "timekeep.h"
+#include "ui.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+//================================
+// Internal State
+//================================
+static volatile uint32_t offset = 0; // Wall seconds - rtc_interrupt_count
+static volatile uint32_t offset_frac = 0;    // and the fraction (2^-32 s)
+static volatile int32_t adj = 0;             // Added over the running second
+static volatile uint32_t rtc_period = 32768; // RTC.PER + 1
+static int32_t freq = 0;      // Frequency part of adj (2^-32 s per second)
+static int32_t freq_ppb = 0;  // The same in ppb, as set
+static int32_t slew_left = 0; // Correction not yet added (2^-32 s)
+
+static const uint8_t month_days[12] = {31, 28, 31, 30, 31, 30,
+                                       31, 31, 30, 31, 30, 31};
+
+//================================
+// Internal Helpers
+//================================
+
+// 2^-32 s per microsecond, rounded
+#define FRAC_PER_US 4295L
+
+// Add signed 2^-32 s units to a seconds:fraction pair
+static void frac_add(uint32_t *sec, uint32_t *frac, int32_t d) {
+  uint32_t f = *frac + (uint32_t)d;
+  if (d >= 0 && f < *frac) {
+    (*sec)++;
+  } else if (d < 0 && f > *frac) {
+    (*sec)--;
+  }
+  *frac = f;
+}
+
+static uint8_t days_in_month(uint16_t year, uint8_t month) {
+  if (month == 2 && timekeep_leap_year(year)) {
+    return 29;
+  }
+  return month_days[month - 1];
+}
+
+//================================
+// Public Interface
+//================================
+
+void timekeep_init(void) { rtc_period = (uint32_t)RTC.PER + 1; }
+
+void timekeep_now(timekeep_t *now) {
+  // RTC.CNT goes through the RTC TEMP register, which the compare ISR
+  // (alarm.c) also uses: no interrupt may split the two byte reads
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t cnt = RTC.CNT;
+  uint32_t count = rtc_interrupt_count;
+  uint32_t period = rtc_period;
+  uint32_t sec = offset;
+  uint32_t frac = offset_frac;
+  int32_t a = adj;
+  if ((RTC.INTFLAGS & RTC_OVF_bm) && cnt < period / 2) {
+    count++; // Overflowed, ISR not run yet
+    frac_add(&sec, &frac, a);
+  }
+  SREG = sreg;
+
+  // The running second's fraction plus the share of adj it has run
+  // through; adj / 256 * cnt stays within 32 bits
+  uint32_t part = (((uint32_t)cnt << 16) / period) << 16;
+  frac_add(&sec, &part, a / 256 * (int32_t)cnt / (int32_t)period * 256);
+  uint32_t f = frac + part;
+  if (f < frac) {
+    sec++;
+  }
+  now->seconds = count + sec;
+  now->fraction = (uint16_t)(f >> 16);
+}
+
+uint32_t timekeep_seconds(void) {
+  timekeep_t now;
+  timekeep_now(&now);
+  return now.seconds;
+}
+
+uint16_t timekeep_millis(const timekeep_t *now) {
+  return (uint16_t)(((uint32_t)now->fraction * 1000) >> 16);
+}
+
+void timekeep_set(uint32_t seconds) {
+  uint8_t sreg = SREG;
+  cli();
+  // From whole RTC seconds only: a carry out of offset_frac in the old
+  // reading would otherwise set the clock one second early
+  uint32_t count = rtc_interrupt_count;
+  if ((RTC.INTFLAGS & RTC_OVF_bm) && RTC.CNT < rtc_period / 2) {
+    count++; // Overflowed, ISR not run yet
+  }
+  offset = seconds - count;
+  offset_frac = 0;
+  slew_left = 0;
+  adj = freq;
+  SREG = sreg;
+}
+
+void timekeep_step_us(int64_t us) {
+  int32_t sec = (int32_t)(us / 1000000);
+  int32_t rem = (int32_t)(us % 1000000);
+  if (rem < 0) {
+    rem += 1000000;
+    sec--;
+  }
+  uint32_t d = (uint32_t)(((uint64_t)rem << 32) / 1000000);
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t f = offset_frac + d;
+  offset += (uint32_t)sec + (f < d);
+  offset_frac = f;
+  slew_left = 0;
+  adj = freq;
+  SREG = sreg;
+}
+
+void timekeep_slew_us(int32_t us) {
+  if (us > 499999) {
+    us = 499999;
+  } else if (us < -499999) {
+    us = -499999;
+  }
+  uint8_t sreg = SREG;
+  cli();
+  slew_left = us * FRAC_PER_US;
+  SREG = sreg;
+}
+
+int32_t timekeep_slew_left_us(void) {
+  uint8_t sreg = SREG;
+  cli();
+  int32_t left = slew_left;
+  SREG = sreg;
+  return left / FRAC_PER_US;
+}
+
+void timekeep_set_freq(int32_t ppb) {
+  if (ppb > TIMEKEEP_FREQ_MAX_PPB) {
+    ppb = TIMEKEEP_FREQ_MAX_PPB;
+  } else if (ppb < -TIMEKEEP_FREQ_MAX_PPB) {
+    ppb = -TIMEKEEP_FREQ_MAX_PPB;
+  }
+  int32_t f = (int32_t)((int64_t)ppb * 4294967296LL / 1000000000);
+  uint8_t sreg = SREG;
+  cli();
+  freq = f;
+  freq_ppb = ppb;
+  SREG = sreg;
+}
+
+int32_t timekeep_freq(void) {
+  uint8_t sreg = SREG;
+  cli();
+  int32_t ppb = freq_ppb;
+  SREG = sreg;
+  return ppb;
+}
+
+void timekeep_rtc_overflow(void) {
+  const int32_t slew_max = TIMEKEEP_SLEW_PPM * FRAC_PER_US;
+  uint8_t sreg = SREG;
+  cli(); // Readers run at a higher level (USART3 RX)
+  rtc_interrupt_count++;
+  uint32_t s = offset;
+  uint32_t f = offset_frac;
+  frac_add(&s, &f, adj);
+  offset = s;
+  offset_frac = f;
+
+  int32_t step = slew_left;
+  if (step > slew_max) {
+    step = slew_max;
+  } else if (step < -slew_max) {
+    step = -slew_max;
+  }
+  slew_left -= step;
+  adj = freq + step;
+  SREG = sreg;
+}
+
+uint32_t timekeep_period(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t period = rtc_period;
+  SREG = sreg;
+  return period;
+}
+
+void timekeep_set_period(uint32_t period) {
+  uint8_t sreg = SREG;
+  cli();
+  while (RTC.STATUS & RTC_PERBUSY_bm) {
+    ; // Wait for synchronization
+  }
+  RTC.PER = (uint16_t)(period - 1);
+  rtc_period = period;
+  SREG = sreg;
+}
+
+uint32_t timekeep_offset(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t wall = offset;
+  SREG = sreg;
+  return wall;
+}
+
+bool timekeep_leap_year(uint16_t year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+void timekeep_to_datetime(uint32_t seconds, datetime_t *dt) {
+  uint32_t days = seconds / TIMEKEEP_DAY;
+  uint32_t rem = seconds % TIMEKEEP_DAY;
+
+  dt->hour = rem / 3600;
+  rem %= 3600;
+  dt->minute = rem / 60;
+  dt->second = rem % 60;
+  dt->weekday = (days + 6) % 7; // 2000-01-01 was a Saturday
+
+  uint16_t year = TIMEKEEP_EPOCH_YEAR;
+  while (days >= (timekeep_leap_year(year) ? 366U : 365U)) {
+    days -= timekeep_leap_year(year) ? 366U : 365U;
+    year++;
+  }
+  uint8_t month = 1;
+  while (days >= days_in_month(year, month)) {
+    days -= days_in_month(year, month);
+    month++;
+  }
+  dt->year = year;
+  dt->month = month;
+  dt->day = days + 1;
+}
+
+bool timekeep_from_datetime(const datetime_t *dt, uint32_t *seconds) {
+  if (dt->year < TIMEKEEP_EPOCH_YEAR || dt->year > 2135 || dt->month < 1 ||
+      dt->month > 12 || dt->day < 1 ||
+      dt->day > days_in_month(dt->year, dt->month) || dt->hour > 23 ||
+      dt->minute > 59 || dt->second > 59) {
+    return false;
+  }
+
+  uint32_t days = 0;
+  for (uint16_t y = TIMEKEEP_EPOCH_YEAR; y < dt->year; y++) {
+    days += timekeep_leap_year(y) ? 366 : 365;
+  }
+  for (uint8_t m = 1; m < dt->month; m++) {
+    days += days_in_month(dt->year, m);
+  }
+  days += dt->day - 1;
+
+  *seconds = days * TIMEKEEP_DAY + dt->hour * 3600UL + dt->minute * 60UL +
+             dt->second;
+  return true;
+}
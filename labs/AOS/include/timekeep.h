@@ -0,0 +1,173 @@
+#ifndef TIMEKEEP_H_
+#define TIMEKEEP_H_
+
+/**
+ * @file timekeep.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Wall-clock time as 32-bit epoch seconds plus the RTC fraction
+ *
+ * The RTC overflow ISR only increments rtc_interrupt_count. Wall time is
+ * that count plus an offset set by timekeep_set(), and the fraction of the
+ * running second is the live RTC.CNT, so reads have sub-second resolution
+ * and SET never disturbs the monotonic count that idle.c sleeps against.
+ *
+ * The offset also has a fraction, in 2^-32 s, for timesync.c. Small
+ * corrections are slewed: each overflow adds the next second's share of
+ * the correction (at most TIMEKEEP_SLEW_PPM) plus a frequency term, and
+ * reads interpolate that share over the running second, so wall time
+ * neither jumps nor runs backwards while it is being pulled in. Only
+ * timekeep_set() and timekeep_step_us() jump.
+ *
+ * timekeep_now() takes the count, the offset and RTC.CNT together with
+ * interrupts disabled for a few cycles, accounting for an overflow that is
+ * pending but not serviced yet, so it is safe from ISRs and the main loop.
+ * Hours, minutes and the calendar date (with leap years) are derived from
+ * the seconds only when displayed.
+ *
+ * Epoch: 2000-01-01 00:00:00 (a Saturday), good until 2136.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Seconds per day */
+#define TIMEKEEP_DAY 86400UL
+
+/** @brief First year of the epoch */
+#define TIMEKEEP_EPOCH_YEAR 2000
+
+/** @brief Fastest slew (ppm), on top of the frequency correction */
+#define TIMEKEEP_SLEW_PPM 500
+
+/** @brief Largest frequency correction (ppb) */
+#define TIMEKEEP_FREQ_MAX_PPB 500000L
+
+/**
+ * @brief Consistent time snapshot
+ */
+typedef struct {
+  uint32_t seconds;  ///< Since the epoch
+  uint16_t fraction; ///< Of the running second, in 1/65536 s
+} timekeep_t;
+
+/**
+ * @brief Broken-down time for display and parsing
+ */
+typedef struct {
+  uint16_t year;   ///< 2000..2135
+  uint8_t month;   ///< 1..12
+  uint8_t day;     ///< 1..31
+  uint8_t hour;    ///< 0..23
+  uint8_t minute;  ///< 0..59
+  uint8_t second;  ///< 0..59
+  uint8_t weekday; ///< 0 = Sunday
+} datetime_t;
+
+/**
+ * @brief Read the RTC period (call after the RTC is set up)
+ */
+void timekeep_init(void);
+
+/**
+ * @brief Take a consistent snapshot (ISR-safe)
+ */
+void timekeep_now(timekeep_t *now);
+
+/**
+ * @brief Seconds since the epoch
+ */
+uint32_t timekeep_seconds(void);
+
+/**
+ * @brief Milliseconds into the running second
+ */
+uint16_t timekeep_millis(const timekeep_t *now);
+
+/**
+ * @brief Step the wall clock to the given epoch seconds
+ *
+ * The fraction keeps running, so the new second lasts until the next RTC
+ * overflow. Clears the offset fraction and any slew left; the frequency
+ * correction stays.
+ */
+void timekeep_set(uint32_t seconds);
+
+/**
+ * @brief Step the wall clock by a signed number of microseconds
+ *
+ * Cancels any slew left.
+ */
+void timekeep_step_us(int64_t us);
+
+/**
+ * @brief Pull the wall clock in by a signed number of microseconds
+ *
+ * Replaces any slew left. Runs at TIMEKEEP_SLEW_PPM, so 100 ms takes
+ * 200 s.
+ * @param us Correction, + to advance (clamped to +-0.5 s)
+ */
+void timekeep_slew_us(int32_t us);
+
+/**
+ * @brief Slew not yet applied (us, + to advance)
+ */
+int32_t timekeep_slew_left_us(void);
+
+/**
+ * @brief Set the frequency correction (ppb, + runs the wall clock faster)
+ *
+ * Clamped to +-TIMEKEEP_FREQ_MAX_PPB; takes effect at the next overflow.
+ */
+void timekeep_set_freq(int32_t ppb);
+
+/**
+ * @brief Frequency correction in use (ppb)
+ */
+int32_t timekeep_freq(void);
+
+/**
+ * @brief Start the next second: count it and fold in the adjustment
+ *
+ * Call from ISR(RTC_CNT_vect) on the overflow, after rtccal.
+ */
+void timekeep_rtc_overflow(void);
+
+/**
+ * @brief RTC counts per second (RTC.PER + 1)
+ */
+uint32_t timekeep_period(void);
+
+/**
+ * @brief Change the RTC period (rtccal.c, from the overflow ISR)
+ *
+ * Call only just after an overflow, while RTC.CNT is still below the new
+ * period.
+ */
+void timekeep_set_period(uint32_t period);
+
+/**
+ * @brief Wall seconds minus rtc_interrupt_count
+ *
+ * Changes on a step, and by one when a slew or the frequency correction
+ * carries out of the fraction.
+ */
+uint32_t timekeep_offset(void);
+
+/**
+ * @brief Convert epoch seconds to date and time of day
+ */
+void timekeep_to_datetime(uint32_t seconds, datetime_t *dt);
+
+/**
+ * @brief Convert a date and time of day to epoch seconds
+ * @return false if a field is out of range
+ */
+bool timekeep_from_datetime(const datetime_t *dt, uint32_t *seconds);
+
+/**
+ * @brief Check for a leap year (Gregorian)
+ */
+bool timekeep_leap_year(uint16_t year);
+
+#endif /* TIMEKEEP_H_ */
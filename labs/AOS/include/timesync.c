@@ -0,0 +1,159 @@
+/**
+ * @file timesync.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief NTP-style time sync with a host over the console UART
+ */
+
+#include "timesync.h"
+#include "timekeep.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdlib.h>
+
+//================================
+// Internal State
+//================================
+static bool rx_eol = false;   // Last character was a line end
+static timekeep_t rx_stamp;   // When the last line ended (T2)
+static bool pending = false;  // Request answered with req_t2/req_t3
+static timesync_time_t req_t2, req_t3;
+static bool have_ref = false; // ref_t1 valid (no step since)
+static int64_t ref_t1 = 0;    // T1 of the last slewed exchange (us)
+static timesync_stats_t stats;
+
+//================================
+// Internal Helpers
+//================================
+
+static void to_wire(const timekeep_t *k, timesync_time_t *t) {
+  t->sec = k->seconds;
+  t->usec = ((uint32_t)k->fraction * 15625) >> 10; // 1e6 / 65536
+}
+
+static int64_t to_us(const timesync_time_t *t) {
+  return (int64_t)t->sec * 1000000 + t->usec;
+}
+
+static bool same(const timesync_time_t *a, const timesync_time_t *b) {
+  return a->sec == b->sec && a->usec == b->usec;
+}
+
+static int32_t clamp32(int64_t v) {
+  if (v > INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (v < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return (int32_t)v;
+}
+
+//================================
+// Public Interface
+//================================
+
+void timesync_rx(char c) {
+  bool eol = (c == '\r' || c == '\n');
+  if (eol && !rx_eol) { // First of "\r\n"
+    timekeep_now(&rx_stamp);
+  }
+  rx_eol = eol;
+}
+
+void timesync_request(timesync_time_t *t2, timesync_time_t *t3) {
+  timekeep_t k;
+  uint8_t sreg = SREG;
+  cli();
+  k = rx_stamp;
+  SREG = sreg;
+  to_wire(&k, t2);
+
+  timekeep_now(&k);
+  to_wire(&k, t3);
+  req_t2 = *t2;
+  req_t3 = *t3;
+  pending = true;
+}
+
+timesync_result_t timesync_finish(const timesync_time_t t[4],
+                                  int32_t *offset_us, uint32_t *delay_us) {
+  if (!pending || !same(&t[1], &req_t2) || !same(&t[2], &req_t3)) {
+    return TIMESYNC_STALE;
+  }
+  pending = false;
+
+  int64_t t1 = to_us(&t[0]);
+  int64_t t2 = to_us(&t[1]);
+  int64_t t3 = to_us(&t[2]);
+  int64_t t4 = to_us(&t[3]);
+  int64_t offset = ((t2 - t1) + (t3 - t4)) / 2;
+  int64_t delay = (t4 - t1) - (t3 - t2);
+  if (delay < 0) {
+    delay = 0; // Host clock stepped mid-exchange
+  }
+
+  timesync_result_t result;
+  if (offset > TIMESYNC_STEP_US || offset < -TIMESYNC_STEP_US) {
+    timekeep_step_us(-offset);
+    have_ref = false;
+    stats.steps++;
+    result = TIMESYNC_STEP;
+  } else {
+    // What is left once the slew in progress is done built up since the
+    // last exchange: drift, if that was long enough ago to tell
+    int64_t residual = offset + timekeep_slew_left_us();
+    int64_t interval = (t1 - ref_t1) / 1000000;
+    if (have_ref && interval >= TIMESYNC_MIN_INTERVAL_S) {
+      int32_t drift_ppb = clamp32(residual * 1000 / interval);
+      timekeep_set_freq(timekeep_freq() -
+                        drift_ppb / (1 << TIMESYNC_FREQ_SHIFT));
+    }
+    timekeep_slew_us(clamp32(-residual));
+    ref_t1 = t1;
+    have_ref = true;
+    result = TIMESYNC_SLEW;
+  }
+
+  stats.syncs++;
+  stats.offset_us = clamp32(offset);
+  stats.delay_us = (uint32_t)clamp32(delay);
+  stats.freq_ppb = timekeep_freq();
+  stats.last = timekeep_seconds();
+  if (offset_us != NULL) {
+    *offset_us = stats.offset_us;
+  }
+  if (delay_us != NULL) {
+    *delay_us = stats.delay_us;
+  }
+  return result;
+}
+
+bool timesync_parse(const char **s, timesync_time_t *t) {
+  const char *p = *s;
+  while (*p == ' ') {
+    p++;
+  }
+  if (*p < '0' || *p > '9') {
+    return false;
+  }
+  char *end;
+  t->sec = strtoul(p, &end, 10);
+  p = end;
+  t->usec = 0;
+  if (*p == '.') {
+    uint32_t scale = 100000;
+    for (p++; *p >= '0' && *p <= '9'; p++) {
+      t->usec += (uint32_t)(*p - '0') * scale; // Past 6 digits: dropped
+      scale /= 10;
+    }
+  }
+  *s = p;
+  return true;
+}
+
+bool timesync_get(timesync_stats_t *out) {
+  *out = stats;
+  out->freq_ppb = timekeep_freq();
+  return stats.syncs != 0;
+}
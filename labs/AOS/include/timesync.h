@@ -0,0 +1,111 @@
+#ifndef TIMESYNC_H_
+#define TIMESYNC_H_
+
+/**
+ * @file timesync.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief NTP-style time sync with a host over the console UART
+ *
+ * One exchange is two SYNC lines (tools/timesync.c runs them):
+ *
+ *     host:  SYNC T1              T1 = host time the line was sent
+ *     board: SYNC T1 T2 T3        T2 = line end received, T3 = reply sent
+ *     host:  SYNC T1 T2 T3 T4     T4 = host time the reply arrived
+ *     board: SYNC OK offset=... delay=... freq=... SLEW|STEP
+ *
+ * Times are epoch seconds (2000-01-01, as timekeep.h) and microseconds,
+ * written "S.UUUUUU". T2 is taken in the RX ISR on the line end, so the
+ * main loop's latency does not count as network delay.
+ *
+ *     offset = ((T2 - T1) + (T3 - T4)) / 2   (+: the board is ahead)
+ *     delay  = (T4 - T1) - (T3 - T2)
+ *
+ * Offsets beyond TIMESYNC_STEP_US are stepped; smaller ones are slewed
+ * (timekeep_slew_us()), so wall time stays continuous. Syncs at least
+ * TIMESYNC_MIN_INTERVAL_S apart also correct the frequency: whatever
+ * offset has built up since the last one, with its slew finished, is
+ * drift. A quarter of that rate goes into timekeep_set_freq(), so one
+ * late character does not swing the estimate.
+ *
+ * rtccal.c trims the RTC to the crystal; the frequency here is what is
+ * left against the host. A CAL run moves both, so expect a few syncs to
+ * settle after one.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Offsets larger than this (us) are stepped, not slewed */
+#define TIMESYNC_STEP_US 128000L
+
+/** @brief Shortest sync interval that updates the frequency (s) */
+#define TIMESYNC_MIN_INTERVAL_S 60
+
+/** @brief Frequency gain as a right shift (1/4) */
+#define TIMESYNC_FREQ_SHIFT 2
+
+/**
+ * @brief Timestamp on the wire
+ */
+typedef struct {
+  uint32_t sec;  ///< Epoch seconds
+  uint32_t usec; ///< 0..999999
+} timesync_time_t;
+
+/**
+ * @brief Outcome of an exchange
+ */
+typedef enum {
+  TIMESYNC_STALE, ///< T2/T3 not from the last request
+  TIMESYNC_SLEW,  ///< Offset being slewed
+  TIMESYNC_STEP   ///< Clock stepped (daily alarms need alarm_rebase())
+} timesync_result_t;
+
+/**
+ * @brief Sync state
+ */
+typedef struct {
+  uint32_t syncs;    ///< Exchanges completed
+  uint32_t steps;    ///< Of those, stepped
+  int32_t offset_us; ///< Last offset, clamped to +-2147 s (+: board ahead)
+  uint32_t delay_us; ///< Last round trip
+  int32_t freq_ppb;  ///< Frequency correction in use
+  uint32_t last;     ///< Wall seconds at the last exchange
+} timesync_stats_t;
+
+/**
+ * @brief Watch for the end of a line (call from the RX ISR)
+ */
+void timesync_rx(char c);
+
+/**
+ * @brief Answer "SYNC T1": hand back T2 and T3
+ *
+ * T3 is taken here, so send the reply straight away.
+ */
+void timesync_request(timesync_time_t *t2, timesync_time_t *t3);
+
+/**
+ * @brief Finish an exchange and correct the clock
+ * @param t T1..T4
+ * @param offset_us Measured offset (may be NULL), clamped like the stats
+ * @param delay_us Round trip (may be NULL)
+ */
+timesync_result_t timesync_finish(const timesync_time_t t[4],
+                                  int32_t *offset_us, uint32_t *delay_us);
+
+/**
+ * @brief Parse "S.UUUUUU" (fewer digits are a fraction), skipping spaces
+ * @param s Updated to just past the timestamp
+ * @return false if there is none
+ */
+bool timesync_parse(const char **s, timesync_time_t *t);
+
+/**
+ * @brief Copy the sync state
+ * @return false if no exchange has completed
+ */
+bool timesync_get(timesync_stats_t *stats);
+
+#endif /* TIMESYNC_H_ */
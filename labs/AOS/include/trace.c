@@ -0,0 +1,75 @@
+/**
+ * @file trace.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Timestamped event trace ring
+ */
+
+#include "trace.h"
+
+//================================
+// Ring State
+//================================
+trace_record_t trace_ring[TRACE_BUFFER_SIZE];
+volatile uint8_t trace_head = 0;
+volatile bool trace_enabled = true;
+uint32_t trace_skipped = 0;
+
+static uint8_t sleep_slot = 0;  // Ring slot of the last SLEEP record
+static uint32_t sleep_time = 0; // and its full timestamp
+
+//================================
+// Public Interface
+//================================
+
+void trace_sleep(bool standby) {
+  uint8_t sreg = SREG;
+  cli();
+  sleep_slot = trace_head;
+  sleep_time = trace_time();
+  trace_put_at(TRACE_EV_SLEEP, standby, sleep_time);
+  SREG = sreg;
+}
+
+void trace_wake(uint32_t skipped) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t moved = (uint16_t)(((trace_skipped + skipped) >> TRACE_TICK_SHIFT) -
+                              (trace_skipped >> TRACE_TICK_SHIFT));
+  trace_skipped += skipped;
+
+  // The waking ISR traced before the skip was known: move its records
+  if (moved != 0 && trace_ring[sleep_slot].id == TRACE_EV_SLEEP &&
+      trace_ring[sleep_slot].time == (uint16_t)sleep_time) {
+    for (uint8_t i = (sleep_slot + 1) & (TRACE_BUFFER_SIZE - 1);
+         i != trace_head; i = (i + 1) & (TRACE_BUFFER_SIZE - 1)) {
+      trace_ring[i].time += moved;
+    }
+  }
+
+  // Timestamps are 28 bits of the 32-bit counter
+  uint32_t now = trace_time();
+  uint32_t wraps = ((now - sleep_time) & 0x0FFFFFFFUL) >> 16;
+  trace_put_at(TRACE_EV_WAKE, (wraps > 0xFF) ? 0xFF : (uint8_t)wraps, now);
+  SREG = sreg;
+}
+
+// Event IDs are never 0, so a used slot at head means the ring wrapped
+uint16_t trace_count(void) {
+  return (trace_ring[trace_head].id != 0) ? TRACE_BUFFER_SIZE : trace_head;
+}
+
+void trace_get(uint16_t index, trace_record_t *record) {
+  uint8_t first = (trace_ring[trace_head].id != 0) ? trace_head : 0;
+  *record = trace_ring[(first + index) & (TRACE_BUFFER_SIZE - 1)];
+}
+
+void trace_clear(void) {
+  uint8_t sreg = SREG;
+  cli();
+  for (uint8_t i = 0; i < TRACE_BUFFER_SIZE; i++) {
+    trace_ring[i].id = 0;
+  }
+  trace_head = 0;
+  SREG = sreg;
+}
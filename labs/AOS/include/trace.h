@@ -0,0 +1,139 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/**
+ * @file trace.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Timestamped event trace ring (TRACE command backend)
+ *
+ * Each record is 4 bytes: a 16-bit timestamp in microseconds (the PERF
+ * cycle counter shifted down, wraps every 65.5 ms at 16 MHz), an event ID
+ * and an 8-bit argument. While the CPU is awake the TCA0 tick is traced
+ * every 10 ms, so the host decoder can unwrap timestamps from one record
+ * to the next. Tickless idle (idle.c) sleeps for up to about a second:
+ * each sleep is bracketed by SLEEP and WAKE records, and WAKE carries the
+ * number of whole wraps since SLEEP. In STANDBY the cycle counter stops;
+ * the slept time is added to the trace time base at WAKE (and to records
+ * the waking ISR made), so timestamps run on as if it had kept counting.
+ *
+ * Tracing is compiled in by default; build with make TRACE=0 to remove
+ * every TRACE()/TRACE_ISR() site.
+ */
+
+#include "perf.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Ring size in records (power of two) */
+#define TRACE_BUFFER_SIZE 128
+
+/** @brief Cycle counter bits dropped for the timestamp (1 us at 16 MHz) */
+#define TRACE_TICK_SHIFT 4
+
+//================================
+// Event IDs (never 0; keep tools/trace2json.c in sync)
+//================================
+#define TRACE_EV_TCA0_OVF 0x01   ///< 10 ms tick ISR
+#define TRACE_EV_RTC_CNT 0x02    ///< 1 s RTC ISR, arg = seconds
+#define TRACE_EV_USART_RXC 0x03  ///< RX ISR, arg = received byte
+#define TRACE_EV_USART_DRE 0x04  ///< TX ISR, arg = sent byte
+#define TRACE_EV_CMD_BEGIN 0x10  ///< Command handler entry, arg = index
+#define TRACE_EV_CMD_END 0x11    ///< Command handler exit, arg = index
+#define TRACE_EV_BUTTON 0x12     ///< Button press handled in main loop
+#define TRACE_EV_STATUS 0x13     ///< Periodic status output
+#define TRACE_EV_SLEEP 0x14      ///< Main loop sleeps, arg = 1 for STANDBY
+#define TRACE_EV_WAKE 0x15       ///< Awake, arg = timestamp wraps since SLEEP
+#define TRACE_EV_USER 0x80       ///< First free ID for ad-hoc tracing
+
+/**
+ * @brief One trace record as stored and dumped (little-endian)
+ */
+typedef struct {
+  uint16_t time; ///< Timestamp, 1 << TRACE_TICK_SHIFT cycles per unit
+  uint8_t id;    ///< TRACE_EV_* identifier
+  uint8_t arg;   ///< Event-specific argument
+} trace_record_t;
+
+extern trace_record_t trace_ring[TRACE_BUFFER_SIZE];
+extern volatile uint8_t trace_head;
+extern volatile bool trace_enabled;
+extern uint32_t trace_skipped; // Cycles slept in STANDBY, counter stopped
+
+/** @brief Full trace time, 1 << TRACE_TICK_SHIFT cycles per unit */
+static inline uint32_t trace_time(void) {
+  return (perf_now() + trace_skipped) >> TRACE_TICK_SHIFT;
+}
+
+// Interrupts disabled, as for trace_put()
+static inline void trace_put_at(uint8_t id, uint8_t arg, uint32_t time) {
+  if (!trace_enabled) {
+    return;
+  }
+  uint8_t i = trace_head;
+  trace_head = (i + 1) & (TRACE_BUFFER_SIZE - 1);
+  trace_ring[i].time = (uint16_t)time;
+  trace_ring[i].id = id;
+  trace_ring[i].arg = arg;
+}
+
+// Caller must have interrupts disabled. Being in an ISR is not enough on
+// AVR Dx: the I bit stays set and a level-1 vector (irq.h) can preempt a
+// level-0 handler halfway through the update of trace_head.
+static inline void trace_put(uint8_t id, uint8_t arg) {
+  trace_put_at(id, arg, trace_time());
+}
+
+static inline void trace_record(uint8_t id, uint8_t arg) {
+  uint8_t sreg = SREG;
+  cli();
+  trace_put(id, arg);
+  SREG = sreg;
+}
+
+//================================
+// Instrumentation Macros
+//================================
+#ifdef AOS_TRACE
+#define TRACE(id, arg) trace_record((id), (uint8_t)(arg))
+// Only where nothing can preempt: cli() sections, or the level-1 handler.
+// The level-1 vector can be changed at run time (IRQ), so the AOS ISRs all
+// use TRACE().
+#define TRACE_ISR(id, arg) trace_put((id), (uint8_t)(arg))
+#define TRACE_SLEEP(standby) trace_sleep(standby)
+#define TRACE_WAKE(skipped) trace_wake(skipped)
+#else
+#define TRACE(id, arg)
+#define TRACE_ISR(id, arg)
+#define TRACE_SLEEP(standby)
+#define TRACE_WAKE(skipped)
+#endif
+
+/**
+ * @brief Record SLEEP before the main loop sleeps
+ * @param standby true if the cycle counter will stop (STANDBY)
+ */
+void trace_sleep(bool standby);
+
+/**
+ * @brief Record WAKE after a sleep started with trace_sleep()
+ * @param skipped Cycles slept while the counter stood still (0 in IDLE)
+ */
+void trace_wake(uint32_t skipped);
+
+/**
+ * @brief Number of valid records in the ring (up to TRACE_BUFFER_SIZE)
+ */
+uint16_t trace_count(void);
+
+/**
+ * @brief Copy a record, 0 = oldest (call with tracing paused)
+ */
+void trace_get(uint16_t index, trace_record_t *record);
+
+/**
+ * @brief Discard all records
+ */
+void trace_clear(void);
+
+#endif /* TRACE_H_ */
@@ -13,8 +13,26 @@
  */
 
 #include "ui.h"
+#include "alarm.h"
 #include "circularbuff.h"
+#include "clock.h"
+#include "dashboard.h"
+#include "event.h"
+#include "idle.h"
+#include "irq.h"
+#ifdef AOS_KERNEL
+#include "kernel.h"
+#endif
+#include "loadmon.h"
+#include "memmon.h"
+#include "perf.h"
+#include "regmap.h"
+#include "rtccal.h"
+#include "timekeep.h"
+#include "timesync.h"
+#include "trace.h"
 #include "uart.h"
+#include "watch.h"
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
 #include <avr/io.h>
@@ -71,6 +89,14 @@ void aos_send(const char *str) {
   }
 }
 
+// Send raw bytes (may contain NUL), blocking until queued
+static void aos_send_bytes(const uint8_t *data, uint16_t length) {
+  for (uint16_t i = 0; i < length; i++) {
+    while (!uart_send_char(data[i])) {
+    }
+  }
+}
+
 // Forward declaration (defined after static input buffers)
 void ui_reprompt(void);
 void ui_set_system_info(uint32_t f_cpu_hz, uint32_t uart_baud) {
@@ -96,83 +122,52 @@ void ui_reprompt(void) {
 }
 
 //================================
-// Register and Memory Access Structures
+// Register Access Helpers
 //================================
-typedef struct {
-  const char *name;
-  volatile uint8_t *address;
-  const char *description;
-} register_info_t;
 
-typedef struct {
-  const char *peripheral_name;
-  const register_info_t *registers;
-  uint8_t count;
-} peripheral_info_t;
+// Resolve a hex address or a symbolic register name (e.g. TCA0.SINGLE.PER)
+static bool parse_address(const char *token, uint16_t *address,
+                          uint8_t *width) {
+  if (!isdigit((unsigned char)token[0]) &&
+      regmap_lookup(token, address, width)) {
+    return true;
+  }
+  // Not a register name: a hex address, which may start with A-F too
+  char *end;
+  long value = strtol(token, &end, 16);
+  if (end == token || (*end != '\0' && *end != ' ')) {
+    return false;
+  }
+  *address = (uint16_t)value;
+  *width = 1;
+  return true;
+}
 
-//================================
-// Register Definitions for AVR128DB48
-//================================
-static const register_info_t rtc_registers[] = {
-    {"CTRLA", &RTC.CTRLA, "Control A"},
-    {"STATUS", &RTC.STATUS, "Status"},
-    {"INTCTRL", &RTC.INTCTRL, "Interrupt Control"},
-    {"INTFLAGS", &RTC.INTFLAGS, "Interrupt Flags"},
-    {"TEMP", &RTC.TEMP, "Temporary"},
-    {"DBGCTRL", &RTC.DBGCTRL, "Debug Control"},
-    {"CLKSEL", &RTC.CLKSEL, "Clock Select"},
-    {"CNTL", &RTC.CNTL, "Counter Low"},
-    {"CNTH", &RTC.CNTH, "Counter High"},
-    {"PERL", &RTC.PERL, "Period Low"},
-    {"PERH", &RTC.PERH, "Period High"},
-    {"CMPL", &RTC.CMPL, "Compare Low"},
-    {"CMPH", &RTC.CMPH, "Compare High"}};
-
-static const register_info_t usart3_registers[] = {
-    {"RXDATAL", &USART3.RXDATAL, "Receive Data Low"},
-    {"RXDATAH", &USART3.RXDATAH, "Receive Data High"},
-    {"TXDATAL", &USART3.TXDATAL, "Transmit Data Low"},
-    {"TXDATAH", &USART3.TXDATAH, "Transmit Data High"},
-    {"STATUS", &USART3.STATUS, "Status"},
-    {"CTRLA", &USART3.CTRLA, "Control A"},
-    {"CTRLB", &USART3.CTRLB, "Control B"},
-    {"CTRLC", &USART3.CTRLC, "Control C"},
-    {"BAUDL", &USART3.BAUDL, "Baud Low"},
-    {"BAUDH", &USART3.BAUDH, "Baud High"}};
-
-static const register_info_t portd_registers[] = {
-    {"DIR", &PORTD.DIR, "Direction"},
-    {"DIRSET", &PORTD.DIRSET, "Direction Set"},
-    {"DIRCLR", &PORTD.DIRCLR, "Direction Clear"},
-    {"DIRTGL", &PORTD.DIRTGL, "Direction Toggle"},
-    {"OUT", &PORTD.OUT, "Output Value"},
-    {"OUTSET", &PORTD.OUTSET, "Output Set"},
-    {"OUTCLR", &PORTD.OUTCLR, "Output Clear"},
-    {"OUTTGL", &PORTD.OUTTGL, "Output Toggle"},
-    {"IN", &PORTD.IN, "Input Value"}};
-
-static const register_info_t tca0_registers[] = {
-    {"CTRLA", &TCA0.SINGLE.CTRLA, "Control A"},
-    {"CTRLB", &TCA0.SINGLE.CTRLB, "Control B"},
-    {"CTRLC", &TCA0.SINGLE.CTRLC, "Control C"},
-    {"CTRLD", &TCA0.SINGLE.CTRLD, "Control D"},
-    {"CTRLECLR", &TCA0.SINGLE.CTRLECLR, "Control E Clear"},
-    {"CTRLESET", &TCA0.SINGLE.CTRLESET, "Control E Set"},
-    {"CTRLFCLR", &TCA0.SINGLE.CTRLFCLR, "Control F Clear"},
-    {"CTRLFSET", &TCA0.SINGLE.CTRLFSET, "Control F Set"},
-    {"EVCTRL", &TCA0.SINGLE.EVCTRL, "Event Control"},
-    {"INTCTRL", &TCA0.SINGLE.INTCTRL, "Interrupt Control"},
-    {"INTFLAGS", &TCA0.SINGLE.INTFLAGS, "Interrupt Flags"},
-    {"DBGCTRL", &TCA0.SINGLE.DBGCTRL, "Debug Control"}};
-
-static const peripheral_info_t peripherals[] = {
-    {"RTC", rtc_registers, sizeof(rtc_registers) / sizeof(rtc_registers[0])},
-    {"USART3", usart3_registers,
-     sizeof(usart3_registers) / sizeof(usart3_registers[0])},
-    {"PORTD", portd_registers,
-     sizeof(portd_registers) / sizeof(portd_registers[0])},
-    {"TCA0", tca0_registers,
-     sizeof(tca0_registers) / sizeof(tca0_registers[0])}};
+// 16- and 32-bit registers are accessed low byte first through TEMP
+static uint32_t read_register(uint16_t address, uint8_t width) {
+  switch (width) {
+  case 2:
+    return *(volatile uint16_t *)address;
+  case 4:
+    return *(volatile uint32_t *)address;
+  default:
+    return *(volatile uint8_t *)address;
+  }
+}
+
+static void write_register(uint16_t address, uint8_t width, uint32_t value) {
+  switch (width) {
+  case 2:
+    *(volatile uint16_t *)address = (uint16_t)value;
+    break;
+  case 4:
+    *(volatile uint32_t *)address = value;
+    break;
+  default:
+    *(volatile uint8_t *)address = (uint8_t)value;
+    break;
+  }
+}
 
 //================================
 // Command Structure
@@ -198,17 +193,34 @@ static void cmd_reset(const char *params);
 static void cmd_uart_test(const char *params);
 static void cmd_gpio_test(const char *params);
 static void cmd_timer_info(const char *params);
+static void cmd_dash(const char *params);
+static void cmd_watch(const char *params);
+static void cmd_perf(const char *params);
+static void cmd_mem(const char *params);
+static void cmd_trace(const char *params);
+static void cmd_irq(const char *params);
+static void cmd_cal(const char *params);
+#ifdef AOS_KERNEL
+static void cmd_tasks(const char *params);
+#endif
 
 
 // Legacy RTC commands for backward compatibility
 static void cmd_set_time(const char *params);
+static void cmd_set_date(const char *params);
+static void cmd_sync(const char *params);
 static void cmd_set_alarm(const char *params);
+static void cmd_countdown(const char *params);
+static void cmd_pause(const char *params);
+static void cmd_resume(const char *params);
+static void cmd_cancel(const char *params);
 static void cmd_show_status(const char *params);
 static void cmd_stop_alarm(const char *params);
 
 static void queue_command_line(const char *cmd_line);
 static void collect_uart_input(void);
 static void execute_next_command(void);
+static void stream_watch_frames(void);
 
 //================================
 // Arturo's Operating System Command Table
@@ -217,16 +229,16 @@ static const command_t commands[] = {
     // System Commands
     {"HELP", cmd_help, "HELP                    - Show all commands"},
     {"SYSINFO", cmd_sysinfo,
-     "SYSINFO                 - Show system information"},
+     "SYSINFO [RESET]         - System info, CPU load, loop times"},
     {"RESET", cmd_reset, "RESET                   - Software reset"},
 
     // Register and Memory Commands
     {"REGS", cmd_regs,
-     "REGS [peripheral]       - Show registers (RTC, USART3, PORTD, TCA0)"},
+     "REGS [periph[.prefix]]  - Show registers (e.g. TCA0.SINGLE)"},
     {"READ", cmd_read,
-     "READ <address>          - Read from memory address (hex)"},
+     "READ <addr|name>        - Read hex address or register name"},
     {"WRITE", cmd_write,
-     "WRITE <address> <value> - Write to memory address (hex)"},
+     "WRITE <addr|name> <val> - Write hex address or register name"},
     {"DUMP", cmd_dump, "DUMP <start> [length]   - Memory dump (hex addresses)"},
     {"PEEK", cmd_peek, "PEEK <address>          - Peek at memory location"},
     {"POKE", cmd_poke, "POKE <address> <value>  - Poke value to memory"},
@@ -237,16 +249,104 @@ static const command_t commands[] = {
     {"GPIO", cmd_gpio_test,
      "GPIO <port> <pin> <val> - Test GPIO (D,B,C pin 0-7, val 0/1)"},
     {"TIMER", cmd_timer_info, "TIMER                   - Show timer status"},
+    {"DASH", cmd_dash, "DASH [ON|OFF]           - Live status dashboard"},
+    {"WATCH", cmd_watch,
+     "WATCH [ADD|RATE|BURST|STREAM|STOP|DUMP|CLEAR] - Sample registers"},
+    {"PERF", cmd_perf,
+     "PERF [RESET]            - Cycle counts per command/ISR"},
+    {"MEM", cmd_mem,
+     "MEM                     - RAM sections and stack high-water"},
+    {"TRACE", cmd_trace,
+     "TRACE [HEX|CLEAR|ON|OFF] - Dump event trace (binary)"},
+    {"IRQ", cmd_irq,
+     "IRQ [PROBE [LOW]|STOP|RESET] - Priorities and RX latency"},
+    {"CAL", cmd_cal, "CAL [SECS [EVERY]|STOP] - Trim the RTC to the crystal"},
+#ifdef AOS_KERNEL
+    {"TASKS", cmd_tasks,
+     "TASKS                   - Kernel tasks, stacks, switch cost"},
+#endif
 
     // RTC Application Commands (legacy)
     {"SET", cmd_set_time, "SET HH:MM:SS            - Set current time"},
-    {"ALARM", cmd_set_alarm, "ALARM HH:MM:SS          - Set alarm time"},
+    {"DATE", cmd_set_date, "DATE YYYY-MM-DD         - Set current date"},
+    {"SYNC", cmd_sync,
+     "SYNC [T1 [T2 T3 T4]]    - Host time sync (tools/timesync)"},
+    {"ALARM", cmd_set_alarm,
+     "ALARM HH:MM:SS [NAME]   - Daily alarm (no args: list)"},
+    {"COUNT", cmd_countdown, "COUNT [HH:]MM:SS [NAME] - Start a countdown"},
+    {"PAUSE", cmd_pause, "PAUSE NAME              - Pause a countdown"},
+    {"RESUME", cmd_resume, "RESUME NAME             - Resume a countdown"},
+    {"CANCEL", cmd_cancel,
+     "CANCEL NAME             - Remove an alarm or countdown"},
     {"SHOW", cmd_show_status,
-     "SHOW                    - Display current time and alarm"},
+     "SHOW                    - Display current time and alarms"},
     {"STOP", cmd_stop_alarm, "STOP                    - Stop current alarm"},
     {NULL, NULL, NULL} // End marker
 };
 
+//================================
+// Dashboard Layout
+//================================
+
+static void dash_time(char *buf) {
+  datetime_t now;
+  timekeep_to_datetime(timekeep_seconds(), &now);
+  snprintf(buf, DASH_VALUE_LEN + 1, "%02d:%02d:%02d", now.hour, now.minute,
+           now.second);
+}
+
+// Next entry due: a daily alarm's time, a countdown's time left
+static void dash_alarm(char *buf) {
+  alarm_info_t info;
+  if (!alarm_get(alarm_next(), &info)) {
+    strcpy(buf, "none");
+    return;
+  }
+  uint32_t t = info.daily ? info.at % TIMEKEEP_DAY : info.left;
+  snprintf(buf, DASH_VALUE_LEN + 1, "%s %s%02u:%02u:%02u", info.name,
+           info.daily ? "" : "-", (unsigned)(t / 3600),
+           (unsigned)(t / 60 % 60), (unsigned)(t % 60));
+}
+
+static void dash_status(char *buf) {
+  strcpy(buf, alarm_triggered ? "Alarming!" : "Waiting...");
+}
+
+// LED bar on PORTD, the only "duty" output this lab drives
+static void dash_leds(char *buf) {
+  uint8_t out = PORTD.OUT;
+  for (int8_t i = 7; i >= 0; i--) {
+    *buf++ = (out & (1 << i)) ? '1' : '0';
+  }
+  *buf = '\0';
+}
+
+static void dash_uart(char *buf) {
+  snprintf(buf, DASH_VALUE_LEN + 1, "tx %u rx %u", uart_tx_free_space(),
+           uart_rx_available());
+}
+
+static void dash_cmdq(char *buf) {
+  snprintf(buf, DASH_VALUE_LEN + 1, "%u/%u",
+           (unsigned)circular_buf_size(cmd_line_buffer), CMD_BUFFER_SIZE);
+}
+
+static void dash_rtc(char *buf) {
+  snprintf(buf, DASH_VALUE_LEN + 1, "%lu", rtc_interrupt_count);
+}
+
+static const dash_field_t dash_layout[] = {
+    {1, 1, "ARTURO'S OPERATING SYSTEM " AOS_VERSION, NULL},
+    {2, 1, "Time:   ", dash_time},
+    {2, 30, "Alarm:  ", dash_alarm},
+    {3, 1, "Status: ", dash_status},
+    {3, 30, "LEDs:   ", dash_leds},
+    {4, 1, "UART:   ", dash_uart},
+    {4, 30, "CmdQ:   ", dash_cmdq},
+    {5, 1, "RTC:    ", dash_rtc},
+    {6, 1, "-----------------------------------------------------------",
+     NULL}};
+
 //================================
 // Public Interface Implementation
 //================================
@@ -254,14 +354,25 @@ static const command_t commands[] = {
 void ui_init(void) {
   cmd_line_buffer = circular_buf_init(cmd_line_storage, CMD_BUFFER_SIZE);
   current_cmd_index = 0;
+  dash_init(dash_layout, sizeof(dash_layout) / sizeof(dash_layout[0]));
 }
 
-void ui_process_commands(void) {
+bool ui_process_commands(void) {
+  PERF_BEGIN(start);
+  bool busy = uart_rx_available() || !circular_buf_empty(cmd_line_buffer) ||
+              watch_frames();
+
   // Collect any new input from UART
   collect_uart_input();
 
   // Execute any queued commands
   execute_next_command();
+
+  // Forward WATCH samples while streaming
+  stream_watch_frames();
+
+  PERF_END(PERF_SITE_PROCESS, start);
+  return busy;
 }
 
 void ui_show_welcome(void) {
@@ -288,7 +399,7 @@ void ui_show_welcome(void) {
 
 bool ui_parse_time(const char *time_str, rtc_time_t *time) {
   int h, m, s;
-  if (sscanf(time_str, "%d:%d:%d", &h, &m, &s) == 3) {
+  if (time_str != NULL && sscanf(time_str, "%d:%d:%d", &h, &m, &s) == 3) {
     if (h >= 0 && h < 24 && m >= 0 && m < 60 && s >= 0 && s < 60) {
       time->hours = h;
       time->minutes = m;
@@ -299,20 +410,48 @@ bool ui_parse_time(const char *time_str, rtc_time_t *time) {
   return false;
 }
 
-void ui_display_time(void) {
-  aos_printf("Current Time: %02d:%02d:%02d\r\n", current_time.hours,
-             current_time.minutes, current_time.seconds);
-
-  if (alarm_set) {
-    aos_printf("Alarm Set: %02d:%02d:%02d", alarm_time.hours,
-               alarm_time.minutes, alarm_time.seconds);
-    if (alarm_triggered) {
-      aos_send(" [TRIGGERED!]");
+// One line per alarm and countdown
+static void show_alarms(void) {
+  static const char *const states[] = {"", "", "PAUSED", "DONE"};
+  bool any = false;
+  for (uint8_t id = 0; id < ALARM_MAX; id++) {
+    alarm_info_t info;
+    if (!alarm_get(id, &info)) {
+      continue;
     }
-    aos_send("\r\n");
-  } else {
+    if (info.daily) {
+      uint32_t t = info.at % TIMEKEEP_DAY;
+      aos_printf("Alarm %-7s %02u:%02u:%02u daily", info.name,
+                 (unsigned)(t / 3600), (unsigned)(t / 60 % 60),
+                 (unsigned)(t % 60));
+    } else {
+      aos_printf("Count %-7s %02u:%02u:%02u left %s", info.name,
+                 (unsigned)(info.left / 3600),
+                 (unsigned)(info.left / 60 % 60),
+                 (unsigned)(info.left % 60), states[info.state]);
+    }
+    aos_send(id == alarm_next() ? " (next)\r\n" : "\r\n");
+    any = true;
+  }
+  if (!any) {
     aos_send("No alarm set\r\n");
   }
+}
+
+void ui_display_time(void) {
+  static const char weekdays[7][4] = {"Sun", "Mon", "Tue", "Wed",
+                                      "Thu", "Fri", "Sat"};
+  timekeep_t snap;
+  datetime_t now;
+  timekeep_now(&snap);
+  timekeep_to_datetime(snap.seconds, &now);
+
+  aos_printf("Current Time: %02d:%02d:%02d.%03u\r\n", now.hour, now.minute,
+             now.second, timekeep_millis(&snap));
+  aos_printf("Date: %04u-%02d-%02d %s (epoch %lu)\r\n", now.year, now.month,
+             now.day, weekdays[now.weekday], snap.seconds);
+
+  show_alarms();
 
   // Add status line
   if (alarm_triggered) {
@@ -366,6 +505,37 @@ static void collect_uart_input(void) {
   }
 }
 
+// Format one WATCH frame as space-separated hex fields
+static void format_watch_frame(const uint8_t *frame, char *line) {
+  uint8_t n = watch_channel_count();
+  for (uint8_t i = 0; i < n; i++) {
+    uint16_t address;
+    uint8_t width;
+    watch_channel(i, &address, &width);
+    if (width == 1) {
+      line += sprintf(line, "%02X ", frame[0]);
+    } else {
+      line += sprintf(line, "%04X ", frame[0] | (frame[1] << 8));
+    }
+    frame += width;
+  }
+  strcpy(line - 1, "\r\n");
+}
+
+// Only sends when the whole line fits, so the main loop never blocks here
+static void stream_watch_frames(void) {
+  uint8_t frame[WATCH_MAX_CHANNELS * 2];
+  char line[WATCH_MAX_CHANNELS * 5 + 2];
+
+  if (watch_mode() != WATCH_MODE_STREAM) {
+    return;
+  }
+  while (uart_tx_free_space() >= sizeof(line) && watch_read_frame(frame)) {
+    format_watch_frame(frame, line);
+    aos_send(line);
+  }
+}
+
 static void execute_next_command(void) {
   if (circular_buf_empty(cmd_line_buffer)) {
     return;
@@ -423,7 +593,11 @@ static void execute_next_command(void) {
   bool handled = false;
   for (const command_t *cmd = commands; cmd->name; cmd++) {
     if (strcmp(cmd_name, cmd->name) == 0) {
+      TRACE(TRACE_EV_CMD_BEGIN, cmd - commands);
+      PERF_BEGIN(start);
       cmd->handler((num_parsed > 1) ? params : NULL);
+      PERF_END(PERF_SITE_COMMAND + (cmd - commands), start);
+      TRACE(TRACE_EV_CMD_END, cmd - commands);
       handled = true;
       break;
     }
@@ -457,8 +631,55 @@ static void cmd_help(const char *params) {
   aos_send("-----------------------------------------------------------\r\n");
 }
 
+// Signed tenths of a ppm as "+12.3"
+static void format_dppm(char *buf, size_t len, int32_t dppm) {
+  uint32_t mag = (dppm < 0) ? (uint32_t)-dppm : (uint32_t)dppm;
+  snprintf(buf, len, "%c%lu.%lu", (dppm < 0) ? '-' : '+',
+           (unsigned long)(mag / 10), (unsigned long)(mag % 10));
+}
+
+// RTC calibration state and residual error (SYSINFO, CAL)
+static void show_rtccal(void) {
+  rtccal_stats_t cal;
+  char osc[14], residual[14];
+  if (!rtccal_get(&cal)) {
+    aos_printf("RTC Cal: %s\r\n",
+               rtccal_active() ? "measuring..." : "not run (CAL)");
+    return;
+  }
+  format_dppm(osc, sizeof(osc), cal.osc_dppm);
+  format_dppm(residual, sizeof(residual), cal.residual_dppm);
+  aos_printf("RTC Cal: PER %u  CALIB -%u ppm  Oscillator: %s ppm\r\n",
+             cal.period - 1, cal.calib, osc);
+  aos_printf("RTC Residual: %s ppm (%u s gate, %lu gates)%s\r\n", residual,
+             cal.gate_s, (unsigned long)cal.gates,
+             rtccal_measuring() ? " measuring" : "");
+}
+
+// Last host sync and the corrections in use (SYSINFO, SYNC)
+static void show_timesync(void) {
+  timesync_stats_t sync;
+  char freq[14];
+  if (!timesync_get(&sync)) {
+    aos_send("Time Sync: none (tools/timesync)\r\n");
+    return;
+  }
+  format_dppm(freq, sizeof(freq), sync.freq_ppb / 100);
+  aos_printf("Time Sync: %lu (%lu stepped), last %lu s ago  Freq: %s ppm\r\n",
+             (unsigned long)sync.syncs, (unsigned long)sync.steps,
+             (unsigned long)(timekeep_seconds() - sync.last), freq);
+  aos_printf("Sync Offset: %ld us  Delay: %lu us  Slew Left: %ld us\r\n",
+             (long)sync.offset_us, (unsigned long)sync.delay_us,
+             (long)timekeep_slew_left_us());
+}
+
 static void cmd_sysinfo(const char *params) {
-  (void)params;
+  if (params != NULL && strcasecmp(params, "RESET") == 0) {
+    loadmon_reset();
+    idle_reset();
+    aos_send("Loop statistics cleared\r\n\r\n");
+    return;
+  }
   aos_send("\r\nSYSTEM INFORMATION\r\n");
   aos_send("-----------------------------------------------------------\r\n");
   if (aos_f_cpu_hz) {
@@ -473,6 +694,9 @@ static void cmd_sysinfo(const char *params) {
 #endif
   aos_printf("SREG: 0x%02X                  Interrupts: %s\r\n", SREG,
              (SREG & 0x80) ? "ENABLED" : "DISABLED");
+  uint64_t up_us = clock_ticks_to_us(clock_now_ticks());
+  aos_printf("Uptime: %lu.%06lu s\r\n", (unsigned long)(up_us / 1000000UL),
+             (unsigned long)(up_us % 1000000UL));
 
   // Memory usage estimation
   extern char __heap_start, *__brkval;
@@ -486,103 +710,165 @@ static void cmd_sysinfo(const char *params) {
   aos_printf("Command Buffer: %u/%u used\r\n",
              (unsigned)circular_buf_size(cmd_line_buffer),
              (unsigned)CMD_BUFFER_SIZE);
+
+  // Load and main-loop jitter (SYSINFO RESET clears the histogram)
+  loadmon_stats_t load;
+  loadmon_get(&load);
+  aos_printf("CPU Load: %u.%u%%                ISR Share: %u.%u%%\r\n",
+             load.cpu_permille / 10, load.cpu_permille % 10,
+             load.isr_permille / 10, load.isr_permille % 10);
+  aos_printf("Worst Loop: %lu us           Idle Pass: %u cycles\r\n",
+             (unsigned long)load.worst_us, load.baseline_cycles);
+  idle_stats_t sleep;
+  idle_get_stats(&sleep);
+  aos_printf("Asleep: %u.%u%%  Idle: %lu  Standby: %lu  Ticks Skipped: "
+             "%lu\r\n",
+             load.sleep_permille / 10, load.sleep_permille % 10,
+             (unsigned long)sleep.idle_sleeps,
+             (unsigned long)sleep.standby_sleeps,
+             (unsigned long)sleep.ticks_skipped);
+  show_rtccal();
+  show_timesync();
+  event_stats_t events;
+  event_get_stats(&events);
+  aos_printf("Events: %lu  Dropped: %u  Queue Peak: %u/%u\r\n",
+             (unsigned long)events.dispatched, events.dropped, events.peak,
+             EVENT_QUEUE_SIZE);
+  aos_send("Loop Time Histogram:\r\n");
+  for (uint8_t i = 0; i < LOADMON_BUCKETS; i++) {
+    uint32_t limit = loadmon_bucket_limit_us(i);
+    if (limit) {
+      aos_printf("  < %6lu us: %u\r\n", (unsigned long)limit, load.hist[i]);
+    } else {
+      aos_printf("  >=%6lu us: %u\r\n",
+                 (unsigned long)loadmon_bucket_limit_us(i - 1), load.hist[i]);
+    }
+  }
   aos_send(
       "-----------------------------------------------------------\r\n\r\n");
 }
 
 static void cmd_regs(const char *params) {
-  bool found = false;
+  char name[REGMAP_NAME_MAX + 1];
 
-  if (strlen(params) == 0) {
+  if (params == NULL || *params == '\0') {
     aos_send("\r\nAVAILABLE PERIPHERALS\r\n");
     aos_send("-----------------------------------------------------------\r\n");
-    for (uint8_t i = 0; i < sizeof(peripherals) / sizeof(peripherals[0]); i++) {
-      aos_printf("  %s\r\n", peripherals[i].peripheral_name);
+    uint8_t count = regmap_peripheral_count();
+    for (uint8_t i = 0; i < count; i++) {
+      regmap_peripheral_name(i, name);
+      aos_printf("  %-10s", name);
+      if ((i % 5) == 4 || i == count - 1) {
+        aos_send("\r\n");
+      }
     }
     aos_send("-----------------------------------------------------------\r\n");
-    aos_send("Usage: REGS <peripheral_name>\r\n\r\n");
+    aos_send("Usage: REGS <peripheral>[.<prefix>]\r\n\r\n");
     return;
   }
 
-  // Convert to uppercase for comparison
-  char peripheral_name[16];
-  strncpy(peripheral_name, params, 15);
-  peripheral_name[15] = '\0';
-  for (char *p = peripheral_name; *p; p++) {
-    *p = toupper(*p);
-  }
-
-  for (uint8_t i = 0; i < sizeof(peripherals) / sizeof(peripherals[0]); i++) {
-    if (strcmp(peripheral_name, peripherals[i].peripheral_name) == 0) {
-      found = true;
-      aos_printf("\r\n%s REGISTERS\r\n", peripherals[i].peripheral_name);
-      aos_send(
-          "-----------------------------------------------------------\r\n");
-
-      for (uint8_t j = 0; j < peripherals[i].count; j++) {
-        volatile uint8_t *addr = peripherals[i].registers[j].address;
-        aos_printf("%-12s @ 0x%04X = 0x%02X  (%s)\r\n",
-                   peripherals[i].registers[j].name, (uint16_t)addr, *addr,
-                   peripherals[i].registers[j].description);
-      }
-      aos_send("-----------------------------------------------------------"
-               "\r\n\r\n");
-      break;
+  // Split "TCA0.SINGLE" into peripheral and optional register prefix
+  char peripheral_name[REGMAP_NAME_MAX + 1];
+  strncpy(peripheral_name, params, REGMAP_NAME_MAX);
+  peripheral_name[REGMAP_NAME_MAX] = '\0';
+  char *prefix = strpbrk(peripheral_name, "._");
+  if (prefix) {
+    *prefix++ = '\0';
+    for (char *p = prefix; *p; p++) {
+      *p = (*p == '.') ? '_' : toupper((unsigned char)*p);
     }
   }
 
-  if (!found) {
+  uint8_t index = regmap_find_peripheral(peripheral_name);
+  if (index == REGMAP_NOT_FOUND) {
     aos_printf("Unknown peripheral: %s\r\n", params);
-    aos_send("Available: RTC, USART3, PORTD, TCA0\r\n\r\n");
+    aos_send("Type REGS for the peripheral list\r\n\r\n");
+    return;
   }
+
+  uint8_t count = regmap_peripheral_name(index, name);
+  aos_printf("\r\n%s REGISTERS\r\n", name);
+  aos_send("-----------------------------------------------------------\r\n");
+  size_t prefix_len = prefix ? strlen(prefix) : 0;
+  for (uint8_t j = 0; j < count; j++) {
+    uint16_t addr;
+    uint8_t width;
+    regmap_register(index, j, name, &addr, &width);
+    if (prefix_len && strncmp(name, prefix, prefix_len) != 0) {
+      continue;
+    }
+    uint32_t value = read_register(addr, width);
+    if (width == 1) {
+      aos_printf("%-16s @ 0x%04X = 0x%02X\r\n", name, addr, (uint8_t)value);
+    } else if (width == 2) {
+      aos_printf("%-16s @ 0x%04X = 0x%04X\r\n", name, addr, (uint16_t)value);
+    } else {
+      aos_printf("%-16s @ 0x%04X = 0x%08lX\r\n", name, addr,
+                 (unsigned long)value);
+    }
+  }
+  aos_send("-----------------------------------------------------------"
+           "\r\n\r\n");
 }
 
 static void cmd_read(const char *params) {
-  if (strlen(params) == 0) {
-    aos_send("Usage: READ <hex_address>\r\n");
-    aos_send("Example: READ 0x1000\r\n\r\n");
+  if (params == NULL || *params == '\0') {
+    aos_send("Usage: READ <hex_address | register>\r\n");
+    aos_send("Example: READ 0x1000, READ TCA0.SINGLE.PER\r\n\r\n");
     return;
   }
 
-  uint16_t address = (uint16_t)strtol(params, NULL, 16);
-  volatile uint8_t *ptr = (volatile uint8_t *)address;
+  uint16_t address;
+  uint8_t width;
+  if (!parse_address(params, &address, &width)) {
+    aos_printf("Unknown register: %s\r\n\r\n", params);
+    return;
+  }
+  uint32_t value = read_register(address, width);
 
-  aos_printf("📖 Memory Read: 0x%04X = 0x%02X (%d)\r\n", address, *ptr, *ptr);
+  aos_printf("📖 Memory Read: 0x%04X = 0x%0*lX (%lu)\r\n", address,
+             width * 2, (unsigned long)value, (unsigned long)value);
 
   // Show binary representation
   aos_send("Binary: ");
-  for (int i = 7; i >= 0; i--) {
-    aos_send((*ptr & (1 << i)) ? "1" : "0");
+  for (int8_t i = width * 8 - 1; i >= 0; i--) {
+    aos_send((value & (1UL << i)) ? "1" : "0");
   }
   aos_send("\r\n\r\n");
 }
 
 static void cmd_write(const char *params) {
-  char *token1 = strtok((char *)params, " ");
+  char *token1 = params ? strtok((char *)params, " ") : NULL;
   char *token2 = strtok(NULL, " ");
 
   if (!token1 || !token2) {
-    aos_send("Usage: WRITE <hex_address> <hex_value>\r\n");
-    aos_send("Example: WRITE 0x1000 0xFF\r\n\r\n");
+    aos_send("Usage: WRITE <hex_address | register> <hex_value>\r\n");
+    aos_send("Example: WRITE 0x1000 0xFF, WRITE PORTD.OUT 0x0F\r\n\r\n");
     return;
   }
 
-  uint16_t address = (uint16_t)strtol(token1, NULL, 16);
-  uint8_t value = (uint8_t)strtol(token2, NULL, 16);
-  volatile uint8_t *ptr = (volatile uint8_t *)address;
+  uint16_t address;
+  uint8_t width;
+  if (!parse_address(token1, &address, &width)) {
+    aos_printf("Unknown register: %s\r\n\r\n", token1);
+    return;
+  }
+  uint32_t value = (uint32_t)strtoul(token2, NULL, 16);
 
-  uint8_t old_value = *ptr;
-  *ptr = value;
+  uint32_t old_value = read_register(address, width);
+  write_register(address, width, value);
 
   aos_printf("✏️  Memory Write: 0x%04X\r\n", address);
-  aos_printf("   Old: 0x%02X (%d)\r\n", old_value, old_value);
-  aos_printf("   New: 0x%02X (%d)\r\n", value, value);
+  aos_printf("   Old: 0x%0*lX (%lu)\r\n", width * 2, (unsigned long)old_value,
+             (unsigned long)old_value);
+  aos_printf("   New: 0x%0*lX (%lu)\r\n", width * 2, (unsigned long)value,
+             (unsigned long)value);
   aos_send("\r\n");
 }
 
 static void cmd_dump(const char *params) {
-  char *token1 = strtok((char *)params, " ");
-  char *token2 = strtok(NULL, " ");
+  char *token1 = params ? strtok((char *)params, " ") : NULL;
+  char *token2 = token1 ? strtok(NULL, " ") : NULL;
 
   if (!token1) {
     aos_send("Usage: DUMP <start_address> [length]\r\n");
@@ -772,16 +1058,367 @@ static void cmd_timer_info(const char *params) {
       "-----------------------------------------------------------\r\n\r\n");
 }
 
+static void cmd_dash(const char *params) {
+  if (params == NULL || *params == '\0') {
+    uint32_t updates = dash_update_count();
+    aos_printf("Dashboard: %s\r\n", dash_active() ? "ON" : "OFF");
+    aos_printf("Sent %lu bytes in %lu updates (%lu bytes/update)\r\n\r\n",
+               dash_bytes_sent(), updates,
+               updates ? dash_bytes_sent() / updates : 0UL);
+    return;
+  }
+
+  if (strcasecmp(params, "ON") == 0) {
+    dash_start();
+  } else if (strcasecmp(params, "OFF") == 0) {
+    dash_stop();
+  } else {
+    aos_send("Usage: DASH [ON|OFF]\r\n\r\n");
+  }
+}
+
+static void watch_show_status(void) {
+  aos_send("\r\nWATCH STATUS\r\n");
+  aos_send("-----------------------------------------------------------\r\n");
+  aos_printf("State:    %s (%s)\r\n", watch_running() ? "RUNNING" : "STOPPED",
+             watch_mode() == WATCH_MODE_STREAM ? "stream" : "burst");
+  aos_printf("Rate:     %lu Hz\r\n", (unsigned long)watch_rate());
+  aos_printf("Frames:   %u buffered, %u dropped\r\n", watch_frames(),
+             watch_dropped());
+  for (uint8_t i = 0; i < watch_channel_count(); i++) {
+    uint16_t address;
+    uint8_t width;
+    watch_channel(i, &address, &width);
+    aos_printf("CH%u:      0x%04X (%u-bit)\r\n", i, address, width * 8);
+  }
+  aos_send("-----------------------------------------------------------\r\n");
+}
+
+static void watch_dump(bool binary) {
+  uint8_t frame[WATCH_MAX_CHANNELS * 2];
+  uint8_t size = watch_frame_size();
+
+  if (binary) {
+    // Header line, then raw little-endian frames back to back
+    aos_printf("BIN %u %u\r\n", watch_frames(), size);
+    while (watch_read_frame(frame)) {
+      aos_send_bytes(frame, size);
+    }
+    aos_send("\r\n");
+    return;
+  }
+
+  char line[WATCH_MAX_CHANNELS * 5 + 2];
+  aos_printf("# %u frames @ %lu Hz, %u dropped\r\n", watch_frames(),
+             (unsigned long)watch_rate(), watch_dropped());
+  while (watch_read_frame(frame)) {
+    format_watch_frame(frame, line);
+    aos_send(line);
+  }
+}
+
+static void cmd_watch(const char *params) {
+  if (params == NULL || *params == '\0') {
+    watch_show_status();
+    return;
+  }
+
+  char buf[MAX_CMD_LENGTH];
+  strncpy(buf, params, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = '\0';
+  char *sub = strtok(buf, " ");
+  if (sub == NULL) { // Only spaces
+    watch_show_status();
+    return;
+  }
+  char *arg = strtok(NULL, " ");
+  for (char *p = sub; *p; p++) {
+    *p = toupper((unsigned char)*p);
+  }
+
+  if (strcmp(sub, "ADD") == 0) {
+    uint16_t address;
+    uint8_t width;
+    if (arg == NULL || !parse_address(arg, &address, &width)) {
+      aos_send("Usage: WATCH ADD <hex_address | register>\r\n\r\n");
+      return;
+    }
+    if (!watch_add(address, width)) {
+      aos_send("Cannot add: channel list full or capture running\r\n\r\n");
+      return;
+    }
+    aos_printf("Watching 0x%04X (%u-bit)%s\r\n\r\n", address,
+               (width == 1) ? 8 : 16, (width > 2) ? ", low word only" : "");
+  } else if (strcmp(sub, "CLEAR") == 0) {
+    watch_clear();
+    aos_send("Watch list cleared\r\n\r\n");
+  } else if (strcmp(sub, "RATE") == 0) {
+    uint32_t hz = arg ? strtoul(arg, NULL, 10) : 0;
+    if (!watch_set_rate(hz)) {
+      aos_printf("Rate must be 1..%lu Hz and capture stopped\r\n\r\n",
+                 WATCH_MAX_RATE_HZ);
+      return;
+    }
+    aos_printf("Sample rate: %lu Hz\r\n\r\n", (unsigned long)hz);
+  } else if (strcmp(sub, "BURST") == 0 || strcmp(sub, "STREAM") == 0) {
+    bool stream = (sub[0] == 'S');
+    if (!watch_start(stream ? WATCH_MODE_STREAM : WATCH_MODE_BURST)) {
+      aos_send("Nothing to watch. Use WATCH ADD first\r\n\r\n");
+      return;
+    }
+    aos_send(stream ? "Streaming... WATCH STOP to end\r\n"
+                    : "Burst capture started. WATCH DUMP to read\r\n");
+  } else if (strcmp(sub, "STOP") == 0) {
+    watch_stop();
+    aos_printf("Stopped, %u frames buffered\r\n\r\n", watch_frames());
+  } else if (strcmp(sub, "DUMP") == 0) {
+    watch_dump(arg != NULL && toupper((unsigned char)arg[0]) == 'B');
+  } else {
+    aos_send("Usage: WATCH [ADD <reg>|RATE <hz>|BURST|STREAM|STOP|"
+             "DUMP [BIN]|CLEAR]\r\n\r\n");
+  }
+}
+
+static void perf_print_site(const char *name, uint8_t site) {
+  perf_stat_t stat;
+  if (!perf_get(site, &stat)) {
+    return;
+  }
+  uint32_t avg = stat.total / stat.count;
+  uint32_t cycles_per_us = aos_f_cpu_hz ? aos_f_cpu_hz / 1000000UL : 1;
+  aos_printf("%-10s %8lu %9lu %9lu %9lu %8lu\r\n", name,
+             (unsigned long)stat.count, (unsigned long)stat.min,
+             (unsigned long)avg, (unsigned long)stat.max,
+             (unsigned long)(stat.max / cycles_per_us));
+}
+
+static void cmd_perf(const char *params) {
+  if (params != NULL && strcasecmp(params, "RESET") == 0) {
+    perf_reset();
+    aos_send("Profile counters cleared\r\n\r\n");
+    return;
+  }
+
+  aos_send("\r\nEXECUTION PROFILE (CPU cycles)\r\n");
+  aos_send("-----------------------------------------------------------\r\n");
+  aos_send("Site          Samples       Min       Avg       Max   Max us\r\n");
+  perf_print_site("LOOP", PERF_SITE_PROCESS);
+  perf_print_site("TCA0_OVF", PERF_SITE_TCA0_OVF);
+  perf_print_site("RTC_CNT", PERF_SITE_RTC_CNT);
+  perf_print_site("USART_RXC", PERF_SITE_USART3_RXC);
+  perf_print_site("USART_DRE", PERF_SITE_USART3_DRE);
+  perf_print_site("SWITCH", PERF_SITE_SWITCH);
+  for (const command_t *cmd = commands; cmd->name; cmd++) {
+    perf_print_site(cmd->name, PERF_SITE_COMMAND + (cmd - commands));
+  }
+  aos_send("-----------------------------------------------------------\r\n");
+#ifndef AOS_PERF_ISR
+  aos_send("ISR sites need a build with make PERF_ISR=1\r\n");
+#endif
+  aos_send("\r\n");
+}
+
+static void cmd_mem(const char *params) {
+  (void)params;
+  memmon_info_t mem;
+  memmon_get(&mem);
+
+  aos_send("\r\nMEMORY USAGE\r\n");
+  aos_send("-----------------------------------------------------------\r\n");
+  aos_printf("SRAM Total:   %5u bytes\r\n", mem.ram_size);
+  aos_printf(".data:        %5u bytes\r\n", mem.data);
+  aos_printf(".bss:         %5u bytes\r\n", mem.bss);
+  aos_printf(".noinit:      %5u bytes\r\n", mem.noinit);
+  aos_printf("Heap:         %5u bytes\r\n", mem.heap);
+  aos_printf("Stack Now:    %5u bytes\r\n", mem.stack_now);
+  aos_printf("Stack Peak:   %5u bytes\r\n", mem.stack_peak);
+  aos_printf("Headroom:     %5u bytes never touched\r\n", mem.unused);
+#ifdef AOS_KERNEL
+  // The lines above are the main stack (idle task and ISRs); task stacks
+  // are arrays in .bss with their own high-water marks
+  ktask_info_t info;
+  for (uint8_t i = 0; ktask_info(i, &info); i++) {
+    if (info.stack_size) {
+      aos_printf("Task %-8s %5u of %u stack bytes used\r\n", info.name,
+                 info.stack_used, info.stack_size);
+    }
+  }
+#endif
+  aos_send(
+      "-----------------------------------------------------------\r\n\r\n");
+}
+
+static void cmd_trace(const char *params) {
+  if (params != NULL && strcasecmp(params, "CLEAR") == 0) {
+    trace_clear();
+    aos_send("Trace cleared\r\n\r\n");
+    return;
+  }
+  if (params != NULL && strcasecmp(params, "ON") == 0) {
+    trace_enabled = true;
+    aos_send("Tracing ON\r\n\r\n");
+    return;
+  }
+  if (params != NULL && strcasecmp(params, "OFF") == 0) {
+    trace_enabled = false;
+    aos_send("Tracing OFF\r\n\r\n");
+    return;
+  }
+#ifndef AOS_TRACE
+  aos_send("Tracing not compiled in (make TRACE=1)\r\n");
+#endif
+
+  // Freeze the ring while it is sent; our own output would flood it
+  bool was_enabled = trace_enabled;
+  trace_enabled = false;
+
+  uint16_t count = trace_count();
+  uint32_t cycles_per_us = aos_f_cpu_hz ? aos_f_cpu_hz / 1000000UL : 16;
+  uint16_t tick_ns = (uint16_t)((1000UL << TRACE_TICK_SHIFT) / cycles_per_us);
+  trace_record_t rec;
+
+  if (params != NULL && strcasecmp(params, "HEX") == 0) {
+    aos_printf("# %u events, %u ns/tick\r\n", count, tick_ns);
+    for (uint16_t i = 0; i < count; i++) {
+      trace_get(i, &rec);
+      aos_printf("%04X %02X %02X\r\n", rec.time, rec.id, rec.arg);
+    }
+  } else {
+    // Header line, raw little-endian records, END line (tools/trace2json)
+    aos_printf("TRACE %u %u\r\n", count, tick_ns);
+    for (uint16_t i = 0; i < count; i++) {
+      trace_get(i, &rec);
+      aos_send_bytes((const uint8_t *)&rec, sizeof(rec));
+    }
+    aos_send("\r\nEND\r\n");
+  }
+
+  trace_enabled = was_enabled;
+}
+
+static void cmd_cal(const char *params) {
+  unsigned int gate = RTCCAL_GATE_S, every = 0;
+  if (params == NULL) {
+    show_rtccal();
+    aos_send("\r\n");
+  } else if (strcasecmp(params, "STOP") == 0) {
+    rtccal_stop();
+    aos_send("RTC calibration stopped (trim in use kept)\r\n\r\n");
+  } else if (sscanf(params, "%u %u", &gate, &every) >= 1 && gate >= 1 &&
+             gate <= 255) {
+    rtccal_start(gate, every);
+    aos_printf("RTC calibration: two %u s gates", gate);
+    if (every) {
+      aos_printf(", then one every %u s", every);
+    }
+    aos_send("\r\n\r\n");
+  } else {
+    aos_send("Usage: CAL [SECS [EVERY]|STOP] (SECS 1..255)\r\n\r\n");
+  }
+}
+
+static void cmd_irq(const char *params) {
+  if (params != NULL && strncasecmp(params, "PROBE", 5) == 0) {
+    // Probe the level RX runs at unless LOW asks for level 0
+    bool high = irq_high() != IRQ_NONE && strcasecmp(params, "PROBE LOW");
+    irq_probe_start(aos_f_cpu_hz, high);
+    aos_printf("Latency probe running at level %u (IRQ STOP ends it)\r\n\r\n",
+               high ? 1 : 0);
+    return;
+  }
+  if (params != NULL && strcasecmp(params, "STOP") == 0) {
+    irq_probe_stop();
+    aos_send("Latency probe stopped\r\n\r\n");
+    return;
+  }
+  if (params != NULL && strcasecmp(params, "RESET") == 0) {
+    irq_probe_reset();
+    aos_send("Latency samples and overrun count cleared\r\n\r\n");
+    return;
+  }
+
+  aos_send("\r\nINTERRUPT PRIORITY\r\n");
+  aos_send("-----------------------------------------------------------\r\n");
+  uint8_t vector = irq_high();
+  if (vector == USART3_RXC_vect_num) {
+    aos_printf("Level 1 vector: %u (USART3_RXC)\r\n", vector);
+  } else if (vector != IRQ_NONE) {
+    aos_printf("Level 1 vector: %u\r\n", vector);
+  } else {
+    aos_send("Level 1 vector: none\r\n");
+  }
+  aos_printf("Level 0 order:  %s\r\n",
+             irq_round_robin() ? "round-robin" : "fixed (lowest vector first)");
+  aos_printf("RX overruns:    %u\r\n", irq_rx_overruns());
+
+  // One 8N1 frame; the RX FIFO holds two, so a byte is lost when service
+  // is late by more than about two of these
+  uint32_t char_cycles = aos_f_cpu_hz / aos_uart_baud * 10;
+  uint16_t cycles_per_us = aos_f_cpu_hz / 1000000UL;
+  irq_latency_t lat;
+  if (irq_probe_get(&lat)) {
+    aos_printf("Probe level %u%s: %lu samples\r\n", irq_probe_high() ? 1 : 0,
+               irq_probe_running() ? " (running)" : "",
+               (unsigned long)lat.samples);
+    aos_printf("Latency: min %u avg %lu max %u cycles, max %u us\r\n",
+               lat.min, (unsigned long)(lat.total / lat.samples), lat.max,
+               lat.max / cycles_per_us);
+    aos_printf("Worst case: %lu%% of a character time (%lu us)\r\n",
+               (unsigned long)((uint32_t)lat.max * 100 / char_cycles),
+               (unsigned long)(char_cycles / cycles_per_us));
+  } else {
+    aos_send("Latency probe: no samples (IRQ PROBE starts it)\r\n");
+  }
+  aos_send(
+      "-----------------------------------------------------------\r\n\r\n");
+}
+
+#ifdef AOS_KERNEL
+static void cmd_tasks(const char *params) {
+  static const char *const state_names[] = {"-", "READY", "WAIT", "DONE"};
+  (void)params;
+
+  aos_send("\r\nKERNEL TASKS\r\n");
+  aos_send("-----------------------------------------------------------\r\n");
+  aos_send("Task      Pri  State   Stack Used/Size        Runs\r\n");
+  ktask_info_t info;
+  for (uint8_t i = 0; ktask_info(i, &info); i++) {
+    if (info.stack_size) {
+      aos_printf("%-8s %4u  %-5s   %10u/%-5u %10lu\r\n", info.name,
+                 info.priority, state_names[info.state], info.stack_used,
+                 info.stack_size, (unsigned long)info.runs);
+    } else {
+      aos_printf("%-8s %4u  %-5s   %16s %10lu\r\n", info.name,
+                 info.priority, state_names[info.state], "(main)",
+                 (unsigned long)info.runs);
+    }
+  }
+  aos_printf("RAM per task: %u bytes + stack (context: 37 bytes)\r\n",
+             ktask_overhead());
+
+  perf_stat_t sw;
+  if (perf_get(PERF_SITE_SWITCH, &sw)) {
+    aos_printf("Context switch: min %lu avg %lu max %lu cycles\r\n",
+               (unsigned long)sw.min, (unsigned long)(sw.total / sw.count),
+               (unsigned long)sw.max);
+  }
+  aos_send(
+      "-----------------------------------------------------------\r\n\r\n");
+}
+#endif
+
 //================================
 // Legacy RTC Commands 
 //================================
 
 static void cmd_set_time(const char *params) {
   rtc_time_t new_time;
-  if (ui_parse_time(params, &new_time)) {
-    cli();
-    current_time = new_time;
-    sei();
+  if (params != NULL && ui_parse_time(params, &new_time)) {
+    // Keep today's date, replace the time of day
+    uint32_t now = timekeep_seconds();
+    timekeep_set(now - now % TIMEKEEP_DAY + new_time.hours * 3600UL +
+                 new_time.minutes * 60UL + new_time.seconds);
+    alarm_rebase();
     aos_printf("Time set to %02d:%02d:%02d\r\n", new_time.hours,
                new_time.minutes, new_time.seconds);
   } else {
@@ -789,18 +1426,174 @@ static void cmd_set_time(const char *params) {
   }
 }
 
+static void cmd_set_date(const char *params) {
+  datetime_t dt;
+  unsigned int y, m, d;
+  uint32_t seconds;
+
+  // Keep the time of day, replace the date
+  timekeep_to_datetime(timekeep_seconds(), &dt);
+  if (params == NULL || sscanf(params, "%u-%u-%u", &y, &m, &d) != 3) {
+    aos_send("Invalid date format. Use YYYY-MM-DD\r\n\r\n");
+    return;
+  }
+  dt.year = y;
+  dt.month = m;
+  dt.day = d;
+  if (m > 12 || d > 31 || !timekeep_from_datetime(&dt, &seconds)) {
+    aos_send("Invalid date (2000-01-01 to 2135-12-31)\r\n\r\n");
+    return;
+  }
+  timekeep_set(seconds);
+  alarm_rebase();
+  aos_printf("Date set to %04u-%02u-%02u\r\n", y, m, d);
+}
+
+// SYNC T1 answers with T2 and T3; SYNC T1 T2 T3 T4 corrects the clock
+static void cmd_sync(const char *params) {
+  timesync_time_t t[4];
+  uint8_t n = 0;
+  if (params == NULL) {
+    show_timesync();
+    aos_send("\r\n");
+    return;
+  }
+  const char *p = params;
+  while (n < 4 && timesync_parse(&p, &t[n])) {
+    n++;
+  }
+
+  if (n == 1 && *p == '\0') {
+    // Let the echo drain so that the reply leaves right after T3
+    while (!UART_TX_BUFFER_EMPTY() || (USART3.CTRLA & USART_DREIE_bm) ||
+           !(USART3.STATUS & USART_TXCIF_bm)) {
+      ;
+    }
+    timesync_request(&t[1], &t[2]);
+    aos_printf("SYNC %lu.%06lu %lu.%06lu %lu.%06lu\r\n",
+               (unsigned long)t[0].sec, (unsigned long)t[0].usec,
+               (unsigned long)t[1].sec, (unsigned long)t[1].usec,
+               (unsigned long)t[2].sec, (unsigned long)t[2].usec);
+  } else if (n == 4 && *p == '\0') {
+    int32_t offset;
+    uint32_t delay;
+    timesync_result_t result = timesync_finish(t, &offset, &delay);
+    if (result == TIMESYNC_STALE) {
+      aos_send("SYNC STALE\r\n\r\n");
+      return;
+    }
+    if (result == TIMESYNC_STEP) {
+      alarm_rebase();
+    }
+    aos_printf("SYNC OK offset=%ld delay=%lu freq=%ld %s\r\n\r\n",
+               (long)offset, (unsigned long)delay, (long)timekeep_freq(),
+               result == TIMESYNC_STEP ? "STEP" : "SLEW");
+  } else {
+    aos_send("Usage: SYNC [T1 [T2 T3 T4]] (S.UUUUUU since 2000-01-01)\r\n\r\n");
+  }
+}
+
+// Split "<time> [NAME]" in place; the default name when there is none
+static const char *split_name(char *args, const char *def) {
+  char *name = strchr(args, ' ');
+  if (name == NULL) {
+    return def;
+  }
+  *name++ = '\0';
+  while (*name == ' ') {
+    name++;
+  }
+  return *name ? name : def;
+}
+
+// MM:SS or HH:MM:SS, at least one second
+static bool parse_duration(const char *str, uint32_t *seconds) {
+  unsigned int a, b, c;
+  int n = sscanf(str, "%u:%u:%u", &a, &b, &c);
+  if (n == 3 && b < 60 && c < 60) {
+    *seconds = a * 3600UL + b * 60UL + c;
+  } else if (n == 2 && b < 60) {
+    *seconds = a * 60UL + b;
+  } else {
+    return false;
+  }
+  return *seconds > 0;
+}
+
 static void cmd_set_alarm(const char *params) {
+  if (params == NULL) {
+    show_alarms();
+    aos_send("\r\n");
+    return;
+  }
+  char args[MAX_CMD_LENGTH];
+  strncpy(args, params, sizeof(args) - 1);
+  args[sizeof(args) - 1] = '\0';
+  const char *name = split_name(args, "ALARM");
+
   rtc_time_t new_alarm;
-  if (ui_parse_time(params, &new_alarm)) {
-    cli();
-    alarm_time = new_alarm;
-    alarm_set = true;
-    alarm_triggered = false;
-    sei();
-    aos_printf("Alarm set to %02d:%02d:%02d\r\n", new_alarm.hours,
-               new_alarm.minutes, new_alarm.seconds);
+  if (!ui_parse_time(args, &new_alarm)) {
+    aos_send("Invalid time format. Use HH:MM:SS [NAME]\r\n\r\n");
+    return;
+  }
+  uint32_t sod = new_alarm.hours * 3600UL + new_alarm.minutes * 60UL +
+                 new_alarm.seconds;
+  if (alarm_daily(name, sod) == ALARM_NONE) {
+    aos_printf("No free alarm slot (%u in use)\r\n\r\n", ALARM_MAX);
+    return;
+  }
+  aos_printf("Alarm %s set to %02d:%02d:%02d\r\n", name, new_alarm.hours,
+             new_alarm.minutes, new_alarm.seconds);
+}
+
+static void cmd_countdown(const char *params) {
+  char args[MAX_CMD_LENGTH];
+  uint32_t seconds;
+  if (params == NULL) {
+    aos_send("Usage: COUNT [HH:]MM:SS [NAME]\r\n\r\n");
+    return;
+  }
+  strncpy(args, params, sizeof(args) - 1);
+  args[sizeof(args) - 1] = '\0';
+  const char *name = split_name(args, "COUNT");
+
+  if (!parse_duration(args, &seconds)) {
+    aos_send("Invalid duration. Use MM:SS or HH:MM:SS\r\n\r\n");
+    return;
+  }
+  if (alarm_countdown(name, seconds) == ALARM_NONE) {
+    aos_printf("No free alarm slot (%u in use)\r\n\r\n", ALARM_MAX);
+    return;
+  }
+  aos_printf("Countdown %s started: %lu s\r\n", name,
+             (unsigned long)seconds);
+}
+
+static void cmd_pause(const char *params) {
+  const char *name = params ? params : "COUNT";
+  if (alarm_pause(name)) {
+    aos_printf("Countdown %s paused\r\n", name);
   } else {
-    aos_send("Invalid time format. Use HH:MM:SS\r\n\r\n");
+    aos_printf("No running countdown %s\r\n\r\n", name);
+  }
+}
+
+static void cmd_resume(const char *params) {
+  const char *name = params ? params : "COUNT";
+  if (alarm_resume(name)) {
+    aos_printf("Countdown %s resumed\r\n", name);
+  } else {
+    aos_printf("No paused countdown %s\r\n\r\n", name);
+  }
+}
+
+static void cmd_cancel(const char *params) {
+  if (params == NULL) {
+    aos_send("Usage: CANCEL NAME\r\n\r\n");
+  } else if (alarm_cancel(params)) {
+    aos_printf("%s removed\r\n", params);
+  } else {
+    aos_printf("No alarm or countdown %s\r\n\r\n", params);
   }
 }
 
@@ -28,7 +28,7 @@
 #define MAX_CMD_LENGTH 64
 
 //================================
-// RTC Time Structure (shared with main.c)
+// Time of Day (SET/ALARM parsing; the wall clock is include/timekeep.h)
 //================================
 typedef struct {
     uint8_t hours;
@@ -39,9 +39,6 @@ typedef struct {
 //================================
 // External variables (defined in main.c)
 //================================
-extern volatile rtc_time_t current_time;
-extern volatile rtc_time_t alarm_time;
-extern volatile bool alarm_set;
 extern volatile bool alarm_triggered;
 extern volatile uint32_t rtc_interrupt_count;
 
@@ -63,8 +60,10 @@ void ui_init(void);
  * This function should be called regularly from the main loop.
  * It collects input from UART, builds command lines, and executes
  * any complete commands that have been received.
+ *
+ * @return true if there was input or a queued command to handle
  */
-void ui_process_commands(void);
+bool ui_process_commands(void);
 
 /**
  * @brief Display Arturo's OS boot message and help
@@ -0,0 +1,209 @@
+/**
+ * @file watch.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief High-rate register/variable sampler driven by TCB3
+ */
+
+#include "watch.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+typedef struct {
+  volatile uint8_t *address;
+  uint8_t width;
+} watch_channel_t;
+
+//================================
+// Internal State
+//================================
+static watch_channel_t channels[WATCH_MAX_CHANNELS];
+static uint8_t channel_count = 0;
+static uint8_t frame_size = 0;
+
+static uint8_t ring[WATCH_BUFFER_SIZE];
+static uint16_t ring_capacity = 0; // In frames
+static uint16_t ring_head = 0;
+static uint16_t ring_tail = 0;
+static volatile uint16_t ring_count = 0;
+static volatile uint16_t dropped = 0;
+
+static uint32_t timer_clock_hz = 0;
+static uint32_t rate_hz = 100;
+static uint16_t timer_period = 0;
+static uint16_t decimation = 1;
+static volatile uint16_t decimation_count = 1;
+
+static watch_mode_t capture_mode = WATCH_MODE_BURST;
+static volatile bool running = false;
+
+//================================
+// Timer Control
+//================================
+
+// TCB3 counts CLK_PER/2; rates below CLK_PER/2/65536 are reached by also
+// skipping ticks in software
+static void compute_period(uint32_t hz) {
+  uint32_t ticks = timer_clock_hz / hz;
+  decimation = (uint16_t)(ticks / 65536UL) + 1;
+  timer_period = (uint16_t)(ticks / decimation);
+}
+
+static void timer_stop(void) {
+  TCB3.CTRLA = 0;
+  TCB3.INTCTRL = 0;
+  TCB3.INTFLAGS = TCB_CAPT_bm;
+  running = false;
+}
+
+//================================
+// Public Interface
+//================================
+
+void watch_init(uint32_t f_clk_per) {
+  timer_clock_hz = f_clk_per / 2;
+  timer_stop();
+  TCB3.CTRLB = TCB_CNTMODE_INT_gc; // Periodic interrupt
+  compute_period(rate_hz);
+}
+
+bool watch_add(uint16_t address, uint8_t width) {
+  if (running || channel_count >= WATCH_MAX_CHANNELS) {
+    return false;
+  }
+  channels[channel_count].address = (volatile uint8_t *)address;
+  channels[channel_count].width = (width == 1) ? 1 : 2;
+  frame_size += channels[channel_count].width;
+  channel_count++;
+  return true;
+}
+
+void watch_clear(void) {
+  timer_stop();
+  channel_count = 0;
+  frame_size = 0;
+  ring_count = 0;
+}
+
+uint8_t watch_channel_count(void) { return channel_count; }
+
+void watch_channel(uint8_t index, uint16_t *address, uint8_t *width) {
+  *address = (uint16_t)channels[index].address;
+  *width = channels[index].width;
+}
+
+bool watch_set_rate(uint32_t hz) {
+  if (running || hz == 0 || hz > WATCH_MAX_RATE_HZ) {
+    return false;
+  }
+  rate_hz = hz;
+  compute_period(hz);
+  return true;
+}
+
+uint32_t watch_rate(void) { return rate_hz; }
+
+bool watch_start(watch_mode_t mode) {
+  if (channel_count == 0) {
+    return false;
+  }
+  timer_stop();
+
+  capture_mode = mode;
+  ring_capacity = WATCH_BUFFER_SIZE / frame_size;
+  ring_head = 0;
+  ring_tail = 0;
+  ring_count = 0;
+  dropped = 0;
+  decimation_count = decimation;
+
+  running = true;
+  TCB3.CNT = 0;
+  TCB3.CCMP = timer_period - 1;
+  TCB3.INTCTRL = TCB_CAPT_bm;
+  TCB3.CTRLA = TCB_CLKSEL_DIV2_gc | TCB_ENABLE_bm;
+  return true;
+}
+
+void watch_stop(void) { timer_stop(); }
+
+bool watch_running(void) { return running; }
+
+watch_mode_t watch_mode(void) { return capture_mode; }
+
+uint8_t watch_frame_size(void) { return frame_size; }
+
+uint16_t watch_frames(void) {
+  uint16_t count;
+  uint8_t sreg = SREG;
+  cli();
+  count = ring_count;
+  SREG = sreg;
+  return count;
+}
+
+uint16_t watch_dropped(void) {
+  uint16_t count;
+  uint8_t sreg = SREG;
+  cli();
+  count = dropped;
+  SREG = sreg;
+  return count;
+}
+
+bool watch_read_frame(uint8_t *frame) {
+  uint8_t sreg = SREG;
+  cli();
+  if (ring_count == 0) {
+    SREG = sreg;
+    return false;
+  }
+  const uint8_t *src = &ring[ring_tail * frame_size];
+  for (uint8_t i = 0; i < frame_size; i++) {
+    frame[i] = src[i];
+  }
+  if (++ring_tail == ring_capacity) {
+    ring_tail = 0;
+  }
+  ring_count--;
+  SREG = sreg;
+  return true;
+}
+
+//================================
+// Sampler ISR
+//================================
+ISR(TCB3_INT_vect) {
+  TCB3.INTFLAGS = TCB_CAPT_bm;
+
+  if (--decimation_count) {
+    return;
+  }
+  decimation_count = decimation;
+
+  if (ring_count >= ring_capacity) {
+    if (capture_mode == WATCH_MODE_BURST) {
+      timer_stop();
+    } else {
+      dropped++;
+    }
+    return;
+  }
+
+  uint8_t *dst = &ring[ring_head * frame_size];
+  for (uint8_t i = 0; i < channel_count; i++) {
+    volatile uint8_t *src = channels[i].address;
+    *dst++ = src[0]; // Low byte first latches the high byte into TEMP
+    if (channels[i].width == 2) {
+      *dst++ = src[1];
+    }
+  }
+  if (++ring_head == ring_capacity) {
+    ring_head = 0;
+  }
+  ring_count++;
+
+  if (capture_mode == WATCH_MODE_BURST && ring_count >= ring_capacity) {
+    timer_stop();
+  }
+}
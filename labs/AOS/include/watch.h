@@ -0,0 +1,125 @@
+#ifndef WATCH_H_
+#define WATCH_H_
+
+/**
+ * @file watch.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief High-rate register/variable sampler (WATCH command backend)
+ *
+ * TCB3 runs in periodic interrupt mode at the requested rate. Every tick
+ * the ISR copies each watched data-space location (8 or 16 bit) into one
+ * fixed-size frame of a RAM ring. Burst mode stops when the ring is full;
+ * stream mode keeps sampling and counts frames that did not fit while the
+ * console drains the ring.
+ *
+ * 16-bit registers are read low byte first through the peripheral TEMP
+ * register, so avoid watching a 16-bit register of a peripheral that main
+ * code is also accessing with 16-bit reads at the same time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief Maximum number of watched locations */
+#define WATCH_MAX_CHANNELS 4
+
+/** @brief Sample ring size in bytes */
+#define WATCH_BUFFER_SIZE 512
+
+/** @brief Highest accepted sample rate */
+#define WATCH_MAX_RATE_HZ 20000UL
+
+/**
+ * @brief Capture modes
+ */
+typedef enum {
+  WATCH_MODE_BURST, ///< Fill the ring once, then stop
+  WATCH_MODE_STREAM ///< Sample continuously, reader drains the ring
+} watch_mode_t;
+
+/**
+ * @brief Initialize the sampler (timer stays off)
+ * @param f_clk_per Peripheral clock in Hz
+ */
+void watch_init(uint32_t f_clk_per);
+
+/**
+ * @brief Add a location to the frame
+ * @param address Data-space address
+ * @param width 1 or 2 bytes (4-byte registers are sampled as their low word)
+ * @return false if the channel list is full or a capture is running
+ */
+bool watch_add(uint16_t address, uint8_t width);
+
+/**
+ * @brief Remove all channels (stops any running capture)
+ */
+void watch_clear(void);
+
+/**
+ * @brief Number of configured channels
+ */
+uint8_t watch_channel_count(void);
+
+/**
+ * @brief Get one channel's address and width
+ */
+void watch_channel(uint8_t index, uint16_t *address, uint8_t *width);
+
+/**
+ * @brief Set the sample rate
+ * @param hz Samples per second, 1 .. WATCH_MAX_RATE_HZ
+ * @return false if out of range or a capture is running
+ */
+bool watch_set_rate(uint32_t hz);
+
+/**
+ * @brief Currently configured sample rate in Hz
+ */
+uint32_t watch_rate(void);
+
+/**
+ * @brief Discard old samples and start capturing
+ * @return false if no channel is configured
+ */
+bool watch_start(watch_mode_t mode);
+
+/**
+ * @brief Stop capturing (samples stay in the ring)
+ */
+void watch_stop(void);
+
+/**
+ * @brief Check if the sampler timer is running
+ */
+bool watch_running(void);
+
+/**
+ * @brief Current capture mode
+ */
+watch_mode_t watch_mode(void);
+
+/**
+ * @brief Bytes per frame (sum of channel widths)
+ */
+uint8_t watch_frame_size(void);
+
+/**
+ * @brief Number of complete frames waiting in the ring
+ */
+uint16_t watch_frames(void);
+
+/**
+ * @brief Frames lost because the ring was full (stream mode)
+ */
+uint16_t watch_dropped(void);
+
+/**
+ * @brief Pop the oldest frame
+ * @param frame Destination, watch_frame_size() bytes
+ * @return false if the ring is empty
+ */
+bool watch_read_frame(uint8_t *frame);
+
+#endif /* WATCH_H_ */
@@ -6,9 +6,26 @@
  */
 #define F_CPU 16000000UL // 16 MHz clock speed
 #define __AVR_AVR128DB48__
+#include "include/alarm.h"
+#include "include/clock.h"
 #include "include/cpu.h"
+#include "include/dashboard.h"
+#include "include/event.h"
+#include "include/idle.h"
+#include "include/irq.h"
+#include "include/loadmon.h"
+#include "include/perf.h"
+#include "include/rtccal.h"
+#include "include/swtimer.h"
+#include "include/timekeep.h"
+#include "include/timesync.h"
+#include "include/trace.h"
 #include "include/uart.h"
 #include "include/ui.h"
+#include "include/watch.h"
+#ifdef AOS_KERNEL
+#include "include/kernel.h"
+#endif
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
 #include <avr/io.h>
@@ -20,22 +37,27 @@
 
 #define BAUD_RATE 9600
 
-// Global variables for time keeping
-volatile rtc_time_t current_time = {0, 0, 0};
-volatile rtc_time_t alarm_time = {0, 0, 0};
-volatile bool alarm_set = false;
-volatile bool alarm_triggered = false;
+// Global variables for time keeping (wall time: include/timekeep.h)
+volatile bool alarm_triggered = false; // Ringing until STOP
 volatile uint32_t rtc_interrupt_count = 0;
 
-// Global variable for button pushing
-volatile uint16_t button_counter = 0;
-volatile bool button_pushed = false;
+// Periodic activities on the TCA0 tick (see include/swtimer.h)
+static void button_sample(void *ctx);
+static void alarm_blink(void *ctx);
+static void show_status(void *ctx);
 
-// Timer-based counters
-volatile uint16_t tca_tick_counter = 0;
-volatile uint16_t led_blink_counter = 0;
-volatile uint16_t status_display_counter = 0;
-volatile bool display_status_flag = false;
+static swtimer_t button_timer = SWTIMER_INIT(button_sample, NULL, SWTIMER_ISR);
+static swtimer_t alarm_blink_timer =
+    SWTIMER_INIT(alarm_blink, NULL, SWTIMER_ISR);
+static swtimer_t status_timer = SWTIMER_INIT(show_status, NULL, SWTIMER_ISR);
+
+#ifdef AOS_KERNEL
+// Tasks replace the main loop (see include/kernel.h)
+static uint8_t console_stack[768]; // Command handlers and aos_printf()
+static uint8_t sample_stack[192];
+static ksem_t event_sem = KSEM_INIT(0);  // One count per posted event
+static ksem_t button_sem = KSEM_INIT(0); // Button pin edge
+#endif
 
 //********************************
 // LED Initialization
@@ -54,9 +76,21 @@ void init_led() {
 // ********************************
 void init_button() {
   PORTB.DIRCLR = PIN2_bm; // Onboard button - input
-  PORTB.PIN2CTRL = PORT_PULLUPEN_bm; // Enable pull-up only 
+  PORTB.PIN2CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc; // Wakes sleep
   PORTB.DIRCLR = PIN5_bm;  // External button - input
-  PORTB.PIN5CTRL = PORT_PULLUPEN_bm; // Enable pull-up only 
+  PORTB.PIN5CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
+}
+
+// A button edge starts sampling; nothing polls while they are released
+ISR(PORTB_PORT_vect) {
+  PORTB.INTFLAGS = PIN2_bm | PIN5_bm;
+#ifdef AOS_KERNEL
+  ksem_post(&button_sem);
+#else
+  if (!swtimer_active(&button_timer)) {
+    swtimer_start(&button_timer, 1, 1);
+  }
+#endif
 }
 
 //************************************************
@@ -74,42 +108,105 @@ void init_tca0() {
 }
 
 ISR(TCA0_OVF_vect) {
+  PERF_ISR_BEGIN();
+  TRACE(TRACE_EV_TCA0_OVF, swtimer_now());
   // Clear interrupt flag
   TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
 
-  if (button_counter < 65535) {
-    if (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
-      button_counter++;
+  idle_tick(); // One or more ticks, see include/idle.h
+  PERF_ISR_END(PERF_SITE_TCA0_OVF);
+}
+
+//*****************************************************************************
+// Software Timer Callbacks
+//*****************************************************************************
+
+// Every tick while a button is down: held for 100 ticks (1 s) posts a
+// press; stops on release until the next pin edge
+static void button_sample(void *ctx) {
+  static uint8_t held = 0;
+  (void)ctx;
+  if (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
+    if (++held >= 100) {
+      event_post(EV_BUTTON, 0);
+      held = 0;
     }
   } else {
-    button_counter = 0;
+    swtimer_stop(&button_timer);
   }
-  if (button_counter >= 100) {
-    button_pushed = true;
-    button_counter = 0;
-  }
-
-  // Increment 10ms tick counter
-  tca_tick_counter++;
+}
 
-  // Handle LED blinking for alarm (every 50 ticks = 500ms)
+// Every 500 ms while the alarm rings; stops itself once it is cleared
+static void alarm_blink(void *ctx) {
+  (void)ctx;
   if (alarm_triggered) {
-    led_blink_counter++;
-    if (led_blink_counter >= 50) { // 500ms
-      led_blink_counter = 0;
-      PORTB.OUTTGL = PIN3_bm;
-    }
+    PORTB.OUTTGL = PIN3_bm;
   } else {
-    led_blink_counter = 0;
-    PORTB.OUTSET = PIN3_bm; // Turn off LEDs when no alarm
+    PORTB.OUTSET = PIN3_bm; // LED off
+    swtimer_stop(&alarm_blink_timer);
   }
+}
+
+// Every 30 s; the report itself is printed by on_status()
+static void show_status(void *ctx) {
+  (void)ctx;
+  event_post(EV_STATUS, 0);
+}
 
-  // Handle periodic status display (every 3000 ticks = 30 seconds)
-  status_display_counter++;
-  if (status_display_counter >= 3000) { // 30 seconds
-    status_display_counter = 0;
-    // Set flag for main loop to display status
-    display_status_flag = true;
+// An alarm or countdown fired (RTC interrupt, see include/alarm.h)
+static void alarm_due(uint8_t id) {
+  alarm_triggered = true;
+  swtimer_start(&alarm_blink_timer, SWTIMER_MS(500), SWTIMER_MS(500));
+  event_post(EV_ALARM, id);
+}
+
+//*****************************************************************************
+// Event Handlers (main loop, interrupts enabled)
+//*****************************************************************************
+
+// Received bytes, and console work left over from the previous call
+static void on_console(uint8_t arg) {
+  (void)arg;
+  if (ui_process_commands() ||
+      (watch_running() && watch_mode() == WATCH_MODE_STREAM)) {
+    event_post_once(EV_CONSOLE, 0); // More queued lines or WATCH frames
+  }
+}
+
+static void on_button(uint8_t arg) {
+  (void)arg;
+  if (!(PORTB.IN & PIN2_bm)) {
+    datetime_t now;
+    timekeep_to_datetime(timekeep_seconds(), &now);
+    aos_printf("\r\nButton Pressed! Current Time: %02d:%02d:%02d\r\n",
+               now.hour, now.minute, now.second);
+    TRACE(TRACE_EV_BUTTON, 0);
+  }
+}
+
+// Dashboard sends only changed fields, once per RTC second
+static void on_second(uint8_t seconds) {
+  (void)seconds;
+  rtccal_process();
+  dash_update();
+}
+
+static void on_alarm(uint8_t id) {
+  alarm_info_t info;
+  if (alarm_get(id, &info)) {
+    aos_printf("\r\n*** %s %s ***\r\n", info.daily ? "ALARM" : "COUNTDOWN",
+               info.name);
+  }
+}
+
+// The dashboard replaces the full block
+static void on_status(uint8_t arg) {
+  (void)arg;
+  TRACE(TRACE_EV_STATUS, 0);
+  if (!dash_active()) {
+    aos_send("\r\n--- AOS Status Update ---\r\n");
+    ui_display_time();
+    aos_send("AOS> \r\n");
   }
 }
 
@@ -121,69 +218,122 @@ void RTC_init(void) {
   RTC.CLKSEL = RTC_CLKSEL_OSC32K_gc;
 
   // 2. Set overflow period: 32768 ticks = 1 second
-  RTC.PER = 32768;
+  RTC.PER = 32768 - 1;
 
   // 3. Enable overflow interrupt
   RTC.INTCTRL = RTC_OVF_bm;
 
-  // 4. Enable RTC with no prescaler
-  RTC.CTRLA = RTC_RTCEN_bm | RTC_PRESCALER_DIV1_gc;
+  // 4. Enable RTC with no prescaler, also counting in standby sleep
+  RTC.CTRLA = RTC_RTCEN_bm | RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm;
 
   // 5. Global interrupts will be enabled in main()
 }
+
 // ****************************************************************************
 // RTC Interrupt Service Routines
 // ****************************************************************************
 ISR(RTC_CNT_vect) {
-  // Clear interrupt flag
-  RTC.INTFLAGS = RTC_OVF_bm;
-
-  // Increment interrupt counter for debugging
-  rtc_interrupt_count++;
-  PORTC.OUTTGL = PIN7_bm;
+  PERF_ISR_BEGIN();
+  // Clear interrupt flags (CMP is enabled only while a deadline is near)
+  uint8_t flags = RTC.INTFLAGS & RTC.INTCTRL;
+  RTC.INTFLAGS = flags;
 
-  // With internal 32kHz oscillator and PER=32768, we get exactly 1 second
-  // interrupts Increment seconds directly
-  current_time.seconds++;
-  if (current_time.seconds >= 60) {
-    current_time.seconds = 0;
-    current_time.minutes++;
+  if (flags & RTC_OVF_bm) {
+    rtccal_rtc_overflow(); // Timestamp first
 
-    if (current_time.minutes >= 60) {
-      current_time.minutes = 0;
-      current_time.hours++;
+    // Count the second; wall time derives from it and the slew
+    timekeep_rtc_overflow();
+    PORTC.OUTTGL = PIN7_bm;
 
-      if (current_time.hours >= 24) {
-        current_time.hours = 0;
-      }
-    }
+    TRACE(TRACE_EV_RTC_CNT, rtc_interrupt_count);
+    event_post(EV_SECOND, 0);
   }
 
-  // Check for alarm match
-  if (alarm_set && current_time.hours == alarm_time.hours &&
-      current_time.minutes == alarm_time.minutes &&
-      current_time.seconds == alarm_time.seconds) {
-    alarm_triggered = true;
-  }
+  // Compare match, or a deadline in the second that just began
+  alarm_rtc_isr();
+  PERF_ISR_END(PERF_SITE_RTC_CNT);
 }
 
 // ********************************
 // USART Interrupt Service Routines
 // ********************************
 ISR(USART3_RXC_vect) {
+  PERF_ISR_BEGIN();
+  // Start-of-frame wakeup from standby shares this vector
+  USART3.STATUS = USART_RXSIF_bm;
+  if (!(USART3.STATUS & USART_RXCIF_bm)) {
+    PERF_ISR_END(PERF_SITE_USART3_RXC);
+    return;
+  }
+  if (USART3.RXDATAH & USART_BUFOVF_bm) {
+    irq_rx_overrun(); // A byte was lost before this one
+  }
   char receivedChar = USART3.RXDATAL;
+  TRACE(TRACE_EV_USART_RXC, receivedChar);
+  timesync_rx(receivedChar); // Line end: SYNC receive timestamp
   uart_rx_isr_handler(receivedChar);
+  event_post_once(EV_CONSOLE, 0); // One event covers a whole line
+  PERF_ISR_END(PERF_SITE_USART3_RXC);
 }
 
 ISR(USART3_DRE_vect) {
+  PERF_ISR_BEGIN();
   char data_to_send;
   if (uart_tx_isr_handler(&data_to_send)) {
+    USART3.STATUS = USART_TXCIF_bm; // Set again once this frame is out
     USART3.TXDATAL = data_to_send;
+    TRACE(TRACE_EV_USART_DRE, data_to_send);
   } else {
     USART3.CTRLA &= ~USART_DREIE_bm;
   }
+  PERF_ISR_END(PERF_SITE_USART3_DRE);
+}
+
+#ifdef AOS_KERNEL
+// ****************************************************************************
+// Kernel Tasks (make KERNEL=1)
+// ****************************************************************************
+
+// Sleeps until a pin edge, then samples every 10 ms while a button is
+// down; held for one second posts a press
+static void sample_task(void *arg) {
+  (void)arg;
+  while (1) {
+    ksem_wait(&button_sem, KERNEL_FOREVER);
+    uint8_t held = 0;
+    while (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
+      ktask_delay(KERNEL_MS(10));
+      if (++held >= 100) {
+        event_post(EV_BUTTON, 0);
+        held = 0;
+      }
+    }
+  }
 }
 
+// Runs the event handlers; blocks while the queue is empty
+static void console_task(void *arg) {
+  (void)arg;
+  while (1) {
+    ksem_wait(&event_sem, KERNEL_FOREVER);
+    event_dispatch();
+
+    // Received bytes whose event was dropped on a full queue
+    if (uart_rx_available() && !event_pending()) {
+      event_post_once(EV_CONSOLE, 0);
+    }
+  }
+}
+
+static void event_notify(void) { ksem_post(&event_sem); }
+
+// No task ready: the 1 ms kernel tick keeps TCB2 running, so only IDLE
+static void kernel_idle(void) {
+  loadmon_loop(false);
+  idle_sleep(false);
+}
+#endif
+
 // ****************************************************************************
 // Main Function
 // ****************************************************************************
@@ -202,34 +352,75 @@ int main(void) {
   uart_init(3, BAUD_RATE, F_CLK_PER, NULL);
   ui_set_system_info(F_CLK_PER, BAUD_RATE);
 
+  // RX preempts the other handlers; the rest take turns (see irq.h)
+  irq_set_high(USART3_RXC_vect_num);
+  irq_set_round_robin(true);
+
+  // WATCH sampler on TCB3 (idle until a capture is started)
+  watch_init(F_CLK_PER);
+
+  // TCB0 free-running cycle counter for PERF and the uptime clock
+  perf_init();
+  clock_init(F_CLK_PER);
+  loadmon_init(F_CLK_PER);
+
   // Initialize TCA0 timer for periodic tasks
   init_tca0();
+  swtimer_start(&status_timer, SWTIMER_MS(30000), SWTIMER_MS(30000));
 
   // Initialize RTC for timekeeping
   RTC_init();
+  timekeep_init();
+  alarm_init(alarm_due);
+
+  // Trim the RTC against the crystal (see include/rtccal.h)
+  rtccal_init(F_CLK_PER);
+  rtccal_start(RTCCAL_GATE_S, 0);
+
+  // Sleep between events (RTC counts the undivided 32.768 kHz clock)
+  idle_init(F_CLK_PER, 32768);
+
+  // Main loop work arrives as events (see include/event.h)
+  event_register(EV_CONSOLE, on_console);
+  event_register(EV_BUTTON, on_button);
+  event_register(EV_SECOND, on_second);
+  event_register(EV_ALARM, on_alarm);
+  event_register(EV_STATUS, on_status);
+#ifdef AOS_KERNEL
+  event_set_notify(event_notify);
+  ktask_create("sample", sample_task, NULL, 2, sample_stack,
+               sizeof(sample_stack));
+  ktask_create("console", console_task, NULL, 1, console_stack,
+               sizeof(console_stack));
+#else
+  idle_set_work_check(event_pending);
+#endif
 
   // Enable global interrupts
   sei();
 
   // Show welcome message
   ui_show_welcome();
-  // Main loop
+
+#ifdef AOS_KERNEL
+  kernel_start(F_CLK_PER, kernel_idle); // Does not return
+#endif
+
+  // Main loop: handle queued events in order, sleep when there are none
   while (1) {
-    // Process UART commands (non-blocking)
-    ui_process_commands();
-    if (button_pushed && !(PORTB.IN & PIN2_bm)) {
-      aos_printf("\r\nButton Pressed! Current Time: %02d:%02d:%02d\r\n",
-                 current_time.hours, current_time.minutes,
-                 current_time.seconds);
-      button_pushed = false; // Reset flag after handling
+    bool busy = event_dispatch() != 0;
+
+    // Received bytes whose event was dropped on a full queue
+    if (!busy && uart_rx_available()) {
+      event_post_once(EV_CONSOLE, 0);
+      busy = true;
     }
 
-    // Display periodic status
-    if (display_status_flag) {
-      display_status_flag = false;
-      aos_send("\r\n--- AOS Status Update ---\r\n");
-      ui_display_time();
-      aos_send("AOS> \r\n");
+    // Idle passes calibrate the load meter, busy ones count as load
+    loadmon_loop(busy);
+
+    if (!busy) {
+      idle_sleep(!watch_running() && !rtccal_measuring());
     }
   }
 
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+@file gen_regmap.py
+@author Arturo Salinas
+@date 2025-10-16
+@brief Generate the AOS flash-resident register map from ioavr128db48.h
+
+Scans the flat register definitions of the device header, e.g.
+
+    /* TCA0 - 16-bit Timer/Counter Type A */
+    #define TCA0_SINGLE_PER  _SFR_MEM16(0x0A26)
+
+and emits a C header holding three PROGMEM tables:
+- a string pool with every peripheral and register name,
+- a peripheral table sorted by name (name offset, first register, count),
+- a register table sorted by name inside each peripheral.
+
+Both tables are sorted with plain byte ordering so regmap.c can binary
+search them with strcmp_P().
+
+Usage: gen_regmap.py <ioavr128db48.h> <output.h>
+"""
+
+import re
+import sys
+
+# Must match REGMAP_NAME_MAX in include/regmap.h
+NAME_MAX = 23
+
+SECTION_RE = re.compile(r"^/\*\s+([A-Z][A-Z0-9]*)\s+-\s+")
+REGISTER_RE = re.compile(
+    r"^#define\s+([A-Z][A-Z0-9_]*)\s+_SFR_MEM(8|16|32)\((0x[0-9A-Fa-f]+)\)")
+
+
+def parse(path):
+    """Return {peripheral: {register: (address, width)}}."""
+    peripherals = {}
+    current = None
+    with open(path, encoding="latin-1") as header:
+        for line in header:
+            section = SECTION_RE.match(line)
+            if section:
+                current = section.group(1)
+                continue
+            reg = REGISTER_RE.match(line)
+            if not reg or current is None:
+                continue
+            macro, bits, addr = reg.groups()
+            if not macro.startswith(current + "_"):
+                continue
+            name = macro[len(current) + 1:]
+            if len(name) > NAME_MAX:
+                sys.exit("gen_regmap: %s is longer than %d characters" %
+                         (macro, NAME_MAX))
+            peripherals.setdefault(current, {})[name] = (int(addr, 16),
+                                                         int(bits) // 8)
+    return peripherals
+
+
+def emit(peripherals, out):
+    pool = bytearray()
+    offsets = {}
+
+    def intern(name):
+        if name not in offsets:
+            offsets[name] = len(pool)
+            pool.extend(name.encode("ascii") + b"\0")
+        return offsets[name]
+
+    periph_rows = []
+    reg_rows = []
+    for periph in sorted(peripherals):
+        regs = peripherals[periph]
+        if len(regs) > 255:
+            sys.exit("gen_regmap: %s has more than 255 registers" % periph)
+        periph_rows.append((intern(periph), len(reg_rows), len(regs), periph))
+        for name in sorted(regs):
+            addr, width = regs[name]
+            reg_rows.append((intern(name), addr, width, periph, name))
+
+    if len(pool) > 0xFFFF:
+        sys.exit("gen_regmap: string pool exceeds 64 KiB")
+
+    w = out.write
+    w("/* Generated by tools/gen_regmap.py - do not edit. */\n")
+    w("#ifndef REGMAP_DATA_H_\n#define REGMAP_DATA_H_\n\n")
+    w("#define REGMAP_PERIPH_COUNT %d\n" % len(periph_rows))
+    w("#define REGMAP_REG_COUNT %d\n\n" % len(reg_rows))
+
+    w("static const char regmap_strings[] PROGMEM =\n")
+    for name in pool.decode("ascii").split("\0")[:-1]:
+        w('    "%s\\0"\n' % name)
+    w("    ;\n\n")
+
+    w("static const regmap_periph_t regmap_periphs[REGMAP_PERIPH_COUNT] "
+      "PROGMEM = {\n")
+    for name_off, first, count, periph in periph_rows:
+        w("    {%d, %d, %d}, /* %s */\n" % (name_off, first, count, periph))
+    w("};\n\n")
+
+    w("static const regmap_reg_t regmap_regs[REGMAP_REG_COUNT] PROGMEM = {\n")
+    for name_off, addr, width, periph, name in reg_rows:
+        w("    {%d, 0x%04X, %d}, /* %s.%s */\n" %
+          (name_off, addr, width, periph, name.replace("_", ".")))
+    w("};\n\n#endif /* REGMAP_DATA_H_ */\n")
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.exit("usage: gen_regmap.py <ioavr128db48.h> <output.h>")
+    peripherals = parse(argv[1])
+    if not peripherals:
+        sys.exit("gen_regmap: no registers found in %s" % argv[1])
+    with open(argv[2], "w") as out:
+        emit(peripherals, out)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,242 @@
+/**
+ * @file timesync.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Set the AOS clock from the host clock (SYNC command)
+ *
+ * With the board on a serial port (and no terminal program holding it):
+ *
+ *     timesync /dev/ttyACM0                 one exchange
+ *     timesync -n 0 -i 64 /dev/ttyACM0      keep syncing every 64 s
+ *
+ * The first exchange usually steps the clock; later ones slew it and,
+ * 60 s or more apart, teach the board its frequency error (see
+ * include/timesync.h). Each exchange prints what the board measured.
+ *
+ * Exchange (times are seconds since 2000-01-01 UTC, "S.UUUUUU"):
+ *     -> "SYNC T1\r"
+ *     <- "SYNC T1 T2 T3\r\n"          (after the echo of the request)
+ *     -> "SYNC T1 T2 T3 T4\r"
+ *     <- "SYNC OK offset=<us> delay=<us> freq=<ppb> SLEW|STEP\r\n"
+ *
+ * The board stamps T2 when the request's '\r' arrives and T3 just before
+ * the reply starts, so at a real baud rate T1 is moved forward by the time
+ * the request takes on the wire and T4 back by the reply's. With -b 0 the
+ * port speed is left alone and nothing is moved, which is what a pty
+ * stand-in for the board wants (socat -d -d pty,raw,echo=0 ...).
+ *
+ * Build: make tools (host compiler), or cc -O2 -o timesync timesync.c
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// Unix time of 2000-01-01 00:00:00 UTC, the AOS epoch
+#define AOS_EPOCH 946684800LL
+
+// Reply timeout
+#define TIMEOUT_MS 2000
+
+// Microseconds since the AOS epoch
+static int64_t host_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return ((int64_t)ts.tv_sec - AOS_EPOCH) * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void format_time(char *buf, size_t len, int64_t us) {
+  snprintf(buf, len, "%lld.%06lld", (long long)(us / 1000000),
+           (long long)(us % 1000000));
+}
+
+static speed_t baud_constant(long baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 115200:
+    return B115200;
+  default:
+    return 0;
+  }
+}
+
+// Raw 8N1, optionally at a baud rate
+static int open_port(const char *path, long baud) {
+  int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "timesync: %s: %s\n", path, strerror(errno));
+    return -1;
+  }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    if (baud) {
+      cfsetispeed(&tio, baud_constant(baud));
+      cfsetospeed(&tio, baud_constant(baud));
+    }
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  tcflush(fd, TCIFLUSH);
+  return fd;
+}
+
+// Read one line without its "\r\n"; *at is the host time its end came in
+static int read_line(int fd, char *line, size_t len, int64_t *at) {
+  size_t n = 0;
+  int64_t deadline = host_now_us() + TIMEOUT_MS * 1000LL;
+  while (1) {
+    int64_t left = deadline - host_now_us();
+    if (left <= 0) {
+      return -1;
+    }
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(fd, &set);
+    struct timeval tv = {(time_t)(left / 1000000),
+                         (suseconds_t)(left % 1000000)};
+    if (select(fd + 1, &set, NULL, NULL, &tv) <= 0) {
+      continue;
+    }
+    char c;
+    if (read(fd, &c, 1) != 1) {
+      return -1;
+    }
+    if (c == '\n' || c == '\r') {
+      if (n == 0) {
+        continue; // Blank, or the '\n' of "\r\n"
+      }
+      *at = host_now_us();
+      line[n] = '\0';
+      return 0;
+    }
+    if (n < len - 1) {
+      line[n++] = c;
+    }
+  }
+}
+
+static int send_line(int fd, const char *line) {
+  size_t len = strlen(line);
+  return write(fd, line, len) == (ssize_t)len ? 0 : -1;
+}
+
+// Wait for a line starting with prefix; the echo and prompts go by
+static int expect(int fd, const char *prefix, char *line, size_t len,
+                  int64_t *at) {
+  while (read_line(fd, line, len, at) == 0) {
+    if (strncmp(line, prefix, strlen(prefix)) == 0) {
+      return 0;
+    }
+  }
+  return -1;
+}
+
+// One exchange; prints the board's result
+static int exchange(int fd, long baud) {
+  double char_us = baud ? 10e6 / baud : 0; // 8N1
+  char t1s[32], t4s[32], req[64], line[160], prefix[48], fin[160];
+  int64_t t1, t4;
+
+  t1 = host_now_us();
+  format_time(t1s, sizeof(t1s), t1);
+  snprintf(req, sizeof(req), "SYNC %s\r", t1s);
+  if (send_line(fd, req) < 0) {
+    perror("timesync: write");
+    return -1;
+  }
+
+  // "SYNC T1 T2 T3", not the echo "SYNC T1"
+  snprintf(prefix, sizeof(prefix), "SYNC %s ", t1s);
+  if (expect(fd, prefix, line, sizeof(line), &t4) < 0) {
+    fprintf(stderr, "timesync: no reply to SYNC\n");
+    return -1;
+  }
+  const char *t23 = line + strlen(prefix);
+
+  // Take the time on the wire out of both legs
+  t1 += (int64_t)(strlen(req) * char_us);
+  t4 -= (int64_t)((strlen(line) + 2) * char_us);
+  format_time(t1s, sizeof(t1s), t1);
+  format_time(t4s, sizeof(t4s), t4);
+  snprintf(fin, sizeof(fin), "SYNC %s %s %s\r", t1s, t23, t4s);
+  if (send_line(fd, fin) < 0) {
+    perror("timesync: write");
+    return -1;
+  }
+  if (expect(fd, "SYNC OK", line, sizeof(line), &t4) < 0) {
+    fprintf(stderr, "timesync: exchange not accepted\n");
+    return -1;
+  }
+  printf("%s\n", line + 5);
+  fflush(stdout);
+  return 0;
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: timesync [-b BAUD] [-i SECS] [-n COUNT] DEVICE\n"
+          "  -b  port speed, 0 for a pty (default 9600)\n"
+          "  -i  seconds between exchanges (default 64)\n"
+          "  -n  exchanges, 0 to run until stopped (default 1)\n");
+}
+
+int main(int argc, char **argv) {
+  long baud = 9600;
+  long interval = 64;
+  long count = 1;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:i:n:")) != -1) {
+    switch (opt) {
+    case 'b':
+      baud = strtol(optarg, NULL, 10);
+      break;
+    case 'i':
+      interval = strtol(optarg, NULL, 10);
+      break;
+    case 'n':
+      count = strtol(optarg, NULL, 10);
+      break;
+    default:
+      usage();
+      return 2;
+    }
+  }
+  if (optind != argc - 1 || interval < 1 || (baud && !baud_constant(baud))) {
+    usage();
+    return 2;
+  }
+
+  int fd = open_port(argv[optind], baud);
+  if (fd < 0) {
+    return 1;
+  }
+  int failed = 0;
+  for (long i = 0; count == 0 || i < count; i++) {
+    if (i > 0) {
+      sleep((unsigned)interval);
+    }
+    if (exchange(fd, baud) < 0) {
+      failed++;
+    }
+  }
+  close(fd);
+  return failed ? 1 : 0;
+}
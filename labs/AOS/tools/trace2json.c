@@ -0,0 +1,229 @@
+/**
+ * @file trace2json.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Convert an AOS TRACE dump into Chrome trace JSON
+ *
+ * Capture the console while typing TRACE (any terminal logger that keeps
+ * raw bytes works), then run
+ *
+ *     trace2json capture.log > trace.json
+ *
+ * and open trace.json in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Dump format (see include/trace.h):
+ *     "TRACE <count> <ns_per_tick>\r\n"
+ *     count x { uint16 time (LE), uint8 id, uint8 arg }
+ *     "\r\nEND\r\n"
+ *
+ * Timestamps are 16-bit and wrap; they are unwrapped assuming consecutive
+ * events are less than one wrap period apart (TCA0 ticks every 10 ms),
+ * except across a sleep: a WAKE record carries the whole wraps since the
+ * SLEEP before it, and records between the two (the ISR that woke the
+ * CPU) are placed back from WAKE. Sleeps show as spans on the main row.
+ *
+ * Build: make tools (host compiler), or cc -O2 -o trace2json trace2json.c
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Must match the TRACE_EV_* IDs in include/trace.h
+#define TRACE_EV_TCA0_OVF 0x01
+#define TRACE_EV_RTC_CNT 0x02
+#define TRACE_EV_USART_RXC 0x03
+#define TRACE_EV_USART_DRE 0x04
+#define TRACE_EV_CMD_BEGIN 0x10
+#define TRACE_EV_CMD_END 0x11
+#define TRACE_EV_BUTTON 0x12
+#define TRACE_EV_STATUS 0x13
+#define TRACE_EV_SLEEP 0x14
+#define TRACE_EV_WAKE 0x15
+
+// Timeline rows
+#define TID_MAIN 0
+#define TID_TCA0 1
+#define TID_RTC 2
+#define TID_USART 3
+
+typedef struct {
+  uint8_t id;
+  const char *name;
+  int tid;
+} event_info_t;
+
+static const event_info_t events[] = {
+    {TRACE_EV_TCA0_OVF, "TCA0_OVF", TID_TCA0},
+    {TRACE_EV_RTC_CNT, "RTC_CNT", TID_RTC},
+    {TRACE_EV_USART_RXC, "USART3_RXC", TID_USART},
+    {TRACE_EV_USART_DRE, "USART3_DRE", TID_USART},
+    {TRACE_EV_BUTTON, "Button", TID_MAIN},
+    {TRACE_EV_STATUS, "Status", TID_MAIN},
+};
+
+static const event_info_t *find_event(uint8_t id) {
+  for (size_t i = 0; i < sizeof(events) / sizeof(events[0]); i++) {
+    if (events[i].id == id) {
+      return &events[i];
+    }
+  }
+  return NULL;
+}
+
+// Locate "TRACE <count> <ns>\r\n" in the capture, return offset past it
+static long find_header(const uint8_t *buf, long len, unsigned *count,
+                        unsigned *tick_ns) {
+  for (long i = 0; i + 6 < len; i++) {
+    if (memcmp(&buf[i], "TRACE ", 6) != 0) {
+      continue;
+    }
+    char line[64];
+    long j = 0;
+    while (i + j < len && j < (long)sizeof(line) - 1 && buf[i + j] != '\n') {
+      line[j] = (char)buf[i + j];
+      j++;
+    }
+    line[j] = '\0';
+    if (i + j < len && sscanf(line, "TRACE %u %u", count, tick_ns) == 2) {
+      return i + j + 1;
+    }
+  }
+  return -1;
+}
+
+static void emit(FILE *out, int *first, const char *name, const char *ph,
+                 int tid, double ts_us, unsigned arg) {
+  fprintf(out, "%s\n  {\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,"
+               "\"pid\":1,\"tid\":%d",
+          *first ? "" : ",", name, ph, ts_us, tid);
+  if (ph[0] == 'i') {
+    fprintf(out, ",\"s\":\"t\"");
+  }
+  fprintf(out, ",\"args\":{\"arg\":%u}}", arg);
+  *first = 0;
+}
+
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  if (argc > 2) {
+    fprintf(stderr, "usage: %s [capture.log] > trace.json\n", argv[0]);
+    return 2;
+  }
+  if (argc == 2 && (in = fopen(argv[1], "rb")) == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  // Slurp the whole capture
+  size_t cap = 1 << 16, len = 0;
+  uint8_t *buf = malloc(cap);
+  size_t n;
+  while (buf && (n = fread(buf + len, 1, cap - len, in)) > 0) {
+    len += n;
+    if (len == cap) {
+      cap *= 2;
+      buf = realloc(buf, cap);
+    }
+  }
+  if (buf == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  unsigned count = 0, tick_ns = 0;
+  long pos = find_header(buf, (long)len, &count, &tick_ns);
+  if (pos < 0) {
+    fprintf(stderr, "no TRACE header found\n");
+    return 1;
+  }
+  if ((size_t)pos + (size_t)count * 4 > len) {
+    fprintf(stderr, "capture truncated: expected %u records\n", count);
+    return 1;
+  }
+
+  // Unwrap all timestamps first: a WAKE fixes the records before it
+  uint64_t *ticks = malloc((count ? count : 1) * sizeof(*ticks));
+  if (ticks == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+  long sleep = -1; // Index of the last SLEEP record
+  for (unsigned i = 0; i < count; i++) {
+    const uint8_t *rec = &buf[pos + i * 4];
+    uint16_t time = (uint16_t)(rec[0] | (rec[1] << 8));
+    uint8_t id = rec[2];
+    if (i == 0) {
+      ticks[i] = 0;
+    } else {
+      const uint8_t *last = &buf[pos + (i - 1) * 4];
+      ticks[i] = ticks[i - 1] + (uint16_t)(time - (last[0] | (last[1] << 8)));
+    }
+
+    if (id == TRACE_EV_SLEEP) {
+      sleep = (long)i;
+    } else if (id == TRACE_EV_WAKE && sleep >= 0) {
+      const uint8_t *s = &buf[pos + sleep * 4];
+      ticks[i] = ticks[sleep] + (uint16_t)(time - (s[0] | (s[1] << 8))) +
+                 ((uint64_t)rec[3] << 16);
+      for (unsigned j = (unsigned)sleep + 1; j < i; j++) {
+        const uint8_t *r = &buf[pos + j * 4];
+        ticks[j] = ticks[i] - (uint16_t)(time - (r[0] | (r[1] << 8)));
+      }
+      sleep = -1;
+    }
+  }
+
+  FILE *out = stdout;
+  int first = 1;
+
+  fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  static const char *rows[] = {"main", "TCA0", "RTC", "USART3"};
+  for (int t = 0; t < 4; t++) {
+    fprintf(out, "%s\n  {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            first ? "" : ",", t, rows[t]);
+    first = 0;
+  }
+  for (unsigned i = 0; i < count; i++) {
+    const uint8_t *rec = &buf[pos + i * 4];
+    uint8_t id = rec[2];
+    uint8_t arg = rec[3];
+    double ts_us = (double)ticks[i] * tick_ns / 1000.0;
+
+    if (id == TRACE_EV_SLEEP || id == TRACE_EV_WAKE) {
+      const char *name = (id == TRACE_EV_WAKE) ? "Wake"
+                         : arg                    ? "Standby"
+                                                  : "Idle";
+      emit(out, &first, name, id == TRACE_EV_SLEEP ? "B" : "E", TID_MAIN,
+           ts_us, arg);
+      continue;
+    }
+
+    if (id == TRACE_EV_CMD_BEGIN || id == TRACE_EV_CMD_END) {
+      char name[24];
+      snprintf(name, sizeof(name), "CMD %u", arg);
+      emit(out, &first, name, id == TRACE_EV_CMD_BEGIN ? "B" : "E", TID_MAIN,
+           ts_us, arg);
+      continue;
+    }
+
+    const event_info_t *ev = find_event(id);
+    if (ev != NULL) {
+      emit(out, &first, ev->name, "i", ev->tid, ts_us, arg);
+    } else {
+      char name[24];
+      snprintf(name, sizeof(name), "EV 0x%02X", id);
+      emit(out, &first, name, "i", TID_MAIN, ts_us, arg);
+    }
+  }
+  fprintf(out, "\n]}\n");
+
+  free(ticks);
+  free(buf);
+  if (in != stdin) {
+    fclose(in);
+  }
+  return 0;
+}
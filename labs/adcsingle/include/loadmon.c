@@ -0,0 +1,142 @@
+/**
+ * @file loadmon.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief CPU load and main-loop jitter meter
+ */
+
+#include "loadmon.h"
+#include "perf.h"
+#include <string.h>
+
+//================================
+// Internal State
+//================================
+static uint32_t cycles_per_us = 16;
+static uint32_t window_length = 16000000UL;
+static uint32_t last_pass = 0;
+
+// Sleep reported since the last pass
+static uint32_t pass_sleep = 0;   // Seen by the cycle counter
+static uint32_t pass_stopped = 0; // Counter was stopped
+
+// Current window
+static uint32_t window_total = 0;
+static uint32_t window_idle_passes = 0;
+static uint32_t window_idle_time = 0;
+static uint32_t window_sleep = 0;
+
+static loadmon_stats_t stats;
+
+//================================
+// Internal Helpers
+//================================
+
+static uint8_t bucket_of(uint32_t us) {
+  uint8_t bucket = 0;
+  uint32_t limit = 16;
+  while (bucket < LOADMON_BUCKETS - 1 && us >= limit) {
+    limit <<= 2;
+    bucket++;
+  }
+  return bucket;
+}
+
+// Close the window: idle = passes x baseline + sleep, ISR = idle excess
+static void publish_window(void) {
+  uint32_t idle = window_idle_passes * stats.baseline_cycles;
+  if (window_sleep > window_total) {
+    window_sleep = window_total;
+  }
+  uint32_t awake = window_total - window_sleep;
+  if (idle > awake) {
+    idle = awake;
+  }
+  uint32_t per_mille = window_total / 1000;
+  stats.cpu_permille = (uint16_t)((awake - idle) / per_mille);
+  stats.sleep_permille = (uint16_t)(window_sleep / per_mille);
+
+  if (window_idle_time >= 1000) {
+    uint32_t excess = window_idle_time - idle;
+    stats.isr_permille = (uint16_t)(excess / (window_idle_time / 1000));
+  } else {
+    stats.isr_permille = 0; // Fully loaded, nothing to measure against
+  }
+
+  window_total = 0;
+  window_idle_passes = 0;
+  window_idle_time = 0;
+  window_sleep = 0;
+}
+
+//================================
+// Public Interface
+//================================
+
+void loadmon_init(uint32_t f_cpu_hz) {
+  cycles_per_us = f_cpu_hz / 1000000UL;
+  window_length = f_cpu_hz; // One second
+  memset(&stats, 0, sizeof(stats));
+  stats.baseline_cycles = 0xFFFF;
+  last_pass = perf_now();
+}
+
+void loadmon_loop(bool busy) {
+  uint32_t now = perf_now();
+  uint32_t dt = now - last_pass;
+  last_pass = now;
+
+  // Pass time without sleep; the counter never saw stopped time
+  if (pass_sleep > dt) {
+    pass_sleep = dt;
+  }
+  window_total += pass_sleep + pass_stopped;
+  window_sleep += pass_sleep + pass_stopped;
+  dt -= pass_sleep;
+  pass_sleep = 0;
+  pass_stopped = 0;
+
+  if (!busy) {
+    if (dt < stats.baseline_cycles) {
+      stats.baseline_cycles = (uint16_t)dt;
+    }
+    window_idle_passes++;
+    window_idle_time += dt;
+  }
+  window_total += dt;
+
+  uint32_t us = dt / cycles_per_us;
+  if (us > stats.worst_us) {
+    stats.worst_us = us;
+  }
+  uint16_t *slot = &stats.hist[bucket_of(us)];
+  if (*slot != 0xFFFF) {
+    (*slot)++;
+  }
+
+  if (window_total >= window_length) {
+    publish_window();
+  }
+}
+
+void loadmon_sleep(uint32_t cycles, bool clock_stopped) {
+  if (clock_stopped) {
+    pass_stopped += cycles;
+  } else {
+    pass_sleep += cycles;
+  }
+}
+
+void loadmon_get(loadmon_stats_t *out) { *out = stats; }
+
+uint32_t loadmon_bucket_limit_us(uint8_t bucket) {
+  if (bucket >= LOADMON_BUCKETS - 1) {
+    return 0;
+  }
+  return 16UL << (2 * bucket);
+}
+
+void loadmon_reset(void) {
+  stats.worst_us = 0;
+  memset(stats.hist, 0, sizeof(stats.hist));
+}
@@ -0,0 +1,124 @@
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+/**
+ * @file swtimer.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Software timer wheel driven by the TCA0 10 ms tick
+ *
+ * Timers are caller-owned structs, usually static and built with
+ * SWTIMER_INIT(). Each active timer sits in the wheel slot of its expiry
+ * tick, so start and stop are O(1) list operations and a tick only looks
+ * at the timers hashed into the current slot.
+ *
+ * Callbacks run either directly in the tick ISR (SWTIMER_ISR: keep them
+ * short) or later from swtimer_process() in the main loop with interrupts
+ * enabled (SWTIMER_DEFERRED). A deferred timer that fires again before the
+ * main loop ran it is coalesced into one call. swtimer_defer() queues the
+ * same call from any ISR, which makes a deferred timer an ISR bottom half.
+ *
+ * All functions except swtimer_tick() may be called from ISRs and from
+ * the main loop.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Tick period in milliseconds (TCA0 overflow) */
+#define SWTIMER_TICK_MS 10
+
+/** @brief Wheel slots (power of two) */
+#define SWTIMER_WHEEL_SIZE 32
+
+/** @brief swtimer_next_due() result when no timer is armed */
+#define SWTIMER_NEVER 0xFFFF
+
+/** @brief Convert milliseconds to ticks */
+#define SWTIMER_MS(ms) ((uint16_t)((ms) / SWTIMER_TICK_MS))
+
+//================================
+// Timer Flags
+//================================
+#define SWTIMER_ISR 0x00      ///< Run callback in the tick ISR
+#define SWTIMER_DEFERRED 0x01 ///< Run callback from swtimer_process()
+#define SWTIMER_ACTIVE 0x02   ///< Internal: linked into the wheel
+#define SWTIMER_PENDING 0x04  ///< Internal: deferred call requested
+#define SWTIMER_QUEUED 0x08   ///< Internal: on the deferred list
+
+typedef void (*swtimer_cb_t)(void *ctx);
+
+/**
+ * @brief Software timer (treat fields as private)
+ */
+typedef struct swtimer {
+  struct swtimer *next;
+  struct swtimer *prev;
+  struct swtimer *deferred_next;
+  uint16_t expires; ///< Absolute tick of the next expiry
+  uint16_t period;  ///< Reload in ticks, 0 = one-shot
+  swtimer_cb_t callback;
+  void *ctx;
+  uint8_t flags;
+} swtimer_t;
+
+/** @brief Static initializer: SWTIMER_INIT(callback, ctx, SWTIMER_ISR) */
+#define SWTIMER_INIT(cb, context, mode)                                      \
+  { NULL, NULL, NULL, 0, 0, (cb), (context), (mode) }
+
+/**
+ * @brief Start (or restart) a timer
+ * @param timer Timer to arm
+ * @param delay Ticks until the first expiry (0 is treated as 1)
+ * @param period Reload in ticks for periodic timers, 0 for one-shot
+ */
+void swtimer_start(swtimer_t *timer, uint16_t delay, uint16_t period);
+
+/**
+ * @brief Stop a timer and cancel a pending deferred call
+ */
+void swtimer_stop(swtimer_t *timer);
+
+/**
+ * @brief Check if a timer is armed
+ */
+bool swtimer_active(const swtimer_t *timer);
+
+/**
+ * @brief Queue a deferred timer's callback now, as if it had expired
+ *
+ * The timer must be SWTIMER_DEFERRED and need not be started. A call
+ * still waiting absorbs this one, so the callback must work out from its
+ * own state how much happened rather than assume one call per request.
+ */
+void swtimer_defer(swtimer_t *timer);
+
+/**
+ * @brief Advance the wheel by one tick (call from ISR(TCA0_OVF_vect))
+ */
+void swtimer_tick(void);
+
+/**
+ * @brief Run deferred callbacks (call from the main loop)
+ * @return Number of callbacks run
+ */
+uint8_t swtimer_process(void);
+
+/**
+ * @brief Ticks until the earliest armed timer expires
+ * @return 1 if one expires on the next tick, SWTIMER_NEVER if none is armed
+ */
+uint16_t swtimer_next_due(void);
+
+/**
+ * @brief Check if deferred callbacks are waiting for swtimer_process()
+ */
+bool swtimer_deferred_pending(void);
+
+/**
+ * @brief Current tick count (wraps every 65536 ticks)
+ */
+uint16_t swtimer_now(void);
+
+#endif /* SWTIMER_H_ */
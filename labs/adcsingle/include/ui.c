@@ -14,6 +14,8 @@
 
 #include "ui.h"
 #include "circularbuff.h"
+#include "idle.h"
+#include "loadmon.h"
 #include "uart.h"
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
@@ -217,7 +219,7 @@ static const command_t commands[] = {
     // System Commands
     {"HELP", cmd_help, "HELP                    - Show all commands"},
     {"SYSINFO", cmd_sysinfo,
-     "SYSINFO                 - Show system information"},
+     "SYSINFO [RESET]         - System info, CPU load, loop times"},
     {"RESET", cmd_reset, "RESET                   - Software reset"},
 
     // Register and Memory Commands
@@ -256,12 +258,15 @@ void ui_init(void) {
   current_cmd_index = 0;
 }
 
-void ui_process_commands(void) {
+bool ui_process_commands(void) {
+  bool busy = uart_rx_available() || !circular_buf_empty(cmd_line_buffer);
+
   // Collect any new input from UART
   collect_uart_input();
 
   // Execute any queued commands
   execute_next_command();
+  return busy;
 }
 
 void ui_show_welcome(void) {
@@ -458,7 +463,12 @@ static void cmd_help(const char *params) {
 }
 
 static void cmd_sysinfo(const char *params) {
-  (void)params;
+  if (params != NULL && strcasecmp(params, "RESET") == 0) {
+    loadmon_reset();
+    idle_reset();
+    aos_send("Loop statistics cleared\r\n\r\n");
+    return;
+  }
   aos_send("\r\nSYSTEM INFORMATION\r\n");
   aos_send("-----------------------------------------------------------\r\n");
   if (aos_f_cpu_hz) {
@@ -486,6 +496,33 @@ static void cmd_sysinfo(const char *params) {
   aos_printf("Command Buffer: %u/%u used\r\n",
              (unsigned)circular_buf_size(cmd_line_buffer),
              (unsigned)CMD_BUFFER_SIZE);
+
+  // Load and main-loop jitter (SYSINFO RESET clears the histogram)
+  loadmon_stats_t load;
+  loadmon_get(&load);
+  aos_printf("CPU Load: %u.%u%%                ISR Share: %u.%u%%\r\n",
+             load.cpu_permille / 10, load.cpu_permille % 10,
+             load.isr_permille / 10, load.isr_permille % 10);
+  aos_printf("Worst Loop: %lu us           Idle Pass: %u cycles\r\n",
+             (unsigned long)load.worst_us, load.baseline_cycles);
+  idle_stats_t sleep;
+  idle_get_stats(&sleep);
+  aos_printf("Asleep: %u.%u%%  Idle: %lu  Standby: %lu  Ticks Skipped: "
+             "%lu\r\n",
+             load.sleep_permille / 10, load.sleep_permille % 10,
+             (unsigned long)sleep.idle_sleeps,
+             (unsigned long)sleep.standby_sleeps,
+             (unsigned long)sleep.ticks_skipped);
+  aos_send("Loop Time Histogram:\r\n");
+  for (uint8_t i = 0; i < LOADMON_BUCKETS; i++) {
+    uint32_t limit = loadmon_bucket_limit_us(i);
+    if (limit) {
+      aos_printf("  < %6lu us: %u\r\n", (unsigned long)limit, load.hist[i]);
+    } else {
+      aos_printf("  >=%6lu us: %u\r\n",
+                 (unsigned long)loadmon_bucket_limit_us(i - 1), load.hist[i]);
+    }
+  }
   aos_send(
       "-----------------------------------------------------------\r\n\r\n");
 }
@@ -63,8 +63,10 @@ void ui_init(void);
  * This function should be called regularly from the main loop.
  * It collects input from UART, builds command lines, and executes
  * any complete commands that have been received.
+ *
+ * @return true if there was input or a queued command to handle
  */
-void ui_process_commands(void);
+bool ui_process_commands(void);
 
 /**
  * @brief Display Arturo's OS boot message and help
@@ -7,6 +7,10 @@
 #define F_CPU 16000000UL // 16 MHz clock speed
 #define __AVR_AVR128DB48__
 #include "include/cpu.h"
+#include "include/idle.h"
+#include "include/loadmon.h"
+#include "include/perf.h"
+#include "include/swtimer.h"
 #include "include/uart.h"
 #include "include/ui.h"
 #include <avr/cpufunc.h>
@@ -28,14 +32,18 @@ volatile bool alarm_triggered = false;
 volatile uint32_t rtc_interrupt_count = 0;
 
 // Global variable for button pushing
-volatile uint16_t button_counter = 0;
 volatile bool button_pushed = false;
 
-// Timer-based counters
-volatile uint16_t tca_tick_counter = 0;
-volatile uint16_t led_blink_counter = 0;
-volatile uint16_t status_display_counter = 0;
-volatile bool display_status_flag = false;
+// Periodic activities on the TCA0 tick (see include/swtimer.h)
+static void button_sample(void *ctx);
+static void alarm_blink(void *ctx);
+static void show_status(void *ctx);
+
+static swtimer_t button_timer = SWTIMER_INIT(button_sample, NULL, SWTIMER_ISR);
+static swtimer_t alarm_blink_timer =
+    SWTIMER_INIT(alarm_blink, NULL, SWTIMER_ISR);
+static swtimer_t status_timer =
+    SWTIMER_INIT(show_status, NULL, SWTIMER_DEFERRED);
 
 //********************************
 // LED Initialization
@@ -53,10 +61,18 @@ void init_led() {
 // Button Initialization
 // ********************************
 void init_button() {
-  PORTB.DIRCLR = PIN2_bm;            // Onboard button - input
-  PORTB.PIN2CTRL = PORT_PULLUPEN_bm; // Enable pull-up only
-  PORTB.DIRCLR = PIN5_bm;            // External button - input
-  PORTB.PIN5CTRL = PORT_PULLUPEN_bm; // Enable pull-up only
+  PORTB.DIRCLR = PIN2_bm; // Onboard button - input
+  PORTB.PIN2CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc; // Wakes sleep
+  PORTB.DIRCLR = PIN5_bm; // External button - input
+  PORTB.PIN5CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
+}
+
+// A button edge starts sampling; nothing polls while they are released
+ISR(PORTB_PORT_vect) {
+  PORTB.INTFLAGS = PIN2_bm | PIN5_bm;
+  if (!swtimer_active(&button_timer)) {
+    swtimer_start(&button_timer, 1, 1);
+  }
 }
 
 //************************************************
@@ -77,41 +93,47 @@ ISR(TCA0_OVF_vect) {
   // Clear interrupt flag
   TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
 
-  if (button_counter < 65535) {
-    if (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
-      button_counter++;
+  idle_tick(); // One or more ticks, see include/idle.h
+}
+
+//*****************************************************************************
+// Software Timer Callbacks
+//*****************************************************************************
+
+// Every tick while a button is down: held for 100 ticks (1 s) counts as a
+// press; stops on release until the next pin edge
+static void button_sample(void *ctx) {
+  static uint8_t held = 0;
+  (void)ctx;
+  if (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
+    if (++held >= 100) {
+      button_pushed = true;
+      held = 0;
     }
   } else {
-    button_counter = 0;
+    swtimer_stop(&button_timer);
   }
-  if (button_counter >= 100) {
-    button_pushed = true;
-    button_counter = 0;
-  }
-
-  // Increment 10ms tick counter
-  tca_tick_counter++;
+}
 
-  // Handle LED blinking for alarm (every 50 ticks = 500ms)
+// Every 500 ms while the alarm rings; stops itself once it is cleared
+static void alarm_blink(void *ctx) {
+  (void)ctx;
   if (alarm_triggered) {
-    led_blink_counter++;
-    if (led_blink_counter >= 50) { // 500ms
-      led_blink_counter = 0;
-      PORTB.OUTTGL = PIN3_bm;
-    }
+    PORTB.OUTTGL = PIN3_bm;
   } else {
-    led_blink_counter = 0;
-    PORTB.OUTSET = PIN3_bm; // Turn off LEDs when no alarm
+    PORTB.OUTSET = PIN3_bm; // LED off
+    swtimer_stop(&alarm_blink_timer);
   }
+}
 
-  // Handle periodic status display (every 3000 ticks = 30 seconds)
-  status_display_counter++;
-  if (status_display_counter >= 3000) { // 30 seconds
-    status_display_counter = 0;
-    // Set flag for main loop to display status
-    display_status_flag = true;
-  }
+// Every 30 s, from the main loop
+static void show_status(void *ctx) {
+  (void)ctx;
+  aos_send("\r\n--- AOS Status Update ---\r\n");
+  ui_display_time();
+  aos_send("AOS> \r\n");
 }
+
 //*****************************************************************************
 // ADC Initialization
 //*****************************************************************************
@@ -144,8 +166,8 @@ void RTC_init(void) {
   // 3. Enable overflow interrupt
   RTC.INTCTRL = RTC_OVF_bm;
 
-  // 4. Enable RTC with no prescaler
-  RTC.CTRLA = RTC_RTCEN_bm | RTC_PRESCALER_DIV1_gc;
+  // 4. Enable RTC with no prescaler, also counting in standby sleep
+  RTC.CTRLA = RTC_RTCEN_bm | RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm;
 
   // 5. Global interrupts will be enabled in main()
 }
@@ -183,6 +205,7 @@ ISR(RTC_CNT_vect) {
       current_time.minutes == alarm_time.minutes &&
       current_time.seconds == alarm_time.seconds) {
     alarm_triggered = true;
+    swtimer_start(&alarm_blink_timer, SWTIMER_MS(500), SWTIMER_MS(500));
   }
 }
 
@@ -190,6 +213,11 @@ ISR(RTC_CNT_vect) {
 // USART Interrupt Service Routines
 // ********************************
 ISR(USART3_RXC_vect) {
+  // Start-of-frame wakeup from standby shares this vector
+  USART3.STATUS = USART_RXSIF_bm;
+  if (!(USART3.STATUS & USART_RXCIF_bm)) {
+    return;
+  }
   char receivedChar = USART3.RXDATAL;
   uart_rx_isr_handler(receivedChar);
 }
@@ -197,6 +225,7 @@ ISR(USART3_RXC_vect) {
 ISR(USART3_DRE_vect) {
   char data_to_send;
   if (uart_tx_isr_handler(&data_to_send)) {
+    USART3.STATUS = USART_TXCIF_bm; // Set again once this frame is out
     USART3.TXDATAL = data_to_send;
   } else {
     USART3.CTRLA &= ~USART_DREIE_bm;
@@ -223,10 +252,18 @@ int main(void) {
 
   // Initialize TCA0 timer for periodic tasks
   init_tca0();
+  swtimer_start(&status_timer, SWTIMER_MS(30000), SWTIMER_MS(30000));
 
   // Initialize RTC for timekeeping
   RTC_init();
 
+  // Sleep between events (RTC counts the undivided 32.768 kHz clock)
+  idle_init(F_CLK_PER, 32768);
+
+  // TCB0 cycle counter for the CPU load meter
+  perf_init();
+  loadmon_init(F_CLK_PER);
+
   // Enable global interrupts
   sei();
 
@@ -235,20 +272,26 @@ int main(void) {
   // Main loop
   while (1) {
     // Process UART commands (non-blocking)
-    ui_process_commands();
+    bool busy = ui_process_commands();
     if (button_pushed && !(PORTB.IN & PIN2_bm)) {
       aos_printf("\r\nButton Pressed! Current Time: %02d:%02d:%02d\r\n",
                  current_time.hours, current_time.minutes,
                  current_time.seconds);
       button_pushed = false; // Reset flag after handling
+      busy = true;
     }
 
-    // Display periodic status
-    if (display_status_flag) {
-      display_status_flag = false;
-      aos_send("\r\n--- AOS Status Update ---\r\n");
-      ui_display_time();
-      aos_send("AOS> \r\n");
+    // Deferred software timer callbacks (periodic status)
+    if (swtimer_process()) {
+      busy = true;
+    }
+
+    // Idle passes calibrate the load meter, busy ones count as load
+    loadmon_loop(busy);
+
+    // Nothing left to do: sleep until the next interrupt or timer
+    if (!busy) {
+      idle_sleep(true);
     }
   }
 
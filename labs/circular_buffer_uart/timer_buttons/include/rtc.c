@@ -130,7 +130,7 @@ void RTC_SetPITIsrCallback(RTC_cb_t cb) { RTC_PIT_isr_cb = cb; }
  * Handles both overflow and compare match interrupts, calling the appropriate
  * callback functions if they have been registered.
  */
-ISR(RTC_CNT_vect) {
+ISR(RTC_CNT_vect, __attribute__((weak))) { // RTC_BIND_CNT_ISR() replaces it
   if (RTC.INTFLAGS & RTC_OVF_bm) {
     if (RTC_OVF_isr_cb != NULL) {
       (*RTC_OVF_isr_cb)();
@@ -151,7 +151,7 @@ ISR(RTC_CNT_vect) {
  * 
  * Handles PIT interrupts, calling the registered callback function if available.
  */
-ISR(RTC_PIT_vect) {
+ISR(RTC_PIT_vect, __attribute__((weak))) { // RTC_BIND_PIT_ISR() replaces it
   if (RTC_PIT_isr_cb != NULL) {
     (*RTC_PIT_isr_cb)();
   }
@@ -20,6 +20,7 @@
  * - Event system integration
  * - Runtime reconfiguration
  * - Comprehensive register access
+ * - Both instances, TCA0 and TCA1, from one source (tca_impl.h)
  * 
  * @version TCA0 Enhanced Driver Version 3.0.0
  */
@@ -29,14 +30,35 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+// Without the device headers only the calculation helpers below are
+// usable; the host tests in tools/ build them that way
+#ifdef __AVR__
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#endif
 
 #include "timer_interface.h"
 
 /**
  * @brief Function pointer to callback functions for TCA interrupts
  */  
-typedef void (*TCA0_cb_t)(void);
+typedef void (*TCA_cb_t)(void);
+typedef TCA_cb_t TCA0_cb_t;      ///< TCA0 callbacks
+typedef TCA_cb_t TCA1_cb_t;      ///< TCA1 callbacks
+
+/// @cond
+#define TCA_CAT_(a, b, c, d) a##b##c##d
+#define TCA_CAT(a, b, c, d) TCA_CAT_(a, b, c, d)
+/// @endcond
+
+/// Name of a driver function for instance TCA_N: TCA_FN(Start) is TCA0_Start
+#define TCA_FN(name) TCA_CAT(TCA, TCA_N, _, name)
+
+/// Interrupt vector for instance TCA_N: TCA_VECT(OVF) is TCA0_OVF_vect
+#define TCA_VECT(name) TCA_CAT(TCA, TCA_N, _, name##_vect)
+
+/// Registers of instance TCA_N (TCA0 or TCA1 from avr/io.h)
+#define TCA_REG TCA_CAT(TCA, TCA_N, , )
 
 /**
  * @brief TCA clock source configuration
@@ -106,6 +128,24 @@ typedef enum {
     TCA_CMP_CHANNEL2 = 2          ///< Compare channel 2
 } TCA_CmpChannel_t;
 
+/**
+ * @brief TCA split-mode channels (waveform outputs WO0-WO5)
+ */
+typedef enum {
+    TCA_SPLIT_CHANNEL_LCMP0 = 0,  ///< Low counter, compare 0 (WO0)
+    TCA_SPLIT_CHANNEL_LCMP1 = 1,  ///< Low counter, compare 1 (WO1)
+    TCA_SPLIT_CHANNEL_LCMP2 = 2,  ///< Low counter, compare 2 (WO2)
+    TCA_SPLIT_CHANNEL_HCMP0 = 3,  ///< High counter, compare 0 (WO3)
+    TCA_SPLIT_CHANNEL_HCMP1 = 4,  ///< High counter, compare 1 (WO4)
+    TCA_SPLIT_CHANNEL_HCMP2 = 5   ///< High counter, compare 2 (WO5)
+} TCA_SplitChannel_t;
+
+/// Channel mask bit for TCA0_InitializeSplit() and TCA1_InitializeSplit()
+#define TCA_SPLIT_CHANNEL_bm(channel) (1u << (channel))
+
+/// All six split-mode outputs
+#define TCA_SPLIT_ALL_CHANNELS 0x3F
+
 /**
  * @brief TCA configuration structure for maximum flexibility
  */
@@ -128,506 +168,237 @@ typedef struct {
     bool countOnEventB;           ///< Enable counting on event B
 } TCA_Config_t;    
 
-extern const struct TMR_INTERFACE TCA0_Interface;
-
-// =============================================================================
-// ENHANCED INITIALIZATION AND CONFIGURATION FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Initialize TCA0 with default configuration (Normal mode, DIV4 prescaler)
- * 
- * This function provides a simple initialization with sensible defaults:
- * - Normal mode operation
- * - System clock / 4 prescaler
- * - 16-bit period (0xFFFF)
- * - All compare channels disabled
- * - No interrupts enabled
- * 
- * @param None
- * @return None
- */
-void TCA0_Initialize(void);
-
-/**
- * @brief Initialize TCA0 with comprehensive configuration
- * 
- * This function allows complete customization of all TCA0 parameters
- * in a single call, providing maximum flexibility.
- * 
- * @param config Pointer to TCA_Config_t structure with all parameters
- * @return None
- */
-void TCA0_InitializeAdvanced(const TCA_Config_t *config);
-
-/**
- * @brief Initialize TCA0 for PWM generation with specified parameters
- * 
- * Configures TCA0 for single-slope PWM generation with the specified
- * frequency and initial duty cycles.
- * 
- * @param frequency_hz Desired PWM frequency in Hz
- * @param duty0_percent Initial duty cycle for channel 0 (0-100%)
- * @param duty1_percent Initial duty cycle for channel 1 (0-100%)
- * @param duty2_percent Initial duty cycle for channel 2 (0-100%)
- * @return true if configuration successful, false if frequency too high/low
- */
-bool TCA0_InitializePWM(uint32_t frequency_hz, uint8_t duty0_percent, 
-                       uint8_t duty1_percent, uint8_t duty2_percent);
-
-/**
- * @brief Initialize TCA0 for frequency generation
- * 
- * @param frequency_hz Target frequency in Hz
- * @param channel Compare channel to use (0, 1, or 2)
- * @return true if successful, false if frequency cannot be achieved
- */
-bool TCA0_InitializeFrequencyGenerator(uint32_t frequency_hz, TCA_CmpChannel_t channel);
-
-// =============================================================================
-// BASIC TIMER CONTROL FUNCTIONS
-// =============================================================================
-
 /**
- * @brief Start the TCA0 timer
- * @param None
- * @return None
+ * @brief Prescaler and period for a target frequency
  */
-void TCA0_Start(void);
-
-/**
- * @brief Stop the TCA0 timer
- * @param None
- * @return None
- */
-void TCA0_Stop(void);
-
-/**
- * @brief Reset TCA0 to default state
- * 
- * Stops the timer, clears all registers, and resets configuration
- * to power-on defaults.
- * 
- * @param None
- * @return None
- */
-void TCA0_Reset(void);
+typedef struct {
+    TCA_ClkSel_t prescaler;       ///< Clock source selection
+    uint16_t period;              ///< PER value (counts per period - 1)
+    uint32_t achievedHz;          ///< Resulting frequency, rounded to 1 Hz
+    int32_t errorPpm;             ///< (achieved - target) / target, in ppm
+} TCA_Timing_t;
 
 /**
- * @brief Check if TCA0 is enabled and running
- * @param None
- * @retval true Timer is enabled and running
- * @retval false Timer is stopped
+ * @brief Search state for TCA_CalculateTiming() (internal)
  */
-bool TCA0_IsEnabled(void);
+typedef struct {
+    uint8_t index;                ///< Best prescaler index, 0xFF if none
+    uint32_t counts;              ///< Its PER + 1
+    uint32_t ticks;               ///< Its clock cycles per period
+    uint32_t error;               ///< |clk - frequency * ticks|
+} TCA_TimingSearch_t;
 
 // =============================================================================
-// COUNTER AND PERIOD FUNCTIONS
+// UTILITY AND CALCULATION FUNCTIONS
 // =============================================================================
 
 /**
- * @brief Write counter value
- * @param timerVal Counter value to write
- * @return None
- */
-void TCA0_Write(uint16_t timerVal);
-
-/**
- * @brief Read current counter value
- * @param None
- * @return Current counter value
- */
-uint16_t TCA0_Read(void);
-
-/**
- * @brief Set the timer period
- * @param period New period value
- * @return None
- */
-void TCA0_SetPeriod(uint16_t period);
-
-/**
- * @brief Get the current timer period
- * @param None
- * @return Current period value
- */
-uint16_t TCA0_GetPeriod(void);
-
-/**
- * @brief Set timer frequency by calculating appropriate period and prescaler
+ * @brief Try one period in TCA_CalculateTiming() (internal)
+ *
+ * Candidates are compared by cross-multiplying, without dividing.
+ */
+static inline __attribute__((always_inline))
+void TCA_TryCounts(uint8_t index, uint8_t shift, uint32_t counts,
+                   uint32_t clk_hz, uint32_t frequency_hz,
+                   TCA_TimingSearch_t *best)
+{
+    if (counts < 2 || counts > 0x10000UL) {
+        return; // PER must be 1..65535
+    }
+    uint32_t ticks = counts << shift;
+    uint32_t actual = frequency_hz * ticks; // At most clk_hz * 2
+    uint32_t error = (actual > clk_hz) ? actual - clk_hz : clk_hz - actual;
+
+    // Frequency error is error / ticks; on a tie the smaller prescaler,
+    // tried first, keeps the finer duty-cycle resolution
+    if (best->index == 0xFF ||
+        (uint64_t)error * best->ticks < (uint64_t)best->error * ticks) {
+        best->index = index;
+        best->counts = counts;
+        best->ticks = ticks;
+        best->error = error;
+    }
+}
+
+/**
+ * @brief Try one prescaler in TCA_CalculateTiming() (internal)
+ *
+ * Every prescaler is a power of two, 2^shift. The best period is one of
+ * the two either side of clk / (frequency * 2^shift), and the lower one
+ * comes from the quotient q = clk / frequency by a shift:
+ * floor((q + r / frequency) / 2^shift) == q >> shift.
+ */
+static inline __attribute__((always_inline))
+void TCA_TryPrescaler(uint8_t index, uint8_t shift, uint32_t clk_hz,
+                      uint32_t frequency_hz, uint32_t q,
+                      TCA_TimingSearch_t *best)
+{
+    uint32_t counts = q >> shift;
+    TCA_TryCounts(index, shift, counts, clk_hz, frequency_hz, best);
+    TCA_TryCounts(index, shift, counts + 1, clk_hz, frequency_hz, best);
+}
+
+/**
+ * @brief Find the prescaler and period closest to a frequency
+ *
+ * Tries all eight prescalers and keeps the one with the smallest absolute
+ * frequency error, using a single 32-bit division. With constant
+ * arguments, e.g. TCA_CalculateTiming(F_CPU, 1000, &t), the compiler
+ * evaluates it completely and only the results are stored; otherwise call
+ * TCA0_CalculateTiming() rather than inlining a copy at every call site.
+ *
+ * @param clk_hz Peripheral clock in Hz
  * @param frequency_hz Desired frequency in Hz
- * @return true if successful, false if frequency cannot be achieved
- */
-bool TCA0_SetFrequency(uint32_t frequency_hz);
-
-/**
- * @brief Get current timer frequency
- * @param None
- * @return Current frequency in Hz
- */
-uint32_t TCA0_GetFrequency(void);
-
-// =============================================================================
-// COMPARE CHANNEL FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Set compare value for specified channel
- * @param channel Compare channel (0, 1, or 2)
- * @param value Compare value
- * @return None
- */
-void TCA0_SetCompare(TCA_CmpChannel_t channel, uint16_t value);
-
-/**
- * @brief Get compare value for specified channel
- * @param channel Compare channel (0, 1, or 2)
- * @return Compare value
- */
-uint16_t TCA0_GetCompare(TCA_CmpChannel_t channel);
-
-/**
- * @brief Enable compare channel output
- * @param channel Compare channel to enable
- * @return None
- */
-void TCA0_EnableCompareOutput(TCA_CmpChannel_t channel);
-
-/**
- * @brief Disable compare channel output
- * @param channel Compare channel to disable
- * @return None
- */
-void TCA0_DisableCompareOutput(TCA_CmpChannel_t channel);
-
-/**
- * @brief Check if compare channel output is enabled
- * @param channel Compare channel to check
- * @retval true Channel output is enabled
- * @retval false Channel output is disabled
- */
-bool TCA0_IsCompareOutputEnabled(TCA_CmpChannel_t channel);
-
-// =============================================================================
-// PWM FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Set PWM duty cycle for specified channel
- * @param channel PWM channel (0, 1, or 2)
- * @param duty_percent Duty cycle percentage (0-100%)
- * @return None
- */
-void TCA0_SetPWMDutyCycle(TCA_CmpChannel_t channel, uint8_t duty_percent);
-
-/**
- * @brief Get PWM duty cycle for specified channel
- * @param channel PWM channel (0, 1, or 2)
- * @return Duty cycle percentage (0-100%)
- */
-uint8_t TCA0_GetPWMDutyCycle(TCA_CmpChannel_t channel);
-
-/**
- * @brief Set PWM frequency for all channels
- * @param frequency_hz Desired PWM frequency in Hz
- * @return true if successful, false if frequency cannot be achieved
- */
-bool TCA0_SetPWMFrequency(uint32_t frequency_hz);
-
-/**
- * @brief Enable PWM output on specified channel
- * @param channel PWM channel to enable
- * @return None
- */
-void TCA0_EnablePWM(TCA_CmpChannel_t channel);
-
-/**
- * @brief Disable PWM output on specified channel
- * @param channel PWM channel to disable
- * @return None
- */
-void TCA0_DisablePWM(TCA_CmpChannel_t channel);
-
-// =============================================================================
-// ADVANCED CONFIGURATION FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Set clock prescaler
- * @param clockSelect Clock prescaler selection
- * @return None
- */
-void TCA0_SetClockSelect(TCA_ClkSel_t clockSelect);
-
-/**
- * @brief Get current clock prescaler
- * @param None
- * @return Current clock prescaler
- */
-TCA_ClkSel_t TCA0_GetClockSelect(void);
-
-/**
- * @brief Set waveform generation mode
- * @param mode Waveform generation mode
- * @return None
- */
-void TCA0_SetWaveformMode(TCA_WgMode_t mode);
-
-/**
- * @brief Get current waveform generation mode
- * @param None
- * @return Current waveform generation mode
- */
-TCA_WgMode_t TCA0_GetWaveformMode(void);
-
-/**
- * @brief Enable/disable run in standby mode
- * @param enable true to enable, false to disable
- * @return None
- */
-void TCA0_SetRunInStandby(bool enable);
-
-/**
- * @brief Check if run in standby is enabled
- * @param None
- * @retval true Run in standby is enabled
- * @retval false Run in standby is disabled
- */
-bool TCA0_IsRunInStandbyEnabled(void);
-
-/**
- * @brief Set count direction
- * @param up true for up counting, false for down counting
- * @return None
- */
-void TCA0_SetCountDirection(bool up);
-
-/**
- * @brief Get count direction
- * @param None
- * @retval true Counting up
- * @retval false Counting down
- */
-bool TCA0_GetCountDirection(void);
-
-// =============================================================================
-// EVENT SYSTEM FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Configure event actions
- * @param eventA Action for event input A
- * @param eventB Action for event input B
- * @return None
- */
-void TCA0_ConfigureEvents(TCA_EvAct_t eventA, TCA_EvAct_t eventB);
-
-/**
- * @brief Enable event counting
- * @param enableA Enable counting on event A
- * @param enableB Enable counting on event B
- * @return None
- */
-void TCA0_EnableEventCounting(bool enableA, bool enableB);
+ * @param timing Result
+ * @return true if successful, false if frequency not achievable
+ */
+static inline __attribute__((always_inline))
+bool TCA_CalculateTiming(uint32_t clk_hz, uint32_t frequency_hz,
+                         TCA_Timing_t *timing)
+{
+    if (frequency_hz == 0) {
+        return false;
+    }
+    uint32_t q = clk_hz / frequency_hz;
+    TCA_TimingSearch_t best = {0xFF, 0, 1, 0};
+
+    // DIV1, 2, 4, 8, 16, 64, 256, 1024
+    TCA_TryPrescaler(0, 0, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(1, 1, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(2, 2, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(3, 3, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(4, 4, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(5, 6, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(6, 8, clk_hz, frequency_hz, q, &best);
+    TCA_TryPrescaler(7, 10, clk_hz, frequency_hz, q, &best);
+    if (best.index == 0xFF) {
+        return false;
+    }
+
+    int64_t target = (int64_t)frequency_hz * best.ticks;
+    timing->prescaler = (TCA_ClkSel_t)(best.index + 1);
+    timing->period = (uint16_t)(best.counts - 1);
+    timing->achievedHz = (clk_hz + best.ticks / 2) / best.ticks;
+    timing->errorPpm =
+        (int32_t)(((int64_t)clk_hz - target) * 1000000 / target);
+    return true;
+}
+
+/** @brief Full duty cycle in permille */
+#define TCA_DUTY_PERMILLE_MAX 1000
+
+/**
+ * @brief Compare value for a duty cycle in permille
+ *
+ * round(counts * permille / 1000), half up. The division is a multiply by
+ * ceil(2^36 / 1000) and a shift, one 32x32-bit multiply instead of a
+ * 32-bit division; the result is exact for every counts up to 65536.
+ *
+ * @param counts Counts per PWM period (PER + 1 single-slope, PER dual)
+ * @param permille Duty cycle, 0-1000 (larger is 1000)
+ * @return Compare value, at most 0xFFFF
+ */
+static inline uint16_t TCA_PermilleToCompare(uint32_t counts,
+                                             uint16_t permille)
+{
+    if (permille > TCA_DUTY_PERMILLE_MAX) {
+        permille = TCA_DUTY_PERMILLE_MAX;
+    }
+    uint32_t x = counts * permille + TCA_DUTY_PERMILLE_MAX / 2;
+    uint32_t compare = (uint32_t)(((uint64_t)x * 68719477UL) >> 36);
+    return (compare > 0xFFFF) ? 0xFFFF : (uint16_t)compare;
+}
+
+/**
+ * @brief Duty cycle in permille of a compare value
+ *
+ * round(compare * 1000 / counts), half up, in 32 bits. Round-trips every
+ * TCA_PermilleToCompare() value for periods of 1000 counts or more.
+ *
+ * @param counts Counts per PWM period, as for TCA_PermilleToCompare()
+ * @param compare Compare value
+ * @return Duty cycle, 0-1000
+ */
+static inline uint16_t TCA_CompareToPermille(uint32_t counts,
+                                             uint16_t compare)
+{
+    if (counts == 0 || compare >= counts) {
+        return (counts == 0) ? 0 : TCA_DUTY_PERMILLE_MAX;
+    }
+    return (uint16_t)(((uint32_t)compare * TCA_DUTY_PERMILLE_MAX +
+                       counts / 2) / counts);
+}
+
+/**
+ * @brief Duty cycle in percent of a compare value
+ *
+ * round(compare * 100 / counts), half up, straight from the counts rather
+ * than rounded again from TCA_CompareToPermille().
+ *
+ * @param counts Counts per PWM period, as for TCA_PermilleToCompare()
+ * @param compare Compare value
+ * @return Duty cycle, 0-100
+ */
+static inline uint8_t TCA_CompareToPercent(uint32_t counts, uint16_t compare)
+{
+    if (counts == 0 || compare >= counts) {
+        return (counts == 0) ? 0 : 100;
+    }
+    return (uint8_t)(((uint32_t)compare * 100 + counts / 2) / counts);
+}
 
 // =============================================================================
-// INTERRUPT FUNCTIONS
+// PER-INSTANCE API (TCA0_..., TCA1_...)
 // =============================================================================
 
-/**
- * @brief Register callback for overflow interrupt
- * @param cb Callback function
- * @return None
- */
-void TCA0_OverflowCallbackRegister(TCA0_cb_t cb);
-
-/**
- * @brief Register callback for compare 0 interrupt
- * @param cb Callback function
- * @return None
- */
-void TCA0_Compare0CallbackRegister(TCA0_cb_t cb);
-
-/**
- * @brief Register callback for compare 1 interrupt
- * @param cb Callback function
- * @return None
- */
-void TCA0_Compare1CallbackRegister(TCA0_cb_t cb);
+#define TCA_N 0
+#include "tca_api.h"
+#undef TCA_N
 
-/**
- * @brief Register callback for compare 2 interrupt
- * @param cb Callback function
- * @return None
- */
-void TCA0_Compare2CallbackRegister(TCA0_cb_t cb);
-
-/**
- * @brief Enable all interrupts (overflow + all compare channels)
- * @param None
- * @return None
- */
-void TCA0_EnableInterrupt(void);
-
-/**
- * @brief Disable all interrupts
- * @param None
- * @return None
- */
-void TCA0_DisableInterrupt(void);
-
-/**
- * @brief Enable specific interrupt
- * @param interrupt Interrupt to enable (use TCA_INT_* constants)
- * @return None
- */
-void TCA0_EnableSpecificInterrupt(TCA_IntConfig_t interrupt);
-
-/**
- * @brief Disable specific interrupt
- * @param interrupt Interrupt to disable (use TCA_INT_* constants)
- * @return None
- */
-void TCA0_DisableSpecificInterrupt(TCA_IntConfig_t interrupt);
+#ifdef TCA1
+#define TCA_N 1
+#include "tca_api.h"
+#undef TCA_N
+#endif
 
 // =============================================================================
-// INTERRUPT FLAG FUNCTIONS
+// COMPILE-TIME ISR BINDING
 // =============================================================================
 
 /**
- * @brief Clear overflow interrupt flag
- * @param None
- * @return None
- */
-void TCA0_ClearOverflowInterruptFlag(void);
-
-/**
- * @brief Check if overflow interrupt flag is set
- * @param None
- * @retval true Flag is set
- * @retval false Flag is not set
- */
-bool TCA0_IsOverflowInterruptFlagSet(void);
-
-/**
- * @brief Clear compare 0 interrupt flag
- * @param None
- * @return None
- */
-void TCA0_ClearCMP0InterruptFlag(void);
-
-/**
- * @brief Check if compare 0 interrupt flag is set
- * @param None
- * @retval true Flag is set
- * @retval false Flag is not set
- */
-bool TCA0_IsCMP0InterruptFlagSet(void);
-
-/**
- * @brief Clear compare 1 interrupt flag
- * @param None
- * @return None
- */
-void TCA0_ClearCMP1InterruptFlag(void);
-
-/**
- * @brief Check if compare 1 interrupt flag is set
- * @param None
- * @retval true Flag is set
- * @retval false Flag is not set
- */
-bool TCA0_IsCMP1InterruptFlagSet(void);
-
-/**
- * @brief Clear compare 2 interrupt flag
- * @param None
- * @return None
- */
-void TCA0_ClearCMP2InterruptFlag(void);
-
-/**
- * @brief Check if compare 2 interrupt flag is set
- * @param None
- * @retval true Flag is set
- * @retval false Flag is not set
- */
-bool TCA0_IsCMP2InterruptFlagSet(void);
-
-/**
- * @brief Clear specific interrupt flags
- * @param flags Flags to clear (use TCA_INT_* constants)
- * @return None
- */
-void TCA0_ClearInterruptFlags(TCA_IntConfig_t flags);
-
-/**
- * @brief Get all interrupt flags status
- * @param None
- * @return Current interrupt flags status
- */
-uint8_t TCA0_GetInterruptFlags(void);
-
-// =============================================================================
-// STATUS AND DIAGNOSTIC FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Get comprehensive timer status
- * @param None
- * @return Status register value
- */
-uint8_t TCA0_GetStatus(void);
-
-/**
- * @brief Check if timer is at TOP (period value)
- * @param None
- * @retval true Timer is at TOP
- * @retval false Timer is not at TOP
- */
-bool TCA0_IsAtTop(void);
-
-/**
- * @brief Check if timer is at BOTTOM (zero)
- * @param None
- * @retval true Timer is at BOTTOM
- * @retval false Timer is not at BOTTOM
- */
-bool TCA0_IsAtBottom(void);
-
-// =============================================================================
-// UTILITY AND CALCULATION FUNCTIONS
-// =============================================================================
-
-/**
- * @brief Calculate optimal prescaler and period for desired frequency
- * @param frequency_hz Desired frequency in Hz
- * @param prescaler Pointer to store calculated prescaler
- * @param period Pointer to store calculated period
- * @return true if calculation successful, false if frequency not achievable
- */
-bool TCA0_CalculateTimingParameters(uint32_t frequency_hz, TCA_ClkSel_t *prescaler, uint16_t *period);
-
-/**
- * @brief Get system clock frequency (needed for calculations)
- * @param None
- * @return System clock frequency in Hz
- */
-uint32_t TCA0_GetSystemClockFreq(void);
-
-/**
- * @brief Convert duty cycle percentage to compare value
- * @param duty_percent Duty cycle percentage (0-100%)
- * @return Compare value
- */
-uint16_t TCA0_DutyCycleToCompareValue(uint8_t duty_percent);
-
-/**
- * @brief Convert compare value to duty cycle percentage
- * @param compare_value Compare value
- * @return Duty cycle percentage (0-100%)
- */
-uint8_t TCA0_CompareValueToDutyCycle(uint16_t compare_value);
+ * @brief Bind a handler straight to a TCA interrupt vector
+ *
+ * The driver's vectors call the registered callbacks through a pointer.
+ * An indirect call from an ISR makes avr-gcc save all call-clobbered
+ * registers on every interrupt. This macro instead defines the vector in
+ * the application's own file, calling @p handler directly and clearing
+ * the flag:
+ *
+ *     static inline void on_tick(void) { ticks++; }
+ *     TCA_BIND_ISR(0, OVF, on_tick)
+ *
+ * With the handler visible in that file the compiler can inline it, and
+ * the ISR then saves only the registers the handler uses. By avr-gcc's
+ * ISR rules (make asm writes the .s files to count them in): a driver
+ * vector pushes and pops r0, r1, SREG, RAMPZ, r18-r27, r30 and r31, 16
+ * registers and 48 cycles on AVRxt (push 1, pop 2); bound to a handler
+ * that increments a 16-bit counter, only r0, SREG, r24 and r25, 4
+ * registers and 12 cycles. The driver's
+ * vectors are weak, so this definition replaces the one for that vector
+ * (TCA0_OverflowCallbackRegister() then has no effect); the other vectors
+ * keep their callbacks. Use it at most once per vector.
+ *
+ * @param n Instance number, 0 or 1
+ * @param source OVF, CMP0, CMP1 or CMP2 (LUNF, LCMPn in split mode share
+ *               the same vectors and flag bits)
+ * @param handler Function taking and returning nothing
+ */
+#define TCA_BIND_ISR(n, source, handler)                                   \
+    ISR(TCA_CAT(TCA, n, _, source##_vect))                                 \
+    {                                                                      \
+        handler();                                                         \
+        TCA_CAT(TCA, n, , ).SINGLE.INTFLAGS = TCA_SINGLE_##source##_bm;    \
+    }
 
 /**
  * @}
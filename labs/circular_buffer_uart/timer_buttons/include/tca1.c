@@ -0,0 +1,15 @@
+/**
+ * @file tca1.c
+ * @author Arturo Salinas
+ * @date 2025-09-24
+ * @brief TCA1 instance of the enhanced TCA driver
+ *
+ * @ingroup tca0_enhanced
+ */
+
+#include "tca.h" // Before TCA_N: it defines and undefines it for the API
+
+#ifdef TCA1 // Not on the 28- and 32-pin parts
+#define TCA_N 1
+#include "tca_impl.h"
+#endif
@@ -0,0 +1,686 @@
+/**
+ * @file tca_api.h
+ * @author Arturo Salinas
+ * @date 2025-09-24
+ * @brief Enhanced TCA Driver API for one instance
+ * 
+ * @ingroup tca0_enhanced
+ * 
+ * Included by tca.h once per instance with TCA_N defined, so TCA_FN(Start)
+ * declares TCA0_Start and TCA1_Start. The descriptions apply to both;
+ * include tca.h, not this file.
+ */
+
+#ifndef TCA_N
+#error "Include tca.h rather than tca_api.h"
+#endif
+
+/// Timer interface (Initialize, PeriodCountSet, TimeoutCallbackRegister)
+extern const struct TMR_INTERFACE TCA_FN(Interface);
+
+// =============================================================================
+// ENHANCED INITIALIZATION AND CONFIGURATION FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Initialize TCA0 with default configuration (Normal mode, DIV4 prescaler)
+ * 
+ * This function provides a simple initialization with sensible defaults:
+ * - Normal mode operation
+ * - System clock / 4 prescaler
+ * - 16-bit period (0xFFFF)
+ * - All compare channels disabled
+ * - No interrupts enabled
+ * 
+ * @param None
+ * @return None
+ */
+void TCA_FN(Initialize)(void);
+
+/**
+ * @brief Initialize TCA0 with comprehensive configuration
+ * 
+ * This function allows complete customization of all TCA0 parameters
+ * in a single call, providing maximum flexibility.
+ * 
+ * @param config Pointer to TCA_Config_t structure with all parameters
+ * @return None
+ */
+void TCA_FN(InitializeAdvanced)(const TCA_Config_t *config);
+
+/**
+ * @brief Initialize TCA0 for PWM generation with specified parameters
+ * 
+ * Configures TCA0 for single-slope PWM generation with the specified
+ * frequency and initial duty cycles.
+ * 
+ * @param frequency_hz Desired PWM frequency in Hz
+ * @param duty0_percent Initial duty cycle for channel 0 (0-100%)
+ * @param duty1_percent Initial duty cycle for channel 1 (0-100%)
+ * @param duty2_percent Initial duty cycle for channel 2 (0-100%)
+ * @return true if configuration successful, false if frequency too high/low
+ */
+bool TCA_FN(InitializePWM)(uint32_t frequency_hz, uint8_t duty0_percent, 
+                       uint8_t duty1_percent, uint8_t duty2_percent);
+
+/**
+ * @brief Initialize TCA0 for frequency generation
+ * 
+ * @param frequency_hz Target frequency in Hz
+ * @param channel Compare channel to use (0, 1, or 2)
+ * @return true if successful, false if frequency cannot be achieved
+ */
+bool TCA_FN(InitializeFrequencyGenerator)(uint32_t frequency_hz, TCA_CmpChannel_t channel);
+
+// =============================================================================
+// SPLIT MODE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Initialize TCA0 as two 8-bit counters with six PWM outputs
+ * 
+ * The low counter (LPER) drives WO0-WO2 and the high counter (HPER) drives
+ * WO3-WO5, each from the same prescaled clock. Both count down, and an
+ * enabled output is high for about compare of every period + 1 counts.
+ * The pins follow PORTMUX.TCAROUTEA (e.g. PORTMUX_TCA0_PORTD_gc gives
+ * PD0-PD5) and must be outputs. Compare registers are not buffered in
+ * split mode, so a new duty cycle takes effect on the next match.
+ * 
+ * Compares start at 0 (outputs low). The single-mode functions do not
+ * apply until TCA_FN(Reset)() or TCA_FN(InitializeAdvanced)() leaves split mode.
+ * 
+ * @param clockSelect Clock prescaler for both counters
+ * @param lowPeriod Low counter period (WO0-WO2)
+ * @param highPeriod High counter period (WO3-WO5)
+ * @param channels Outputs to enable, TCA_SPLIT_CHANNEL_bm() bits
+ * @return None
+ */
+void TCA_FN(InitializeSplit)(TCA_ClkSel_t clockSelect, uint8_t lowPeriod,
+                          uint8_t highPeriod, uint8_t channels);
+
+/**
+ * @brief Set both split-mode periods
+ * @param lowPeriod Low counter period (WO0-WO2)
+ * @param highPeriod High counter period (WO3-WO5)
+ * @return None
+ */
+void TCA_FN(SetSplitPeriod)(uint8_t lowPeriod, uint8_t highPeriod);
+
+/**
+ * @brief Set a split-mode compare value
+ * @param channel Split channel (LCMP0-2, HCMP0-2)
+ * @param value Compare value, 0 to the channel's period
+ * @return None
+ */
+void TCA_FN(SetSplitCompare)(TCA_SplitChannel_t channel, uint8_t value);
+
+/**
+ * @brief Get a split-mode compare value
+ * @param channel Split channel (LCMP0-2, HCMP0-2)
+ * @return Compare value
+ */
+uint8_t TCA_FN(GetSplitCompare)(TCA_SplitChannel_t channel);
+
+/**
+ * @brief Set a split-mode duty cycle against the channel's own period
+ * @param channel Split channel (LCMP0-2, HCMP0-2)
+ * @param duty_percent Duty cycle percentage (0-100%) of the PER + 1 counts,
+ *                     rounded as TCA_FN(SetPWMDutyCycle)() does; 100% at
+ *                     PER 255 gives 255/256
+ * @return None
+ */
+void TCA_FN(SetSplitDutyCycle)(TCA_SplitChannel_t channel, uint8_t duty_percent);
+
+/**
+ * @brief Check if TCA0 is in split mode
+ * @param None
+ * @retval true Split mode (two 8-bit counters)
+ * @retval false Single mode (one 16-bit counter)
+ */
+bool TCA_FN(IsSplitMode)(void);
+
+// =============================================================================
+// BASIC TIMER CONTROL FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Start the TCA0 timer
+ * @param None
+ * @return None
+ */
+void TCA_FN(Start)(void);
+
+/**
+ * @brief Stop the TCA0 timer
+ * @param None
+ * @return None
+ */
+void TCA_FN(Stop)(void);
+
+/**
+ * @brief Reset TCA0 to default state
+ * 
+ * Stops the timer, clears all registers, and resets configuration
+ * to power-on defaults.
+ * 
+ * @param None
+ * @return None
+ */
+void TCA_FN(Reset)(void);
+
+/**
+ * @brief Check if TCA0 is enabled and running
+ * @param None
+ * @retval true Timer is enabled and running
+ * @retval false Timer is stopped
+ */
+bool TCA_FN(IsEnabled)(void);
+
+// =============================================================================
+// COUNTER AND PERIOD FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Write counter value
+ * @param timerVal Counter value to write
+ * @return None
+ */
+void TCA_FN(Write)(uint16_t timerVal);
+
+/**
+ * @brief Read current counter value
+ * @param None
+ * @return Current counter value
+ */
+uint16_t TCA_FN(Read)(void);
+
+/**
+ * @brief Set the timer period
+ *
+ * While the timer runs the period goes through PERBUF and takes effect at
+ * the next UPDATE; writing PER below CNT would run the counter to 0xFFFF.
+ *
+ * @param period New period value
+ * @return None
+ */
+void TCA_FN(SetPeriod)(uint16_t period);
+
+/**
+ * @brief Get the current timer period
+ * @param None
+ * @return Current period value
+ */
+uint16_t TCA_FN(GetPeriod)(void);
+
+/**
+ * @brief Set timer frequency by calculating appropriate period and prescaler
+ * @param frequency_hz Desired frequency in Hz
+ * @return true if successful, false if frequency cannot be achieved
+ */
+bool TCA_FN(SetFrequency)(uint32_t frequency_hz);
+
+/**
+ * @brief Get current timer frequency
+ * @param None
+ * @return Current frequency in Hz
+ */
+uint32_t TCA_FN(GetFrequency)(void);
+
+// =============================================================================
+// COMPARE CHANNEL FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Set compare value for specified channel
+ *
+ * While the timer runs the value goes through CMPnBUF and takes effect at
+ * the next UPDATE (BOTTOM or TOP), so a PWM output never sees a runt pulse.
+ * Stopped, CMPn is written directly.
+ *
+ * @param channel Compare channel (0, 1, or 2)
+ * @param value Compare value
+ * @return None
+ */
+void TCA_FN(SetCompare)(TCA_CmpChannel_t channel, uint16_t value);
+
+/**
+ * @brief Get compare value for specified channel
+ * @param channel Compare channel (0, 1, or 2)
+ * @return Compare value, the buffered one if it has not taken effect yet
+ */
+uint16_t TCA_FN(GetCompare)(TCA_CmpChannel_t channel);
+
+/**
+ * @brief Enable compare channel output
+ * @param channel Compare channel to enable
+ * @return None
+ */
+void TCA_FN(EnableCompareOutput)(TCA_CmpChannel_t channel);
+
+/**
+ * @brief Disable compare channel output
+ * @param channel Compare channel to disable
+ * @return None
+ */
+void TCA_FN(DisableCompareOutput)(TCA_CmpChannel_t channel);
+
+/**
+ * @brief Check if compare channel output is enabled
+ * @param channel Compare channel to check
+ * @retval true Channel output is enabled
+ * @retval false Channel output is disabled
+ */
+bool TCA_FN(IsCompareOutputEnabled)(TCA_CmpChannel_t channel);
+
+// =============================================================================
+// BUFFERED (SYNCHRONIZED) UPDATE FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Write a compare buffer (CMPnBUF)
+ *
+ * The value is copied to CMPn at the next UPDATE event, unless the update
+ * is locked (see TCA_FN(BeginUpdate)()).
+ *
+ * @param channel Compare channel (0, 1, or 2)
+ * @param value Compare value
+ * @return None
+ */
+void TCA_FN(SetCompareBuffered)(TCA_CmpChannel_t channel, uint16_t value);
+
+/**
+ * @brief Write the period buffer (PERBUF)
+ * @param period Period value, copied to PER at the next UPDATE event
+ * @return None
+ */
+void TCA_FN(SetPeriodBuffered)(uint16_t period);
+
+/**
+ * @brief Start a batch of buffered updates (sets LUPD)
+ *
+ * Buffers written until TCA_FN(EndUpdate)() are held back and then copied
+ * together at one UPDATE event, so channels and period change in the same
+ * PWM cycle:
+ *
+ *     TCA0_BeginUpdate();
+ *     TCA0_SetCompareBuffered(TCA_CMP_CHANNEL0, r);
+ *     TCA0_SetCompareBuffered(TCA_CMP_CHANNEL1, g);
+ *     TCA0_SetCompareBuffered(TCA_CMP_CHANNEL2, b);
+ *     TCA0_EndUpdate();
+ *
+ * @return None
+ */
+void TCA_FN(BeginUpdate)(void);
+
+/**
+ * @brief Commit the batch at the next UPDATE event (clears LUPD)
+ * @return None
+ */
+void TCA_FN(EndUpdate)(void);
+
+/**
+ * @brief Check for buffered values not yet copied
+ * @retval true A PERBUF or CMPnBUF value is still waiting for UPDATE
+ * @retval false All buffers have taken effect
+ */
+bool TCA_FN(IsUpdatePending)(void);
+
+// =============================================================================
+// PWM FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Set PWM duty cycle for specified channel
+ *
+ * Buffered like TCA_FN(SetCompare)(); call it between TCA_FN(BeginUpdate)()
+ * and TCA_FN(EndUpdate)() to change several channels at once.
+ *
+ * @param channel PWM channel (0, 1, or 2)
+ * @param duty_percent Duty cycle percentage (0-100%)
+ * @return None
+ */
+void TCA_FN(SetPWMDutyCycle)(TCA_CmpChannel_t channel, uint8_t duty_percent);
+
+/**
+ * @brief Get PWM duty cycle for specified channel
+ * @param channel PWM channel (0, 1, or 2)
+ * @return Duty cycle percentage (0-100%)
+ */
+uint8_t TCA_FN(GetPWMDutyCycle)(TCA_CmpChannel_t channel);
+
+/**
+ * @brief Set PWM duty cycle in permille (0.1% steps)
+ *
+ * The compare value is the exact rounding of counts * permille / 1000 (see
+ * TCA_PermilleToCompare()); buffered like TCA_FN(SetPWMDutyCycle)().
+ *
+ * @param channel PWM channel (0, 1, or 2)
+ * @param permille Duty cycle, 0-1000
+ * @return None
+ */
+void TCA_FN(SetPWMDutyPermille)(TCA_CmpChannel_t channel, uint16_t permille);
+
+/**
+ * @brief Get PWM duty cycle in permille
+ * @param channel PWM channel (0, 1, or 2)
+ * @return Duty cycle, 0-1000, rounded
+ */
+uint16_t TCA_FN(GetPWMDutyPermille)(TCA_CmpChannel_t channel);
+
+/**
+ * @brief Set PWM frequency for all channels
+ * @param frequency_hz Desired PWM frequency in Hz
+ * @return true if successful, false if frequency cannot be achieved
+ */
+bool TCA_FN(SetPWMFrequency)(uint32_t frequency_hz);
+
+/**
+ * @brief Enable PWM output on specified channel
+ * @param channel PWM channel to enable
+ * @return None
+ */
+void TCA_FN(EnablePWM)(TCA_CmpChannel_t channel);
+
+/**
+ * @brief Disable PWM output on specified channel
+ * @param channel PWM channel to disable
+ * @return None
+ */
+void TCA_FN(DisablePWM)(TCA_CmpChannel_t channel);
+
+// =============================================================================
+// ADVANCED CONFIGURATION FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Set clock prescaler
+ * @param clockSelect Clock prescaler selection
+ * @return None
+ */
+void TCA_FN(SetClockSelect)(TCA_ClkSel_t clockSelect);
+
+/**
+ * @brief Get current clock prescaler
+ * @param None
+ * @return Current clock prescaler
+ */
+TCA_ClkSel_t TCA_FN(GetClockSelect)(void);
+
+/**
+ * @brief Set waveform generation mode
+ * @param mode Waveform generation mode
+ * @return None
+ */
+void TCA_FN(SetWaveformMode)(TCA_WgMode_t mode);
+
+/**
+ * @brief Get current waveform generation mode
+ * @param None
+ * @return Current waveform generation mode
+ */
+TCA_WgMode_t TCA_FN(GetWaveformMode)(void);
+
+/**
+ * @brief Enable/disable run in standby mode
+ * @param enable true to enable, false to disable
+ * @return None
+ */
+void TCA_FN(SetRunInStandby)(bool enable);
+
+/**
+ * @brief Check if run in standby is enabled
+ * @param None
+ * @retval true Run in standby is enabled
+ * @retval false Run in standby is disabled
+ */
+bool TCA_FN(IsRunInStandbyEnabled)(void);
+
+/**
+ * @brief Set count direction
+ * @param up true for up counting, false for down counting
+ * @return None
+ */
+void TCA_FN(SetCountDirection)(bool up);
+
+/**
+ * @brief Get count direction
+ * @param None
+ * @retval true Counting up
+ * @retval false Counting down
+ */
+bool TCA_FN(GetCountDirection)(void);
+
+// =============================================================================
+// EVENT SYSTEM FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Configure event actions
+ * @param eventA Action for event input A
+ * @param eventB Action for event input B
+ * @return None
+ */
+void TCA_FN(ConfigureEvents)(TCA_EvAct_t eventA, TCA_EvAct_t eventB);
+
+/**
+ * @brief Enable event counting
+ * @param enableA Enable counting on event A
+ * @param enableB Enable counting on event B
+ * @return None
+ */
+void TCA_FN(EnableEventCounting)(bool enableA, bool enableB);
+
+// =============================================================================
+// INTERRUPT FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Register callback for overflow interrupt
+ * @param cb Callback function
+ * @return None
+ */
+void TCA_FN(OverflowCallbackRegister)(TCA_cb_t cb);
+
+/**
+ * @brief Register callback for compare 0 interrupt
+ * @param cb Callback function
+ * @return None
+ */
+void TCA_FN(Compare0CallbackRegister)(TCA_cb_t cb);
+
+/**
+ * @brief Register callback for compare 1 interrupt
+ * @param cb Callback function
+ * @return None
+ */
+void TCA_FN(Compare1CallbackRegister)(TCA_cb_t cb);
+
+/**
+ * @brief Register callback for compare 2 interrupt
+ * @param cb Callback function
+ * @return None
+ */
+void TCA_FN(Compare2CallbackRegister)(TCA_cb_t cb);
+
+/**
+ * @brief Enable all interrupts (overflow + all compare channels)
+ * @param None
+ * @return None
+ */
+void TCA_FN(EnableInterrupt)(void);
+
+/**
+ * @brief Disable all interrupts
+ * @param None
+ * @return None
+ */
+void TCA_FN(DisableInterrupt)(void);
+
+/**
+ * @brief Enable specific interrupt
+ * @param interrupt Interrupt to enable (use TCA_INT_* constants)
+ * @return None
+ */
+void TCA_FN(EnableSpecificInterrupt)(TCA_IntConfig_t interrupt);
+
+/**
+ * @brief Disable specific interrupt
+ * @param interrupt Interrupt to disable (use TCA_INT_* constants)
+ * @return None
+ */
+void TCA_FN(DisableSpecificInterrupt)(TCA_IntConfig_t interrupt);
+
+// =============================================================================
+// INTERRUPT FLAG FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Clear overflow interrupt flag
+ * @param None
+ * @return None
+ */
+void TCA_FN(ClearOverflowInterruptFlag)(void);
+
+/**
+ * @brief Check if overflow interrupt flag is set
+ * @param None
+ * @retval true Flag is set
+ * @retval false Flag is not set
+ */
+bool TCA_FN(IsOverflowInterruptFlagSet)(void);
+
+/**
+ * @brief Clear compare 0 interrupt flag
+ * @param None
+ * @return None
+ */
+void TCA_FN(ClearCMP0InterruptFlag)(void);
+
+/**
+ * @brief Check if compare 0 interrupt flag is set
+ * @param None
+ * @retval true Flag is set
+ * @retval false Flag is not set
+ */
+bool TCA_FN(IsCMP0InterruptFlagSet)(void);
+
+/**
+ * @brief Clear compare 1 interrupt flag
+ * @param None
+ * @return None
+ */
+void TCA_FN(ClearCMP1InterruptFlag)(void);
+
+/**
+ * @brief Check if compare 1 interrupt flag is set
+ * @param None
+ * @retval true Flag is set
+ * @retval false Flag is not set
+ */
+bool TCA_FN(IsCMP1InterruptFlagSet)(void);
+
+/**
+ * @brief Clear compare 2 interrupt flag
+ * @param None
+ * @return None
+ */
+void TCA_FN(ClearCMP2InterruptFlag)(void);
+
+/**
+ * @brief Check if compare 2 interrupt flag is set
+ * @param None
+ * @retval true Flag is set
+ * @retval false Flag is not set
+ */
+bool TCA_FN(IsCMP2InterruptFlagSet)(void);
+
+/**
+ * @brief Clear specific interrupt flags
+ * @param flags Flags to clear (use TCA_INT_* constants)
+ * @return None
+ */
+void TCA_FN(ClearInterruptFlags)(TCA_IntConfig_t flags);
+
+/**
+ * @brief Get all interrupt flags status
+ * @param None
+ * @return Current interrupt flags status
+ */
+uint8_t TCA_FN(GetInterruptFlags)(void);
+
+// =============================================================================
+// STATUS AND DIAGNOSTIC FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Get comprehensive timer status
+ * @param None
+ * @return Status register value
+ */
+uint8_t TCA_FN(GetStatus)(void);
+
+/**
+ * @brief Check if timer is at TOP (period value)
+ * @param None
+ * @retval true Timer is at TOP
+ * @retval false Timer is not at TOP
+ */
+bool TCA_FN(IsAtTop)(void);
+
+/**
+ * @brief Check if timer is at BOTTOM (zero)
+ * @param None
+ * @retval true Timer is at BOTTOM
+ * @retval false Timer is not at BOTTOM
+ */
+bool TCA_FN(IsAtBottom)(void);
+
+// =============================================================================
+// UTILITY AND CALCULATION FUNCTIONS
+// =============================================================================
+
+/**
+ * @brief Find the prescaler and period closest to a frequency at F_CPU
+ * @param frequency_hz Desired frequency in Hz
+ * @param timing Result, including the achieved frequency and error
+ * @return true if successful, false if frequency not achievable
+ */
+bool TCA_FN(CalculateTiming)(uint32_t frequency_hz, TCA_Timing_t *timing);
+
+/**
+ * @brief Calculate optimal prescaler and period for desired frequency
+ *
+ * Picks the combination with the smallest frequency error; see
+ * TCA_FN(CalculateTiming)() for the achieved frequency.
+ *
+ * @param frequency_hz Desired frequency in Hz
+ * @param prescaler Pointer to store calculated prescaler
+ * @param period Pointer to store calculated period
+ * @return true if calculation successful, false if frequency not achievable
+ */
+bool TCA_FN(CalculateTimingParameters)(uint32_t frequency_hz, TCA_ClkSel_t *prescaler, uint16_t *period);
+
+/**
+ * @brief Get system clock frequency (needed for calculations)
+ * @param None
+ * @return System clock frequency in Hz
+ */
+uint32_t TCA_FN(GetSystemClockFreq)(void);
+
+/**
+ * @brief Convert duty cycle percentage to compare value
+ *
+ * Rounded to the nearest count of the current period: PER + 1 counts in
+ * single-slope modes, so 100% keeps the output high, PER in dual slope.
+ *
+ * @param duty_percent Duty cycle percentage (0-100%)
+ * @return Compare value
+ */
+uint16_t TCA_FN(DutyCycleToCompareValue)(uint8_t duty_percent);
+
+/**
+ * @brief Convert compare value to duty cycle percentage
+ * @param compare_value Compare value
+ * @return Duty cycle percentage (0-100%), rounded
+ */
+uint8_t TCA_FN(CompareValueToDutyCycle)(uint16_t compare_value);
@@ -0,0 +1,974 @@
+/**
+ * @file tca_impl.h
+ * @author Arturo Salinas  
+ * @date 2025-09-24
+ * @brief Enhanced TCA Driver Implementation with Maximum Configurability
+ * 
+ * @ingroup tca0_enhanced
+ * 
+ * This enhanced TCA driver provides comprehensive control over all aspects
+ * of the Timer/Counter Type A (TCA) module on the AVR128DB48. It supports
+ * all operating modes, PWM generation, frequency generation, and advanced
+ * features like event system integration.
+ * 
+ * Not a normal header: tca0.c and tca1.c each include tca.h, define TCA_N
+ * and include this once, which compiles the whole driver for that instance.
+ * TCA_FN(Start) becomes TCA0_Start or TCA1_Start, TCA_VECT(OVF) the matching
+ * vector, and TCA_REG the instance's registers at a fixed address, so every register
+ * access is still a single lds/sts with no instance pointer to pass.
+ */
+
+#ifndef TCA_N
+#error "Define TCA_N (0 or 1) before including tca_impl.h"
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdbool.h>
+#include "tca.h"
+
+// =============================================================================
+// PRIVATE CONSTANTS AND MACROS
+// =============================================================================
+
+#ifndef F_CPU
+#define F_CPU 4000000UL  ///< Default CPU frequency (4 MHz internal oscillator)
+#endif
+
+/// Prescaler divisor: 1, 2, 4, 8, 16, 64, 256, 1024 for TCA_CLK_DIV1..1024
+static uint16_t prescaler_div(TCA_ClkSel_t clockSelect)
+{
+    uint8_t i = clockSelect - 1;
+    return 1u << ((i < 5) ? i : 2 * i - 4);
+}
+
+/// TCA_ClkSel_t counts DIV1 as 1, CTRLA.CLKSEL counts it as 0
+static uint8_t clksel_bits(TCA_ClkSel_t clockSelect)
+{
+    return (uint8_t)(((clockSelect - 1) << TCA_SINGLE_CLKSEL_gp) & TCA_SINGLE_CLKSEL_gm);
+}
+
+/// CTRLB enable bit of a split channel: LCMP0-2 are bits 0-2, HCMP0-2 bits 4-6
+static uint8_t split_enable_bm(TCA_SplitChannel_t channel)
+{
+    return (channel < TCA_SPLIT_CHANNEL_HCMP0) ? (1 << channel) : (1 << (channel + 1));
+}
+
+// =============================================================================
+// CALLBACK FUNCTION POINTERS AND INTERFACE
+// =============================================================================
+
+const struct TMR_INTERFACE TCA_FN(Interface) = {
+    .Initialize = TCA_FN(Initialize),
+    .Start = NULL,
+    .Stop = NULL,
+    .PeriodCountSet = TCA_FN(Write),
+    .TimeoutCallbackRegister = TCA_FN(OverflowCallbackRegister),
+    .Tasks = NULL
+};
+
+// Default callback functions
+void TCA_FN(DefaultCompare0CallbackRegister)(void);
+void TCA_FN(DefaultCompare1CallbackRegister)(void);
+void TCA_FN(DefaultCompare2CallbackRegister)(void);
+void TCA_FN(DefaultOverflowCallbackRegister)(void);
+
+// Callback function pointers
+void (*TCA_FN(CMP0_isr_cb))(void) = &TCA_FN(DefaultCompare0CallbackRegister);
+void (*TCA_FN(CMP1_isr_cb))(void) = &TCA_FN(DefaultCompare1CallbackRegister);
+void (*TCA_FN(CMP2_isr_cb))(void) = &TCA_FN(DefaultCompare2CallbackRegister);
+void (*TCA_FN(OVF_isr_cb))(void) = &TCA_FN(DefaultOverflowCallbackRegister);
+
+void TCA_FN(DefaultCompare0CallbackRegister)(void)
+{
+    //Add your ISR code here
+}
+
+void TCA_FN(DefaultCompare1CallbackRegister)(void)
+{
+    //Add your ISR code here
+}
+
+void TCA_FN(DefaultCompare2CallbackRegister)(void)
+{
+    //Add your ISR code here
+}
+
+void TCA_FN(DefaultOverflowCallbackRegister)(void)
+{
+    //Add your ISR code here
+}
+
+void TCA_FN(OverflowCallbackRegister)(TCA_cb_t cb)
+{
+    TCA_FN(OVF_isr_cb) = cb;
+}
+
+void TCA_FN(Compare0CallbackRegister)(TCA_cb_t cb)
+{
+    TCA_FN(CMP0_isr_cb) = cb;
+}
+
+void TCA_FN(Compare1CallbackRegister)(TCA_cb_t cb)
+{
+    TCA_FN(CMP1_isr_cb) = cb;
+}
+
+void TCA_FN(Compare2CallbackRegister)(TCA_cb_t cb)
+{
+    TCA_FN(CMP2_isr_cb) = cb;
+}
+
+// Weak: a TCA_BIND_ISR() for the same vector replaces the dispatch below
+ISR(TCA_VECT(CMP0), __attribute__((weak)))
+{
+    if (TCA_FN(CMP0_isr_cb) != NULL)
+        (*TCA_FN(CMP0_isr_cb))();
+    
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_CMP0_bm;
+}
+
+ISR(TCA_VECT(CMP1), __attribute__((weak)))
+{
+    if (TCA_FN(CMP1_isr_cb) != NULL)
+        (*TCA_FN(CMP1_isr_cb))();
+    
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_CMP1_bm;
+}
+
+ISR(TCA_VECT(CMP2), __attribute__((weak)))
+{
+    if (TCA_FN(CMP2_isr_cb) != NULL)
+        (*TCA_FN(CMP2_isr_cb))();
+    
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_CMP2_bm;
+}
+
+ISR(TCA_VECT(OVF), __attribute__((weak)))
+{
+    if (TCA_FN(OVF_isr_cb) != NULL)
+        (*TCA_FN(OVF_isr_cb))();
+    
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
+}
+
+
+void TCA_FN(Initialize)(void) {
+    // Compare 0
+    TCA_REG.SINGLE.CMP0 = 0x0;
+        
+    // Compare 1
+    TCA_REG.SINGLE.CMP1 = 0x0;
+    
+    // Compare 2
+    TCA_REG.SINGLE.CMP2 = 0x0;
+        
+    // Count
+    TCA_REG.SINGLE.CNT = 0x0;
+    
+    // ALUPD disabled; CMP0EN disabled; CMP1EN disabled; CMP2EN disabled; WGMODE NORMAL; 
+    TCA_REG.SINGLE.CTRLB = 0x0;
+    
+    // CMP0OV disabled; CMP1OV disabled; CMP2OV disabled; 
+    TCA_REG.SINGLE.CTRLC = 0x0;
+    
+    // SPLITM disabled; 
+    TCA_REG.SINGLE.CTRLD = 0x0;
+    
+    // CMD NONE; DIR disabled; LUPD disabled; 
+    TCA_REG.SINGLE.CTRLECLR = 0x0;
+    
+    // CMD NONE; DIR UP; LUPD disabled; 
+    TCA_REG.SINGLE.CTRLESET = 0x0;
+    
+    // CMP0BV disabled; CMP1BV disabled; CMP2BV disabled; PERBV disabled; 
+    TCA_REG.SINGLE.CTRLFCLR = 0x0;
+    
+    // CMP0BV disabled; CMP1BV disabled; CMP2BV disabled; PERBV disabled; 
+    TCA_REG.SINGLE.CTRLFSET = 0x0;
+    
+    // DBGRUN disabled; 
+    TCA_REG.SINGLE.DBGCTRL = 0x0;
+    
+    // CNTAEI disabled; CNTBEI disabled; EVACTA CNT_POSEDGE; EVACTB NONE; 
+    TCA_REG.SINGLE.EVCTRL = 0x0;
+    
+    // CMP0 disabled; CMP1 disabled; CMP2 disabled; OVF disabled; 
+    TCA_REG.SINGLE.INTCTRL = 0x0;
+    
+    // CMP0 disabled; CMP1 disabled; CMP2 disabled; OVF disabled; 
+    TCA_REG.SINGLE.INTFLAGS = 0x0;
+    
+    // Period
+    TCA_REG.SINGLE.PER = 0xEA5F; // Max period = 59999
+    
+    // Temporary data for 16-bit Access
+    TCA_REG.SINGLE.TEMP = 0x0;
+    
+    // CLKSEL DIV4; ENABLE enabled; RUNSTDBY disabled; 
+    TCA_REG.SINGLE.CTRLA = 0x5;
+    
+}
+
+void TCA_FN(Start)(void)
+{
+    TCA_REG.SINGLE.CTRLA|= TCA_SINGLE_ENABLE_bm;
+}
+
+void TCA_FN(Stop)(void)
+{
+    TCA_REG.SINGLE.CTRLA&= ~TCA_SINGLE_ENABLE_bm;
+}
+
+void TCA_FN(Write)(uint16_t timerVal)
+{
+    TCA_REG.SINGLE.CNT=timerVal;
+}
+
+uint16_t TCA_FN(Read)(void)
+{
+    uint16_t readVal;
+
+    readVal = TCA_REG.SINGLE.CNT;
+
+    return readVal;
+}
+
+void TCA_FN(EnableInterrupt)(void)
+{
+        TCA_REG.SINGLE.INTCTRL = 1 << TCA_SINGLE_CMP0_bp /* Compare 0 Interrupt: enabled */
+	 				| 1 << TCA_SINGLE_CMP1_bp /* Compare 1 Interrupt: enabled */
+	 				| 1 << TCA_SINGLE_CMP2_bp /* Compare 2 Interrupt: enabled */
+	 				| 1 << TCA_SINGLE_OVF_bp; /* Overflow Interrupt: enabled */
+}
+void TCA_FN(DisableInterrupt)(void)
+{
+    TCA_REG.SINGLE.INTCTRL = 0 << TCA_SINGLE_CMP0_bp /* Compare 0 Interrupt: disabled */
+	 				| 0 << TCA_SINGLE_CMP1_bp /* Compare 1 Interrupt: disabled */
+	 				| 0 << TCA_SINGLE_CMP2_bp /* Compare 2 Interrupt: disabled */
+	 				| 0 << TCA_SINGLE_OVF_bp; /* Overflow Interrupt: disabled */
+}
+void TCA_FN(ClearOverflowInterruptFlag)(void)
+{
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm; /* Clear Overflow Interrupt Flag */
+}
+bool TCA_FN(IsOverflowInterruptFlagSet)(void)
+{
+    return ((TCA_REG.SINGLE.INTFLAGS & TCA_SINGLE_OVF_bm) > 0);
+}
+
+void TCA_FN(ClearCMP0InterruptFlag)(void)
+{
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_CMP0_bm; /* Clear Compare Channel-0 Interrupt Flag */
+}
+
+bool TCA_FN(IsCMP0InterruptFlagSet)(void)
+{
+    return ((TCA_REG.SINGLE.INTFLAGS & TCA_SINGLE_CMP0_bm) > 0);
+}
+
+void TCA_FN(ClearCMP1InterruptFlag)(void)
+{
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_CMP1_bm; /* Clear Compare Channel-1 Interrupt Flag */
+}
+
+bool TCA_FN(IsCMP1InterruptFlagSet)(void)
+{
+    return ((TCA_REG.SINGLE.INTFLAGS & TCA_SINGLE_CMP1_bm) > 0);
+}
+
+void TCA_FN(ClearCMP2InterruptFlag)(void)
+{
+    TCA_REG.SINGLE.INTFLAGS = TCA_SINGLE_CMP2_bm; /* Clear Compare Channel-2 Interrupt Flag */
+}
+
+bool TCA_FN(IsCMP2InterruptFlagSet)(void)
+{
+    return ((TCA_REG.SINGLE.INTFLAGS & TCA_SINGLE_CMP2_bm) > 0);
+}
+
+// =============================================================================
+// ENHANCED INITIALIZATION AND CONFIGURATION FUNCTIONS
+// =============================================================================
+
+void TCA_FN(InitializeAdvanced)(const TCA_Config_t *config)
+{
+    if (config == NULL) return;
+    
+    // Stop timer during configuration
+    TCA_FN(Stop)();
+    
+    // Leaving split mode takes a hard reset
+    if (TCA_FN(IsSplitMode)()) {
+        TCA_REG.SINGLE.CTRLESET = TCA_SINGLE_CMD_RESET_gc;
+    }
+    
+    // Configure period and compare values
+    TCA_REG.SINGLE.PER = config->period;
+    TCA_REG.SINGLE.CMP0 = config->compare0;
+    TCA_REG.SINGLE.CMP1 = config->compare1;
+    TCA_REG.SINGLE.CMP2 = config->compare2;
+    
+    // Reset counter
+    TCA_REG.SINGLE.CNT = 0x0;
+    
+    // Configure Control B (waveform mode and compare enables)
+    uint8_t ctrlb = ((config->waveformMode & 0x07) << TCA_SINGLE_WGMODE_gp);
+    if (config->enableCmp0) ctrlb |= TCA_SINGLE_CMP0EN_bm;
+    if (config->enableCmp1) ctrlb |= TCA_SINGLE_CMP1EN_bm;
+    if (config->enableCmp2) ctrlb |= TCA_SINGLE_CMP2EN_bm;
+    if (config->autoLockUpdate) ctrlb |= TCA_SINGLE_ALUPD_bm;
+    TCA_REG.SINGLE.CTRLB = ctrlb;
+    
+    // Clear other control registers  
+    TCA_REG.SINGLE.CTRLC = 0x0;
+    TCA_REG.SINGLE.CTRLD = 0x0;
+    TCA_REG.SINGLE.CTRLECLR = 0xFF;  // Clear all flags
+    TCA_REG.SINGLE.CTRLFCLR = 0xFF;  // Clear all buffer flags
+    
+    // Configure event system
+    uint8_t evctrl = 0x0;
+    evctrl |= (config->eventActionA & 0x03) << TCA_SINGLE_EVACTA_gp;
+    evctrl |= (config->eventActionB & 0x03) << TCA_SINGLE_EVACTB_gp;
+    if (config->countOnEventA) evctrl |= TCA_SINGLE_CNTAEI_bm;
+    if (config->countOnEventB) evctrl |= TCA_SINGLE_CNTBEI_bm;
+    TCA_REG.SINGLE.EVCTRL = evctrl;
+    
+    // Configure interrupts
+    TCA_REG.SINGLE.INTCTRL = config->interrupts;
+    
+    // Clear interrupt flags
+    TCA_REG.SINGLE.INTFLAGS = 0xFF;
+    
+    // Configure Control A (clock select, enable, run in standby)
+    uint8_t ctrla = clksel_bits(config->clockSelect);
+    if (config->runInStandby) ctrla |= TCA_SINGLE_RUNSTDBY_bm;
+    ctrla |= TCA_SINGLE_ENABLE_bm;  // Enable timer
+    TCA_REG.SINGLE.CTRLA = ctrla;
+}
+
+bool TCA_FN(InitializePWM)(uint32_t frequency_hz, uint8_t duty0_percent, 
+                       uint8_t duty1_percent, uint8_t duty2_percent)
+{
+    TCA_ClkSel_t prescaler;
+    uint16_t period;
+    
+    // Calculate optimal timing parameters
+    if (!TCA_FN(CalculateTimingParameters)(frequency_hz, &prescaler, &period)) {
+        return false;
+    }
+    
+    // Single slope: PER + 1 counts per period, as SetPWMDutyCycle() uses
+    uint32_t counts = (uint32_t)period + 1;
+    
+    // Create configuration structure
+    TCA_Config_t config = {
+        .period = period,
+        .compare0 = TCA_PermilleToCompare(counts, (uint16_t)duty0_percent * 10),
+        .compare1 = TCA_PermilleToCompare(counts, (uint16_t)duty1_percent * 10),
+        .compare2 = TCA_PermilleToCompare(counts, (uint16_t)duty2_percent * 10),
+        .clockSelect = prescaler,
+        .waveformMode = TCA_WGMODE_SINGLESLOPE,
+        .interrupts = TCA_INT_NONE,
+        .runInStandby = false,
+        .autoLockUpdate = false,
+        .enableCmp0 = true,
+        .enableCmp1 = true,
+        .enableCmp2 = true,
+        .eventActionA = TCA_EVACT_NONE,
+        .eventActionB = TCA_EVACT_NONE,
+        .countOnEventA = false,
+        .countOnEventB = false
+    };
+    
+    TCA_FN(InitializeAdvanced)(&config);
+    return true;
+}
+
+bool TCA_FN(InitializeFrequencyGenerator)(uint32_t frequency_hz, TCA_CmpChannel_t channel)
+{
+    TCA_ClkSel_t prescaler;
+    uint16_t period;
+    
+    // For frequency generation, we need frequency * 2 since output toggles
+    if (!TCA_FN(CalculateTimingParameters)(frequency_hz * 2, &prescaler, &period)) {
+        return false;
+    }
+    
+    TCA_Config_t config = {
+        .period = 0xFFFF,  // Max period for frequency mode
+        .compare0 = (channel == TCA_CMP_CHANNEL0) ? period : 0,
+        .compare1 = (channel == TCA_CMP_CHANNEL1) ? period : 0,
+        .compare2 = (channel == TCA_CMP_CHANNEL2) ? period : 0,
+        .clockSelect = prescaler,
+        .waveformMode = TCA_WGMODE_FRQ,
+        .interrupts = TCA_INT_NONE,
+        .runInStandby = false,
+        .autoLockUpdate = false,
+        .enableCmp0 = (channel == TCA_CMP_CHANNEL0),
+        .enableCmp1 = (channel == TCA_CMP_CHANNEL1),
+        .enableCmp2 = (channel == TCA_CMP_CHANNEL2),
+        .eventActionA = TCA_EVACT_NONE,
+        .eventActionB = TCA_EVACT_NONE,
+        .countOnEventA = false,
+        .countOnEventB = false
+    };
+    
+    TCA_FN(InitializeAdvanced)(&config);
+    return true;
+}
+
+// =============================================================================
+// SPLIT MODE FUNCTIONS
+// =============================================================================
+
+void TCA_FN(InitializeSplit)(TCA_ClkSel_t clockSelect, uint8_t lowPeriod,
+                          uint8_t highPeriod, uint8_t channels)
+{
+    // SPLITM may only change while disabled, after a hard reset
+    TCA_REG.SINGLE.CTRLA = 0x0;
+    TCA_REG.SINGLE.CTRLESET = TCA_SINGLE_CMD_RESET_gc;
+    TCA_REG.SPLIT.CTRLD = TCA_SPLIT_SPLITM_bm;
+    
+    // Periods, compares (outputs low) and counters
+    TCA_REG.SPLIT.LPER = lowPeriod;
+    TCA_REG.SPLIT.HPER = highPeriod;
+    TCA_REG.SPLIT.LCMP0 = 0x0;
+    TCA_REG.SPLIT.LCMP1 = 0x0;
+    TCA_REG.SPLIT.LCMP2 = 0x0;
+    TCA_REG.SPLIT.HCMP0 = 0x0;
+    TCA_REG.SPLIT.HCMP1 = 0x0;
+    TCA_REG.SPLIT.HCMP2 = 0x0;
+    TCA_REG.SPLIT.LCNT = 0x0;
+    TCA_REG.SPLIT.HCNT = 0x0;
+    
+    // Output enables
+    uint8_t ctrlb = 0x0;
+    for (uint8_t ch = TCA_SPLIT_CHANNEL_LCMP0; ch <= TCA_SPLIT_CHANNEL_HCMP2; ch++) {
+        if (channels & TCA_SPLIT_CHANNEL_bm(ch)) {
+            ctrlb |= split_enable_bm((TCA_SplitChannel_t)ch);
+        }
+    }
+    TCA_REG.SPLIT.CTRLB = ctrlb;
+    TCA_REG.SPLIT.CTRLC = 0x0;
+    
+    // No interrupts; the outputs need no CPU
+    TCA_REG.SPLIT.INTCTRL = 0x0;
+    TCA_REG.SPLIT.INTFLAGS = 0xFF;
+    
+    TCA_REG.SPLIT.CTRLA = clksel_bits(clockSelect) | TCA_SPLIT_ENABLE_bm;
+}
+
+void TCA_FN(SetSplitPeriod)(uint8_t lowPeriod, uint8_t highPeriod)
+{
+    TCA_REG.SPLIT.LPER = lowPeriod;
+    TCA_REG.SPLIT.HPER = highPeriod;
+}
+
+void TCA_FN(SetSplitCompare)(TCA_SplitChannel_t channel, uint8_t value)
+{
+    switch (channel) {
+        case TCA_SPLIT_CHANNEL_LCMP0:
+            TCA_REG.SPLIT.LCMP0 = value;
+            break;
+        case TCA_SPLIT_CHANNEL_LCMP1:
+            TCA_REG.SPLIT.LCMP1 = value;
+            break;
+        case TCA_SPLIT_CHANNEL_LCMP2:
+            TCA_REG.SPLIT.LCMP2 = value;
+            break;
+        case TCA_SPLIT_CHANNEL_HCMP0:
+            TCA_REG.SPLIT.HCMP0 = value;
+            break;
+        case TCA_SPLIT_CHANNEL_HCMP1:
+            TCA_REG.SPLIT.HCMP1 = value;
+            break;
+        case TCA_SPLIT_CHANNEL_HCMP2:
+            TCA_REG.SPLIT.HCMP2 = value;
+            break;
+    }
+}
+
+uint8_t TCA_FN(GetSplitCompare)(TCA_SplitChannel_t channel)
+{
+    switch (channel) {
+        case TCA_SPLIT_CHANNEL_LCMP0:
+            return TCA_REG.SPLIT.LCMP0;
+        case TCA_SPLIT_CHANNEL_LCMP1:
+            return TCA_REG.SPLIT.LCMP1;
+        case TCA_SPLIT_CHANNEL_LCMP2:
+            return TCA_REG.SPLIT.LCMP2;
+        case TCA_SPLIT_CHANNEL_HCMP0:
+            return TCA_REG.SPLIT.HCMP0;
+        case TCA_SPLIT_CHANNEL_HCMP1:
+            return TCA_REG.SPLIT.HCMP1;
+        case TCA_SPLIT_CHANNEL_HCMP2:
+            return TCA_REG.SPLIT.HCMP2;
+        default:
+            return 0;
+    }
+}
+
+void TCA_FN(SetSplitDutyCycle)(TCA_SplitChannel_t channel, uint8_t duty_percent)
+{
+    if (duty_percent > 100) duty_percent = 100;
+    
+    // The counter runs PER..0, PER + 1 counts; at PER 255 full duty needs
+    // a compare of 256, so the nearest is 255
+    uint8_t period = (channel < TCA_SPLIT_CHANNEL_HCMP0) ? TCA_REG.SPLIT.LPER : TCA_REG.SPLIT.HPER;
+    uint16_t compare_value = TCA_PermilleToCompare((uint32_t)period + 1, (uint16_t)duty_percent * 10);
+    if (compare_value > 0xFF) compare_value = 0xFF;
+    
+    TCA_FN(SetSplitCompare)(channel, (uint8_t)compare_value);
+}
+
+bool TCA_FN(IsSplitMode)(void)
+{
+    return (TCA_REG.SINGLE.CTRLD & TCA_SINGLE_SPLITM_bm) != 0;
+}
+
+// =============================================================================
+// ENHANCED TIMER CONTROL FUNCTIONS  
+// =============================================================================
+
+void TCA_FN(Reset)(void)
+{
+    // Stop timer, and hard reset in case it was in split mode
+    TCA_REG.SINGLE.CTRLA = 0x0;
+    TCA_REG.SINGLE.CTRLESET = TCA_SINGLE_CMD_RESET_gc;
+    
+    // Reset all registers to default values
+    TCA_REG.SINGLE.CTRLB = 0x0;
+    TCA_REG.SINGLE.CTRLC = 0x0;
+    TCA_REG.SINGLE.CTRLD = 0x0;
+    TCA_REG.SINGLE.CTRLECLR = 0xFF;
+    TCA_REG.SINGLE.CTRLFCLR = 0xFF;
+    TCA_REG.SINGLE.EVCTRL = 0x0;
+    TCA_REG.SINGLE.INTCTRL = 0x0;
+    TCA_REG.SINGLE.INTFLAGS = 0xFF;
+    TCA_REG.SINGLE.DBGCTRL = 0x0;
+    TCA_REG.SINGLE.TEMP = 0x0;
+    
+    // Reset counter and compare values
+    TCA_REG.SINGLE.CNT = 0x0;
+    TCA_REG.SINGLE.PER = 0xFFFF;
+    TCA_REG.SINGLE.CMP0 = 0x0;
+    TCA_REG.SINGLE.CMP1 = 0x0;
+    TCA_REG.SINGLE.CMP2 = 0x0;
+}
+
+bool TCA_FN(IsEnabled)(void)
+{
+    return (TCA_REG.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm) != 0;
+}
+
+// =============================================================================
+// ENHANCED PERIOD AND FREQUENCY FUNCTIONS
+// =============================================================================
+
+void TCA_FN(SetPeriod)(uint16_t period)
+{
+    // Running: through PERBUF, so a shorter period never lands below CNT
+    if (TCA_FN(IsEnabled)()) {
+        TCA_REG.SINGLE.PERBUF = period;
+    } else {
+        TCA_REG.SINGLE.PER = period;
+    }
+}
+
+uint16_t TCA_FN(GetPeriod)(void)
+{
+    // A value still waiting in PERBUF is the one that was set last
+    if (TCA_REG.SINGLE.CTRLFSET & TCA_SINGLE_PERBV_bm) {
+        return TCA_REG.SINGLE.PERBUF;
+    }
+    return TCA_REG.SINGLE.PER;
+}
+
+bool TCA_FN(SetFrequency)(uint32_t frequency_hz)
+{
+    TCA_ClkSel_t prescaler;
+    uint16_t period;
+    
+    if (!TCA_FN(CalculateTimingParameters)(frequency_hz, &prescaler, &period)) {
+        return false;
+    }
+    
+    // Update prescaler and period
+    TCA_FN(SetClockSelect)(prescaler);
+    TCA_FN(SetPeriod)(period);
+    
+    return true;
+}
+
+uint32_t TCA_FN(GetFrequency)(void)
+{
+    uint32_t system_freq = TCA_FN(GetSystemClockFreq)();
+    TCA_ClkSel_t prescaler = TCA_FN(GetClockSelect)();
+    uint16_t period = TCA_FN(GetPeriod)();
+    
+    if (prescaler == 0 || prescaler > 8 || period == 0) {
+        return 0;
+    }
+    
+    // Rounded, and in 32 bits: DIV1024 at a long period exceeds 16
+    uint32_t ticks = (uint32_t)prescaler_div(prescaler) * (period + 1UL);
+    return (system_freq + ticks / 2) / ticks;
+}
+
+// =============================================================================
+// COMPARE CHANNEL FUNCTIONS
+// =============================================================================
+
+void TCA_FN(SetCompare)(TCA_CmpChannel_t channel, uint16_t value)
+{
+    // Running: through CMPnBUF, so the new value starts with a period
+    if (TCA_FN(IsEnabled)()) {
+        TCA_FN(SetCompareBuffered)(channel, value);
+        return;
+    }
+    switch (channel) {
+        case TCA_CMP_CHANNEL0:
+            TCA_REG.SINGLE.CMP0 = value;
+            break;
+        case TCA_CMP_CHANNEL1:
+            TCA_REG.SINGLE.CMP1 = value;
+            break;
+        case TCA_CMP_CHANNEL2:
+            TCA_REG.SINGLE.CMP2 = value;
+            break;
+    }
+}
+
+uint16_t TCA_FN(GetCompare)(TCA_CmpChannel_t channel)
+{
+    // A value still waiting in CMPnBUF is the one that was set last
+    uint8_t valid = TCA_REG.SINGLE.CTRLFSET;
+    switch (channel) {
+        case TCA_CMP_CHANNEL0:
+            return (valid & TCA_SINGLE_CMP0BV_bm) ? TCA_REG.SINGLE.CMP0BUF
+                                                  : TCA_REG.SINGLE.CMP0;
+        case TCA_CMP_CHANNEL1:
+            return (valid & TCA_SINGLE_CMP1BV_bm) ? TCA_REG.SINGLE.CMP1BUF
+                                                  : TCA_REG.SINGLE.CMP1;
+        case TCA_CMP_CHANNEL2:
+            return (valid & TCA_SINGLE_CMP2BV_bm) ? TCA_REG.SINGLE.CMP2BUF
+                                                  : TCA_REG.SINGLE.CMP2;
+        default:
+            return 0;
+    }
+}
+
+void TCA_FN(EnableCompareOutput)(TCA_CmpChannel_t channel)
+{
+    switch (channel) {
+        case TCA_CMP_CHANNEL0:
+            TCA_REG.SINGLE.CTRLB |= TCA_SINGLE_CMP0EN_bm;
+            break;
+        case TCA_CMP_CHANNEL1:
+            TCA_REG.SINGLE.CTRLB |= TCA_SINGLE_CMP1EN_bm;
+            break;
+        case TCA_CMP_CHANNEL2:
+            TCA_REG.SINGLE.CTRLB |= TCA_SINGLE_CMP2EN_bm;
+            break;
+    }
+}
+
+void TCA_FN(DisableCompareOutput)(TCA_CmpChannel_t channel)
+{
+    switch (channel) {
+        case TCA_CMP_CHANNEL0:
+            TCA_REG.SINGLE.CTRLB &= ~TCA_SINGLE_CMP0EN_bm;
+            break;
+        case TCA_CMP_CHANNEL1:
+            TCA_REG.SINGLE.CTRLB &= ~TCA_SINGLE_CMP1EN_bm;
+            break;
+        case TCA_CMP_CHANNEL2:
+            TCA_REG.SINGLE.CTRLB &= ~TCA_SINGLE_CMP2EN_bm;
+            break;
+    }
+}
+
+bool TCA_FN(IsCompareOutputEnabled)(TCA_CmpChannel_t channel)
+{
+    switch (channel) {
+        case TCA_CMP_CHANNEL0:
+            return (TCA_REG.SINGLE.CTRLB & TCA_SINGLE_CMP0EN_bm) != 0;
+        case TCA_CMP_CHANNEL1:
+            return (TCA_REG.SINGLE.CTRLB & TCA_SINGLE_CMP1EN_bm) != 0;
+        case TCA_CMP_CHANNEL2:
+            return (TCA_REG.SINGLE.CTRLB & TCA_SINGLE_CMP2EN_bm) != 0;
+        default:
+            return false;
+    }
+}
+
+// =============================================================================
+// BUFFERED (SYNCHRONIZED) UPDATE FUNCTIONS
+// =============================================================================
+
+void TCA_FN(SetCompareBuffered)(TCA_CmpChannel_t channel, uint16_t value)
+{
+    switch (channel) {
+        case TCA_CMP_CHANNEL0:
+            TCA_REG.SINGLE.CMP0BUF = value;
+            break;
+        case TCA_CMP_CHANNEL1:
+            TCA_REG.SINGLE.CMP1BUF = value;
+            break;
+        case TCA_CMP_CHANNEL2:
+            TCA_REG.SINGLE.CMP2BUF = value;
+            break;
+    }
+}
+
+void TCA_FN(SetPeriodBuffered)(uint16_t period)
+{
+    TCA_REG.SINGLE.PERBUF = period;
+}
+
+void TCA_FN(BeginUpdate)(void)
+{
+    // Buffers fill but are not copied at UPDATE until EndUpdate()
+    TCA_REG.SINGLE.CTRLESET = TCA_SINGLE_LUPD_bm;
+}
+
+void TCA_FN(EndUpdate)(void)
+{
+    // Every buffer written since BeginUpdate() goes in at the same UPDATE
+    TCA_REG.SINGLE.CTRLECLR = TCA_SINGLE_LUPD_bm;
+}
+
+bool TCA_FN(IsUpdatePending)(void)
+{
+    return (TCA_REG.SINGLE.CTRLFSET & (TCA_SINGLE_PERBV_bm |
+                                       TCA_SINGLE_CMP0BV_bm |
+                                       TCA_SINGLE_CMP1BV_bm |
+                                       TCA_SINGLE_CMP2BV_bm)) != 0;
+}
+
+// =============================================================================
+// PWM FUNCTIONS
+// =============================================================================
+
+/// Counts per PWM period: the counter runs 0..PER, or up and down in dual slope
+static uint32_t pwm_counts(void)
+{
+    uint8_t wgmode = (TCA_REG.SINGLE.CTRLB & TCA_SINGLE_WGMODE_gm) >> TCA_SINGLE_WGMODE_gp;
+    uint32_t period = TCA_FN(GetPeriod)();
+    return (wgmode >= TCA_WGMODE_DUALSLOPE) ? period : period + 1;
+}
+
+void TCA_FN(SetPWMDutyCycle)(TCA_CmpChannel_t channel, uint8_t duty_percent)
+{
+    TCA_FN(SetCompare)(channel, TCA_FN(DutyCycleToCompareValue)(duty_percent));
+}
+
+uint8_t TCA_FN(GetPWMDutyCycle)(TCA_CmpChannel_t channel)
+{
+    return TCA_FN(CompareValueToDutyCycle)(TCA_FN(GetCompare)(channel));
+}
+
+void TCA_FN(SetPWMDutyPermille)(TCA_CmpChannel_t channel, uint16_t permille)
+{
+    TCA_FN(SetCompare)(channel, TCA_PermilleToCompare(pwm_counts(), permille));
+}
+
+uint16_t TCA_FN(GetPWMDutyPermille)(TCA_CmpChannel_t channel)
+{
+    return TCA_CompareToPermille(pwm_counts(), TCA_FN(GetCompare)(channel));
+}
+
+bool TCA_FN(SetPWMFrequency)(uint32_t frequency_hz)
+{
+    return TCA_FN(SetFrequency)(frequency_hz);
+}
+
+void TCA_FN(EnablePWM)(TCA_CmpChannel_t channel)
+{
+    // Set to single-slope PWM mode if not already
+    uint8_t ctrlb = TCA_REG.SINGLE.CTRLB;
+    ctrlb = (ctrlb & ~TCA_SINGLE_WGMODE_gm) | (TCA_WGMODE_SINGLESLOPE << TCA_SINGLE_WGMODE_gp);
+    TCA_REG.SINGLE.CTRLB = ctrlb;
+    
+    // Enable compare output
+    TCA_FN(EnableCompareOutput)(channel);
+}
+
+void TCA_FN(DisablePWM)(TCA_CmpChannel_t channel)
+{
+    TCA_FN(DisableCompareOutput)(channel);
+}
+
+// =============================================================================
+// ADVANCED CONFIGURATION FUNCTIONS
+// =============================================================================
+
+void TCA_FN(SetClockSelect)(TCA_ClkSel_t clockSelect)
+{
+    uint8_t ctrla = TCA_REG.SINGLE.CTRLA;
+    ctrla = (ctrla & ~TCA_SINGLE_CLKSEL_gm) | clksel_bits(clockSelect);
+    TCA_REG.SINGLE.CTRLA = ctrla;
+}
+
+TCA_ClkSel_t TCA_FN(GetClockSelect)(void)
+{
+    return (TCA_ClkSel_t)(((TCA_REG.SINGLE.CTRLA & TCA_SINGLE_CLKSEL_gm) >> TCA_SINGLE_CLKSEL_gp) + 1);
+}
+
+void TCA_FN(SetWaveformMode)(TCA_WgMode_t mode)
+{
+    uint8_t ctrlb = TCA_REG.SINGLE.CTRLB;
+    ctrlb = (ctrlb & ~TCA_SINGLE_WGMODE_gm) | ((mode & 0x07) << TCA_SINGLE_WGMODE_gp);
+    TCA_REG.SINGLE.CTRLB = ctrlb;
+}
+
+TCA_WgMode_t TCA_FN(GetWaveformMode)(void)
+{
+    return (TCA_WgMode_t)((TCA_REG.SINGLE.CTRLB & TCA_SINGLE_WGMODE_gm) >> TCA_SINGLE_WGMODE_gp);
+}
+
+void TCA_FN(SetRunInStandby)(bool enable)
+{
+    if (enable) {
+        TCA_REG.SINGLE.CTRLA |= TCA_SINGLE_RUNSTDBY_bm;
+    } else {
+        TCA_REG.SINGLE.CTRLA &= ~TCA_SINGLE_RUNSTDBY_bm;
+    }
+}
+
+bool TCA_FN(IsRunInStandbyEnabled)(void)
+{
+    return (TCA_REG.SINGLE.CTRLA & TCA_SINGLE_RUNSTDBY_bm) != 0;
+}
+
+void TCA_FN(SetCountDirection)(bool up)
+{
+    if (up) {
+        TCA_REG.SINGLE.CTRLESET = TCA_SINGLE_DIR_bm;
+    } else {
+        TCA_REG.SINGLE.CTRLECLR = TCA_SINGLE_DIR_bm;
+    }
+}
+
+bool TCA_FN(GetCountDirection)(void)
+{
+    return (TCA_REG.SINGLE.CTRLE & TCA_SINGLE_DIR_bm) != 0;
+}
+
+// =============================================================================
+// EVENT SYSTEM FUNCTIONS
+// =============================================================================
+
+void TCA_FN(ConfigureEvents)(TCA_EvAct_t eventA, TCA_EvAct_t eventB)
+{
+    uint8_t evctrl = TCA_REG.SINGLE.EVCTRL;
+    evctrl = (evctrl & ~(TCA_SINGLE_EVACTA_gm | TCA_SINGLE_EVACTB_gm));
+    evctrl |= ((eventA & 0x03) << TCA_SINGLE_EVACTA_gp);
+    evctrl |= ((eventB & 0x03) << TCA_SINGLE_EVACTB_gp);
+    TCA_REG.SINGLE.EVCTRL = evctrl;
+}
+
+void TCA_FN(EnableEventCounting)(bool enableA, bool enableB)
+{
+    uint8_t evctrl = TCA_REG.SINGLE.EVCTRL;
+    
+    if (enableA) {
+        evctrl |= TCA_SINGLE_CNTAEI_bm;
+    } else {
+        evctrl &= ~TCA_SINGLE_CNTAEI_bm;
+    }
+    
+    if (enableB) {
+        evctrl |= TCA_SINGLE_CNTBEI_bm;
+    } else {
+        evctrl &= ~TCA_SINGLE_CNTBEI_bm;
+    }
+    
+    TCA_REG.SINGLE.EVCTRL = evctrl;
+}
+
+// =============================================================================
+// ENHANCED INTERRUPT FUNCTIONS
+// =============================================================================
+
+void TCA_FN(EnableSpecificInterrupt)(TCA_IntConfig_t interrupt)
+{
+    TCA_REG.SINGLE.INTCTRL |= (interrupt & 0x7F);
+}
+
+void TCA_FN(DisableSpecificInterrupt)(TCA_IntConfig_t interrupt)
+{
+    TCA_REG.SINGLE.INTCTRL &= ~(interrupt & 0x7F);
+}
+
+void TCA_FN(ClearInterruptFlags)(TCA_IntConfig_t flags)
+{
+    TCA_REG.SINGLE.INTFLAGS = (flags & 0x7F);
+}
+
+uint8_t TCA_FN(GetInterruptFlags)(void)
+{
+    return TCA_REG.SINGLE.INTFLAGS;
+}
+
+// =============================================================================
+// STATUS AND DIAGNOSTIC FUNCTIONS
+// =============================================================================
+
+uint8_t TCA_FN(GetStatus)(void)
+{
+    return TCA_REG.SINGLE.INTFLAGS;
+}
+
+bool TCA_FN(IsAtTop)(void)
+{
+    return TCA_REG.SINGLE.CNT >= TCA_REG.SINGLE.PER;
+}
+
+bool TCA_FN(IsAtBottom)(void)
+{
+    return TCA_REG.SINGLE.CNT == 0;
+}
+
+// =============================================================================
+// UTILITY AND CALCULATION FUNCTIONS
+// =============================================================================
+
+bool TCA_FN(CalculateTiming)(uint32_t frequency_hz, TCA_Timing_t *timing)
+{
+    if (timing == NULL) {
+        return false;
+    }
+    return TCA_CalculateTiming(TCA_FN(GetSystemClockFreq)(), frequency_hz, timing);
+}
+
+bool TCA_FN(CalculateTimingParameters)(uint32_t frequency_hz, TCA_ClkSel_t *prescaler, uint16_t *period)
+{
+    TCA_Timing_t timing;
+    
+    if (prescaler == NULL || period == NULL ||
+        !TCA_FN(CalculateTiming)(frequency_hz, &timing)) {
+        return false;
+    }
+    
+    *prescaler = timing.prescaler;
+    *period = timing.period;
+    return true;
+}
+
+uint32_t TCA_FN(GetSystemClockFreq)(void)
+{
+    return F_CPU;  // Return configured CPU frequency
+}
+
+uint16_t TCA_FN(DutyCycleToCompareValue)(uint8_t duty_percent)
+{
+    if (duty_percent > 100) duty_percent = 100;
+    return TCA_PermilleToCompare(pwm_counts(), (uint16_t)duty_percent * 10);
+}
+
+uint8_t TCA_FN(CompareValueToDutyCycle)(uint16_t compare_value)
+{
+    return TCA_CompareToPercent(pwm_counts(), compare_value);
+}
\ No newline at end of file
@@ -23,6 +23,12 @@ void tca_compare2_handler(void);
 volatile uint32_t overflow_count = 0;
 volatile uint32_t compare_matches = 0;
 
+// Example 10: PWM periods, CMP0 matches in the current one, and periods
+// that did not have exactly one match
+volatile uint16_t sync_periods = 0;
+volatile uint16_t sync_matches = 0;
+volatile uint16_t sync_glitches = 0;
+
 /**
  * @brief Example 1: Basic Timer Usage - 1Hz overflow interrupt
  */
@@ -324,6 +330,145 @@ void example_event_system_integration(void) {
     printf("Timer ready for event-driven operation\n");
 }
 
+/**
+ * @brief Example 9: Split Mode - six 8-bit PWM outputs on PORTD
+ */
+void example_split_mode_leds(void) {
+    printf("=== Example 9: Split Mode - Six LED PWM Outputs ===\n");
+    
+    // WO0-WO5 on PD0-PD5
+    PORTMUX.TCAROUTEA = PORTMUX_TCA0_PORTD_gc;
+    PORTD.DIRSET = PIN0_bm | PIN1_bm | PIN2_bm | PIN3_bm | PIN4_bm | PIN5_bm;
+    
+    // 4MHz/64 = 62.5kHz counters, period 255: ~244Hz, flicker-free
+    TCA0_InitializeSplit(TCA_CLK_DIV64, 255, 255, TCA_SPLIT_ALL_CHANNELS);
+    
+    // One brightness step per LED; the hardware keeps them running
+    for (uint8_t ch = TCA_SPLIT_CHANNEL_LCMP0; ch <= TCA_SPLIT_CHANNEL_HCMP2; ch++) {
+        TCA0_SetSplitDutyCycle((TCA_SplitChannel_t)ch, 10 + ch * 18);
+        printf("- WO%u: %u/255\n", ch, TCA0_GetSplitCompare((TCA_SplitChannel_t)ch));
+    }
+    
+    printf("Split mode: %s, no interrupts in use\n", TCA0_IsSplitMode() ? "on" : "off");
+}
+
+static void sync_overflow_handler(void) {
+    // CMP0 stays within 5%..95%, so every period has exactly one match
+    if (sync_matches != 1) {
+        sync_glitches++;
+    }
+    sync_matches = 0;
+    sync_periods++;
+}
+
+static void sync_compare0_handler(void) {
+    sync_matches++;
+}
+
+static uint16_t sync_period_count(void) {
+    cli();
+    uint16_t periods = sync_periods;
+    sei();
+    return periods;
+}
+
+/**
+ * @brief Change all three duty cycles once per period, at a varying point
+ * @param buffered Through the compare buffers in one locked batch; false
+ *                 writes CMP0-2 directly, as a control
+ * @param periods PWM periods to run
+ * @return Periods without exactly one CMP0 match
+ */
+static uint16_t sync_run(bool buffered, uint16_t periods) {
+    uint16_t period = TCA0_GetPeriod();
+    uint16_t low = period / 20;           // 5%..95%
+    uint16_t span = period - 2 * low;
+    uint16_t step = 0;
+    
+    // Count from a period boundary
+    uint16_t seen = sync_period_count();
+    while (sync_period_count() == seen) {
+    }
+    cli();
+    sync_periods = 0;
+    sync_glitches = 0;
+    sei();
+    
+    while (sync_period_count() < periods) {
+        // Somewhere else in the period each time, below or above CMP0
+        uint16_t at = (uint16_t)(step * 7u) % period;
+        seen = sync_period_count();
+        while (TCA0_Read() < at && sync_period_count() == seen) {
+        }
+        
+        // CMP0 jumps about half the range each time, to either side
+        uint16_t cmp0 = low + (uint16_t)(step * 139u) % span;
+        uint16_t cmp1 = low + (uint16_t)(step * 3u) % span;
+        uint16_t cmp2 = low + (uint16_t)(step * 7u) % span;
+        if (buffered) {
+            // Three channels, one commit: they change in the same period
+            TCA0_BeginUpdate();
+            TCA0_SetCompareBuffered(TCA_CMP_CHANNEL0, cmp0);
+            TCA0_SetCompareBuffered(TCA_CMP_CHANNEL1, cmp1);
+            TCA0_SetCompareBuffered(TCA_CMP_CHANNEL2, cmp2);
+            TCA0_EndUpdate();
+        } else {
+            TCA0.SINGLE.CMP0 = cmp0;
+            TCA0.SINGLE.CMP1 = cmp1;
+            TCA0.SINGLE.CMP2 = cmp2;
+        }
+        step += 13;
+        
+        // Let an UPDATE copy the batch before the next one locks it again
+        seen = sync_period_count();
+        while (sync_period_count() == seen) {
+        }
+    }
+    
+    cli();
+    uint16_t glitches = sync_glitches;
+    sei();
+    return glitches;
+}
+
+/**
+ * @brief Example 10: Synchronized PWM updates - no runt pulses
+ * 
+ * All three duty cycles change every period, written at a different point
+ * in the period each time. Through the compare buffers a batch is copied
+ * at one UPDATE, so every period has exactly one CMP0 match. The control
+ * run writes CMP0 directly: a new value below CNT skips this period's
+ * match (WO0 stays high for an extra period), one above CNT after the
+ * match gives a second one. The check counts as working only if the
+ * control run sees such periods. tools/tca_sync_model.c runs the same
+ * schedule on a model of the counter (make check).
+ */
+void example_synchronized_updates(void) {
+    printf("=== Example 10: Synchronized PWM Updates ===\n");
+    
+    if (!TCA0_InitializePWM(1000, 50, 50, 50)) {
+        printf("Failed to initialize PWM at 1kHz\n");
+        return;
+    }
+    TCA0_OverflowCallbackRegister(sync_overflow_handler);
+    TCA0_Compare0CallbackRegister(sync_compare0_handler);
+    TCA0_EnableSpecificInterrupt(TCA_INT_OVF);
+    TCA0_EnableSpecificInterrupt(TCA_INT_CMP0);
+    
+    uint16_t buffered = sync_run(true, 1000);
+    uint16_t direct = sync_run(false, 1000);
+    TCA0_DisableSpecificInterrupt(TCA_INT_ALL);
+    
+    printf("Periods without exactly one CMP0 match, of 1000:\n");
+    printf("- buffered batches: %u\n", buffered);
+    printf("- direct writes:    %u\n", direct);
+    if (direct == 0) {
+        printf("Control saw no glitches: check inconclusive\n");
+    } else {
+        printf("%s\n", (buffered == 0) ? "No glitches" : "GLITCHES");
+    }
+}
+
 // =============================================================================
 // CALLBACK FUNCTION IMPLEMENTATIONS
 // =============================================================================
@@ -369,6 +514,8 @@ int main(void) {
     example_precision_timing();
     example_reset_and_reinit();
     example_event_system_integration();
+    example_split_mode_leds();
+    example_synchronized_updates();
     
     printf("\n=== All TCA0 examples completed ===\n");
     printf("Total overflow interrupts: %lu\n", overflow_count);
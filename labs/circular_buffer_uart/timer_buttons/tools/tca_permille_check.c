@@ -0,0 +1,94 @@
+/**
+ * @file tca_permille_check.c
+ * @author Arturo Salinas
+ * @date 2025-09-24
+ * @brief Check the duty-cycle helpers for every period and permille
+ *
+ * For every counts per period from 1 to 65536 and every permille from 0
+ * to 1001 (above 1000 must clamp):
+ *
+ * - TCA_PermilleToCompare() must equal round(counts * permille / 1000),
+ *   half up, computed here in 64 bits with a real division, and clamped
+ *   to 0xFFFF.
+ * - From 1000 counts up, TCA_CompareToPermille() must give the permille
+ *   back.
+ *
+ * and for every compare value below counts (from counts up it is 100%):
+ *
+ * - TCA_CompareToPercent() must equal round(compare * 100 / counts), half
+ *   up, the percent path of the duty-cycle getters.
+ *
+ * Build and run: make check (host compiler)
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "tca.h"
+
+#define COUNTS_MAX 0x10000UL
+#define ROUND_TRIP_MIN 1000
+
+int main(void)
+{
+    unsigned long checked = 0, wrong = 0, round_trip = 0;
+
+    for (uint32_t counts = 1; counts <= COUNTS_MAX; counts++) {
+        for (uint16_t permille = 0; permille <= TCA_DUTY_PERMILLE_MAX + 1;
+             permille++) {
+            uint16_t pm = (permille > TCA_DUTY_PERMILLE_MAX)
+                              ? TCA_DUTY_PERMILLE_MAX : permille;
+            uint64_t want = ((uint64_t)counts * pm * 2 + 1000) / 2000;
+            if (want > 0xFFFF) {
+                want = 0xFFFF;
+            }
+            uint16_t compare = TCA_PermilleToCompare(counts, permille);
+            checked++;
+
+            if (compare != want) {
+                if (wrong++ < 10) {
+                    printf("counts %" PRIu32 ", %u permille: compare %u, "
+                           "want %" PRIu64 "\n",
+                           counts, permille, compare, want);
+                }
+            }
+            if (counts >= ROUND_TRIP_MIN &&
+                TCA_CompareToPermille(counts, compare) != pm) {
+                if (round_trip++ < 10) {
+                    printf("counts %" PRIu32 ", %u permille: compare %u "
+                           "reads back as %u\n",
+                           counts, permille, compare,
+                           TCA_CompareToPermille(counts, compare));
+                }
+            }
+        }
+    }
+
+    unsigned long percent_checked = 0, percent_wrong = 0;
+    for (uint32_t counts = 1; counts <= COUNTS_MAX; counts++) {
+        uint32_t last = (counts > 0xFFFF) ? 0xFFFF : counts;
+        for (uint32_t compare = 0; compare <= last; compare++) {
+            uint64_t want = (compare >= counts)
+                                ? 100
+                                : ((uint64_t)compare * 200 + counts) /
+                                      (2 * (uint64_t)counts);
+            uint8_t percent = TCA_CompareToPercent(counts, (uint16_t)compare);
+            percent_checked++;
+
+            if (percent != want) {
+                if (percent_wrong++ < 10) {
+                    printf("counts %" PRIu32 ", compare %" PRIu32 ": %u%%, "
+                           "want %" PRIu64 "%%\n",
+                           counts, compare, percent, want);
+                }
+            }
+        }
+    }
+
+    printf("tca_permille_check: %lu pairs, %lu wrong, %lu round-trip "
+           "failures\n", checked, wrong, round_trip);
+    printf("tca_permille_check: %lu percent pairs, %lu wrong\n",
+           percent_checked, percent_wrong);
+    return (wrong || round_trip || percent_wrong) ? 1 : 0;
+}
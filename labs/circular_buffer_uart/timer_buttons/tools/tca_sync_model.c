@@ -0,0 +1,167 @@
+/**
+ * @file tca_sync_model.c
+ * @author Arturo Salinas
+ * @date 2025-09-24
+ * @brief Model of Example 10: buffered vs direct compare updates
+ *
+ * Runs the write schedule of example_synchronized_updates()
+ * (tca0_usage_examples.c) on a tick-by-tick model of a single-slope TCA
+ * counter, and counts PWM periods without exactly one CMP0 match:
+ *
+ * - CNT counts 0..PER; a match is CNT == CMP0.
+ * - At the end of a period (UPDATE) each CMPnBUF written since the last
+ *   copy goes to CMPn, unless LUPD is set; then it waits for the next one.
+ * - Writes to CMPn take effect on the next tick.
+ *
+ * Three runs, 1000 periods each at PER 3999 (1 kHz from 4 MHz, DIV1):
+ *
+ * - buffered: one locked batch per period, then wait for an UPDATE, as
+ *   the example does. Must have no glitches and copy every batch.
+ * - direct: the control run, writing CMP0 at the same points. Must have
+ *   glitches, or the check could not tell the two apart.
+ * - back to back: locked batches with no wait, as the example first did.
+ *   Reported only: LUPD is set at most UPDATEs, so few batches take
+ *   effect and the match count has nothing to catch.
+ *
+ * CPU time is a model parameter, not a measurement: BATCH_TICKS counts
+ * from BeginUpdate() to EndUpdate(), LOOP_TICKS the rest of the loop.
+ * Their sum does not divide PER + 1, so UPDATE falls at every point of
+ * the back-to-back loop in turn.
+ *
+ * Build and run: make check (host compiler)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define PER 3999
+#define PERIODS 1000
+#define BATCH_TICKS 61
+#define LOOP_TICKS 18
+
+typedef enum {
+    RUN_BUFFERED,
+    RUN_DIRECT,
+    RUN_BACK_TO_BACK
+} run_t;
+
+typedef struct {
+    uint16_t cnt;
+    uint16_t cmp0;
+    uint16_t cmp0buf;
+    bool cmp0bv;                 ///< CMP0BUF written, not yet copied
+    bool lupd;
+    uint16_t matches;            ///< In the current period
+    uint32_t periods;
+    uint32_t glitches;
+    uint32_t copies;             ///< CMP0BUF copies at UPDATE
+} tca_model_t;
+
+/** @brief Advance one timer tick; true at the UPDATE ending a period */
+static bool tick(tca_model_t *t)
+{
+    if (t->cnt == t->cmp0) {
+        t->matches++;
+    }
+    if (t->cnt != PER) {
+        t->cnt++;
+        return false;
+    }
+    t->cnt = 0;
+    if (t->cmp0bv && !t->lupd) {
+        t->cmp0 = t->cmp0buf;
+        t->cmp0bv = false;
+        t->copies++;
+    }
+    if (t->matches != 1) {
+        t->glitches++;
+    }
+    t->matches = 0;
+    t->periods++;
+    return true;
+}
+
+/** @brief Run ticks until CNT reaches at or the period ends */
+static void run_until(tca_model_t *t, uint16_t at)
+{
+    while (t->cnt < at) {
+        if (tick(t)) {
+            return;
+        }
+    }
+}
+
+/** @brief Run ticks until the next UPDATE */
+static void run_to_update(tca_model_t *t)
+{
+    while (!tick(t)) {
+    }
+}
+
+static void run_ticks(tca_model_t *t, uint16_t n)
+{
+    while (n--) {
+        tick(t);
+    }
+}
+
+static uint32_t run(run_t kind, uint32_t *batches)
+{
+    tca_model_t t = {0};
+    uint16_t low = PER / 20;
+    uint16_t span = PER - 2 * low;
+    uint16_t step = 0;
+
+    // InitializePWM(1000, 50, ...): CMP0 at half of PER + 1 counts
+    t.cmp0 = (PER + 1) / 2;
+    *batches = 0;
+
+    while (t.periods < PERIODS) {
+        uint16_t cmp0 = low + (uint16_t)(step * 139u) % span;
+        if (kind == RUN_BACK_TO_BACK) {
+            t.lupd = true;
+            run_ticks(&t, BATCH_TICKS);
+            t.cmp0buf = cmp0;
+            t.cmp0bv = true;
+            t.lupd = false;
+            run_ticks(&t, LOOP_TICKS);
+        } else {
+            run_until(&t, (uint16_t)(step * 7u) % PER);
+            if (kind == RUN_BUFFERED) {
+                t.lupd = true;
+                run_ticks(&t, BATCH_TICKS);
+                t.cmp0buf = cmp0;
+                t.cmp0bv = true;
+                t.lupd = false;
+            } else {
+                t.cmp0 = cmp0;
+            }
+            run_to_update(&t);
+        }
+        step += 13;
+        (*batches)++;
+    }
+
+    const char *name[] = {"buffered", "direct", "back to back"};
+    printf("%-12s %5u batches, %5u copied at UPDATE, %4u of %u periods "
+           "without one CMP0 match\n",
+           name[kind], (unsigned)*batches,
+           (kind == RUN_DIRECT) ? 0u : (unsigned)t.copies,
+           (unsigned)t.glitches, (unsigned)t.periods);
+    return (kind == RUN_BUFFERED && t.copies != *batches) ? UINT32_MAX
+                                                           : t.glitches;
+}
+
+int main(void)
+{
+    uint32_t batches;
+    uint32_t buffered = run(RUN_BUFFERED, &batches);
+    uint32_t direct = run(RUN_DIRECT, &batches);
+    run(RUN_BACK_TO_BACK, &batches);
+
+    bool ok = (buffered == 0 && direct != 0);
+    printf("tca_sync_model: %s\n",
+           ok ? "buffered clean, control glitches" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file tca_timing_sweep.c
+ * @author Arturo Salinas
+ * @date 2025-09-24
+ * @brief Check TCA_CalculateTiming() against an exhaustive search
+ *
+ * For every frequency from 1 Hz to 1 MHz, at several peripheral clocks,
+ * the prescaler and period chosen by TCA_CalculateTiming() must be the
+ * closest of all 8 x 65535 (prescaler, PER) pairs the timer can run, with
+ * the same tie-break as the driver: the smaller prescaler, then the
+ * shorter period. The reported achievedHz and errorPpm are checked too.
+ *
+ * The search does not walk all pairs for each frequency (5e11 steps):
+ * every pair is listed once, sorted by clock cycles per period, and the
+ * closest pair for a frequency is one of the two cycle counts either side
+ * of clk / frequency.
+ *
+ * Build and run: make check (host compiler)
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tca.h"
+
+#define COUNTS_MAX 0x10000UL         // PER + 1
+#define FREQ_MAX 1000000UL
+
+static const uint8_t shifts[8] = {0, 1, 2, 3, 4, 6, 8, 10};
+static const uint32_t clocks[] = {4000000UL, 3333333UL, 16000000UL,
+                                  24000000UL};
+
+/**
+ * @brief One distinct period length, with the pair that wins a tie
+ */
+typedef struct {
+    uint32_t ticks;                  ///< Clock cycles per period
+    uint8_t index;                   ///< Smallest prescaler giving it
+} candidate_t;
+
+static candidate_t *candidates;
+static size_t candidate_count;
+
+static int by_ticks(const void *a, const void *b)
+{
+    uint32_t x = ((const candidate_t *)a)->ticks;
+    uint32_t y = ((const candidate_t *)b)->ticks;
+    if (x != y) {
+        return (x < y) ? -1 : 1;
+    }
+    return (int)((const candidate_t *)a)->index -
+           (int)((const candidate_t *)b)->index;
+}
+
+static void list_candidates(void)
+{
+    candidates = malloc(8 * COUNTS_MAX * sizeof(*candidates));
+    if (candidates == NULL) {
+        perror("malloc");
+        exit(2);
+    }
+    size_t n = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        for (uint32_t counts = 2; counts <= COUNTS_MAX; counts++) {
+            candidates[n].ticks = counts << shifts[i];
+            candidates[n].index = i;
+            n++;
+        }
+    }
+    qsort(candidates, n, sizeof(*candidates), by_ticks);
+
+    // Keep the smallest prescaler of each cycle count
+    size_t kept = 0;
+    for (size_t k = 0; k < n; k++) {
+        if (kept == 0 || candidates[kept - 1].ticks != candidates[k].ticks) {
+            candidates[kept++] = candidates[k];
+        }
+    }
+    candidate_count = kept;
+}
+
+/** @brief |clk / ticks - f| * ticks, the driver's error measure */
+static uint64_t error_of(uint32_t clk, uint32_t f, uint32_t ticks)
+{
+    uint64_t actual = (uint64_t)f * ticks;
+    return (actual > clk) ? actual - clk : clk - actual;
+}
+
+/** @brief true if candidate a is closer to f than b, or ties and wins */
+static int better(uint32_t clk, uint32_t f, const candidate_t *a,
+                  const candidate_t *b)
+{
+    uint64_t ea = error_of(clk, f, a->ticks) * b->ticks;
+    uint64_t eb = error_of(clk, f, b->ticks) * a->ticks;
+    if (ea != eb) {
+        return ea < eb;
+    }
+    if (a->index != b->index) {
+        return a->index < b->index;
+    }
+    return a->ticks < b->ticks;
+}
+
+/** @brief The closest candidate to f, by exhaustive order */
+static const candidate_t *closest(uint32_t clk, uint32_t f)
+{
+    // First candidate with ticks * f > clk (frequency below f)
+    size_t lo = 0, hi = candidate_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((uint64_t)candidates[mid].ticks * f > clk) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    const candidate_t *best = NULL;
+    if (lo < candidate_count) {
+        best = &candidates[lo];
+    }
+    if (lo > 0 && (best == NULL || better(clk, f, &candidates[lo - 1], best))) {
+        best = &candidates[lo - 1];
+    }
+    return best;
+}
+
+int main(void)
+{
+    unsigned long checked = 0, failures = 0;
+
+    list_candidates();
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+        uint32_t clk = clocks[c];
+        for (uint32_t f = 1; f <= FREQ_MAX; f++) {
+            const candidate_t *want = closest(clk, f);
+            TCA_Timing_t t = {0};
+            bool ok = TCA_CalculateTiming(clk, f, &t);
+            checked++;
+
+            uint8_t index = want->index;
+            uint32_t counts = want->ticks >> shifts[index];
+            uint32_t hz = (clk + want->ticks / 2) / want->ticks;
+            double ppm = ((double)clk - (double)f * want->ticks) * 1e6 /
+                         ((double)f * want->ticks);
+            double ppm_diff = ppm - (double)t.errorPpm;
+
+            if (!ok || t.prescaler != (TCA_ClkSel_t)(index + 1) ||
+                t.period != counts - 1 || t.achievedHz != hz ||
+                ppm_diff <= -1.0 || ppm_diff >= 1.0) {
+                if (failures++ < 10) {
+                    printf("clk %" PRIu32 " Hz, %" PRIu32 " Hz: got "
+                           "DIV%u PER %u %" PRIu32 " Hz %" PRId32 " ppm, "
+                           "want DIV%lu PER %" PRIu32 " %" PRIu32 " Hz\n",
+                           clk, f, ok ? 1u << shifts[t.prescaler - 1] : 0,
+                           t.period, t.achievedHz, t.errorPpm,
+                           1UL << shifts[index], counts - 1, hz);
+                }
+            }
+        }
+    }
+    free(candidates);
+
+    printf("tca_timing_sweep: %lu frequencies, %lu failures\n", checked,
+           failures);
+    return failures ? 1 : 0;
+}
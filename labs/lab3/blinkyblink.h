@@ -1,12 +1,14 @@
 /* blinkyblink.h
  * Minimal millisecond-granularity blinker for AVR-Dx using OUTSET/OUTCLR.
  * - Uses only _delay_ms(1.0) (constant literal) from <util/delay.h>.
+ * - The *_pt versions are coroutines (pt.h) that sleep instead of delay.
  * - Define F_CPU (e.g., -DF_CPU=16000000UL) and compile with -Os or -O2.
  */
 
 #ifndef BLINKYBLINK_H
 #define BLINKYBLINK_H
 
+#include "pt.h"
 #include <avr/io.h>
 #include <stdint.h>
 #include <util/delay.h>
@@ -22,6 +24,39 @@ static inline void bl_delay_ms_var(uint32_t ms) {
   }
 }
 
+/* ---- Internal: period arithmetic shared by both versions ---- */
+static inline uint32_t bl_half_ms(uint32_t freq_hz) {
+  uint32_t half_ms = (500U + freq_hz / 2U) / freq_hz; /* ≈ 500/f, rounded */
+  if (half_ms == 0U) {
+    half_ms = 1U; /* cap at 1 ms → max ~500 Hz */
+  }
+  return half_ms;
+}
+
+static inline uint32_t bl_period_ms(uint32_t freq_hz) {
+  uint32_t period_ms = (1000U + freq_hz / 2U) / freq_hz; /* ≈ 1000/f */
+  if (period_ms == 0U) {
+    period_ms = 1U; /* cap at 1 ms → max ~1000 Hz */
+  }
+  return period_ms;
+}
+
+static inline uint32_t bl_high_ms(uint32_t period_ms, uint16_t duty_pm) {
+  if (duty_pm > 1000U) {
+    duty_pm = 1000U;
+  }
+  return (period_ms * (uint32_t)duty_pm + 500U) / 1000U; /* rounded */
+}
+
+/* Locals do not survive a coroutine wait, so the _pt versions recompute */
+static inline uint32_t bl_on_ms(uint32_t freq_hz, uint16_t duty_pm) {
+  return bl_high_ms(bl_period_ms(freq_hz), duty_pm);
+}
+
+static inline uint32_t bl_off_ms(uint32_t freq_hz, uint16_t duty_pm) {
+  return bl_period_ms(freq_hz) - bl_on_ms(freq_hz, duty_pm);
+}
+
 /* ---- 50% duty versions (OUTSET → delay → OUTCLR → delay) ---- */
 
 // #include "blinkyblink.h"
@@ -41,10 +76,7 @@ static inline void blinkyblink(uint32_t freq_hz, volatile PORT_t *port,
     port->OUTCLR = pin_bm;
     return;
   }
-  uint32_t half_ms = (500U + freq_hz / 2U) / freq_hz; /* ≈ 500/f, rounded */
-  if (half_ms == 0U) {
-    half_ms = 1U; /* cap at 1 ms → max ~500 Hz */
-  }
+  uint32_t half_ms = bl_half_ms(freq_hz);
   port->OUTSET = pin_bm;
   bl_delay_ms_var(half_ms);
   port->OUTCLR = pin_bm;
@@ -56,7 +88,7 @@ static inline void blinkyblink_periods_ms(uint32_t freq_hz,
                                           volatile PORT_t *port, uint8_t pin_bm,
                                           uint32_t periods) {
   while (periods--) {
-    blinkyblink_once_ms(freq_hz, port, pin_bm);
+    blinkyblink(freq_hz, port, pin_bm);
   }
 }
 
@@ -65,7 +97,7 @@ static inline void blinkyblink_forever_ms(uint32_t freq_hz,
                                           volatile PORT_t *port,
                                           uint8_t pin_bm) {
   for (;;) {
-    blinkyblink_once_ms(freq_hz, port, pin_bm);
+    blinkyblink(freq_hz, port, pin_bm);
   }
 }
 
@@ -77,20 +109,8 @@ static inline void bl_pwm_once_ms(uint32_t freq_hz, uint16_t duty_pm,
     port->OUTCLR = pin_bm;
     return;
   }
-  if (duty_pm > 1000U) {
-    duty_pm = 1000U;
-  }
-
-  uint32_t period_ms = (1000U + freq_hz / 2U) / freq_hz; /* ≈ 1000/f */
-  if (period_ms == 0U) {
-    period_ms = 1U; /* cap at 1 ms → max ~1000 Hz */
-  }
-
-  uint32_t high_ms =
-      (period_ms * (uint32_t)duty_pm + 500U) / 1000U; /* rounded */
-  if (high_ms > period_ms) {
-    high_ms = period_ms;
-  }
+  uint32_t period_ms = bl_period_ms(freq_hz);
+  uint32_t high_ms = bl_high_ms(period_ms, duty_pm);
   uint32_t low_ms = period_ms - high_ms;
 
   if (high_ms) {
@@ -125,4 +145,47 @@ static inline void bl_pwm_forever_ms(uint32_t freq_hz, uint16_t duty_pm,
   }
 }
 
+/* ---- Coroutine versions (pt.h): the same waveforms without blocking ---- */
+
+// static pt_t blink;
+//
+// static PT_THREAD(sweep(pt_t *pt)) {
+//   PT_BEGIN(pt);
+//   PT_SPAWN(pt, &blink, bl_blink_pt(&blink, 7, &PORTD, PIN0_bm));
+//   PT_END(pt);
+// }
+/* One full period at ~50% duty. Periods are capped at 65535 ms. */
+static inline PT_THREAD(bl_blink_pt(pt_t *pt, uint32_t freq_hz,
+                                    volatile PORT_t *port, uint8_t pin_bm)) {
+  PT_BEGIN(pt);
+  if (freq_hz == 0U) {
+    port->OUTCLR = pin_bm;
+    PT_EXIT(pt);
+  }
+  port->OUTSET = pin_bm;
+  PT_SLEEP_MS(pt, bl_half_ms(freq_hz));
+  port->OUTCLR = pin_bm;
+  PT_SLEEP_MS(pt, bl_half_ms(freq_hz));
+  PT_END(pt);
+}
+
+/* One full PWM period with duty in permille (e.g., 200 = 20%). */
+static inline PT_THREAD(bl_pwm_pt(pt_t *pt, uint32_t freq_hz, uint16_t duty_pm,
+                                  volatile PORT_t *port, uint8_t pin_bm)) {
+  PT_BEGIN(pt);
+  if (freq_hz == 0U) {
+    port->OUTCLR = pin_bm;
+    PT_EXIT(pt);
+  }
+  if (bl_on_ms(freq_hz, duty_pm)) {
+    port->OUTSET = pin_bm;
+    PT_SLEEP_MS(pt, bl_on_ms(freq_hz, duty_pm));
+  }
+  if (bl_off_ms(freq_hz, duty_pm)) {
+    port->OUTCLR = pin_bm;
+    PT_SLEEP_MS(pt, bl_off_ms(freq_hz, duty_pm));
+  }
+  PT_END(pt);
+}
+
 #endif /* BLINKYBLINK_H */
@@ -1,9 +1,13 @@
 #define F_CPU 16000000UL
 #include <avr/cpufunc.h>
+#include <avr/interrupt.h>
 #include <avr/io.h>
 #include <avr/ioavr128db48.h>
 #include <util/delay.h>
 
+#include "blinkyblink.h"
+#include "pt.h"
+
 void init_cpu() {
   ccp_write_io((void *)&(CLKCTRL.OSCHFCTRLA), CLKCTRL_FRQSEL_16M_gc);
 }
@@ -12,56 +16,54 @@ void init_cpu() {
 #include <stdbool.h>
 #include <stdint.h>
 
-bool debounceInput(uint8_t port, uint8_t pin) {
-  if (!(port & (1 << pin))) {
-    _delay_ms(10);
-    if (!(port & (1 << pin))) {
-      return true;
-    }
-  }
-  return false;
+// 1 ms system tick for the coroutines (TCB0 periodic interrupt)
+static volatile uint16_t tick_ms = 0;
+
+void init_tick() {
+  TCB0.CCMP = F_CPU / 2 / 1000 - 1; // CLK_PER/2 → 1 kHz
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  TCB0.CTRLA = TCB_CLKSEL_DIV2_gc | TCB_ENABLE_bm;
 }
 
-enum { FREQ_MIN = 1, FREQ_MAX = 10 };
+ISR(TCB0_INT_vect) {
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  tick_ms++;
+}
 
-static inline void delay_halfperiod_by_freq(uint8_t f) {
-  switch (f) {
-  case 1:
-    _delay_ms(500.0);
-    break; // 1 Hz  → T=1000 ms → T/2 = 500 ms
-  case 2:
-    _delay_ms(250.0);
-    break; // 2 Hz  → 500 ms → 250 ms
-  case 3:
-    _delay_ms(166.667);
-    break; // 3 Hz  → 333.333 ms → 166.667 ms
-  case 4:
-    _delay_ms(125.0);
-    break; // 4 Hz  → 250 ms → 125 ms
-  case 5:
-    _delay_ms(100.0);
-    break; // 5 Hz  → 200 ms → 100 ms
-  case 6:
-    _delay_ms(83.333);
-    break; // 6 Hz  → 166.667 → 83.333
-  case 7:
-    _delay_ms(71.429);
-    break; // 7 Hz  → 142.857 → 71.429
-  case 8:
-    _delay_ms(62.5);
-    break; // 8 Hz  → 125 → 62.5
-  case 9:
-    _delay_ms(55.556);
-    break; // 9 Hz  → 111.111 → 55.556
-  case 10:
-    _delay_ms(50.0);
-    break; // 10 Hz → 100 → 50
-  default:
-    _delay_ms(166.667);
-    break; // fallback (3 Hz)
+uint16_t pt_clock(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t now = tick_ms;
+  SREG = sreg;
+  return now;
+}
+
+// Debounced button: the state only changes after 10 ms at the new level
+typedef struct {
+  pt_t pt;
+  uint8_t pin_bm;
+  bool pressed;
+} button_t;
+
+static inline bool button_level(const button_t *b) {
+  return !(PORTB.IN & b->pin_bm); // Active low with pullup
+}
+
+// debounceInput() without the busy wait
+static PT_THREAD(debounce_pt(button_t *b)) {
+  PT_BEGIN(&b->pt);
+  while (1) {
+    PT_WAIT_UNTIL(&b->pt, button_level(b) != b->pressed);
+    PT_SLEEP_MS(&b->pt, 10);
+    if (button_level(b) != b->pressed) {
+      b->pressed = !b->pressed;
+    }
   }
+  PT_END(&b->pt);
 }
 
+enum { FREQ_MIN = 1, FREQ_MAX = 10 };
+
 static inline uint8_t clamp_freq(int16_t f) {
   if (f < FREQ_MIN)
     return FREQ_MIN;
@@ -70,59 +72,94 @@ static inline uint8_t clamp_freq(int16_t f) {
   return (uint8_t)f;
 }
 
-int main(void) {
-  init_cpu();
+static button_t btn1 = {{0, 0}, PIN2_bm, false}; // Port B, Pin 2
+static button_t btn2 = {{0, 0}, PIN5_bm, false}; // Port B, Pin 5
+static uint8_t freq = 3;                         // 3 Hz
 
-  PORTD.DIRSET = 0xFF; // PD0..PD7 = outputs
-  PORTD.OUTCLR = 0xFF; // all off
-
-  PORTB.PIN2CTRL |= PORT_PULLUPEN_bm;
-  PORTB.PIN5CTRL |= PORT_PULLUPEN_bm;
-
-  PORTB.DIRCLR = (1 << 2) | (1 << 5);
-
-  uint8_t led_idx = 2;   // Active LED: 0..7
-  uint8_t freq = 3;      // 3 Hz
-  uint8_t direction = 1; // 1: up, 0: down
+static inline bool both_pressed(void) { return btn1.pressed && btn2.pressed; }
 
+// Knight-rider sweep 0..7..0, one blink per LED; pauses while both
+// buttons are held
+static PT_THREAD(sweep_pt(pt_t *pt)) {
+  static pt_t blink;
+  static int8_t i;
+  PT_BEGIN(pt);
   while (1) {
+    // forward 0..7
+    for (i = 0; i < 8; i++) {
+      PT_WAIT_WHILE(pt, both_pressed());
+      PT_SPAWN(pt, &blink, bl_blink_pt(&blink, freq, &PORTD, 1u << i));
+    }
 
-    bool BTN1 = debounceInput(PORTB.IN, 2); // Port B, Pin 2
-    bool BTN2 = debounceInput(PORTB.IN, 5); // Port B, Pin 5
-
-    if (!BTN1 && !BTN2) {
-      // forward 0..7
-      for (uint8_t i = 0; i < 8; i++) {
-        blinkyblink(freq, &PORTB, (uint8_t)(1u << i)); // or (PIN0_bm << i)
-      }
-
-      // reverse 7..0 (safe descending idiom)
-      for (int8_t i = 7; i >= 0; i--) {
-        blinkyblink(freq, &PORTB, (uint8_t)(1u << i));
-      }
+    // reverse 7..0 (safe descending idiom)
+    for (i = 7; i >= 0; i--) {
+      PT_WAIT_WHILE(pt, both_pressed());
+      PT_SPAWN(pt, &blink, bl_blink_pt(&blink, freq, &PORTD, 1u << i));
+    }
+  }
+  PT_END(pt);
+}
 
-    } else if (BTN1 && !BTN2) {
-      freq = freq + 1; // Increase frequency
+// One button steps the frequency; both held walk a single LED
+static PT_THREAD(control_pt(pt_t *pt)) {
+  static uint8_t led_idx = 2;   // Active LED: 0..7
+  static uint8_t direction = 1; // 1: up, 0: down
+  PT_BEGIN(pt);
+  while (1) {
+    PT_WAIT_UNTIL(pt, btn1.pressed || btn2.pressed);
+    PT_SLEEP_MS(pt, 50); // Let a two-button press land
 
-    } else if (BTN2 && !BTN1) {
-      freq = freq - 1; // Decrease frequency
+    if (btn1.pressed && !btn2.pressed) {
+      freq = clamp_freq(freq + 1); // Increase frequency
+    } else if (btn2.pressed && !btn1.pressed) {
+      freq = clamp_freq(freq - 1); // Decrease frequency
+    }
 
-    } else if (BTN1 && BTN2) {
+    while (both_pressed()) {
+      PORTD.OUTCLR = 0xFF;
       if (direction) {
-        PORTD.OUTCLR = (1 << led_idx);
         if (led_idx < 7)
           led_idx++;
         if (led_idx == 7)
           direction = false;
       } else {
-        PORTD.OUTCLR = (1 << led_idx);
         if (led_idx > 0)
           led_idx--;
         if (led_idx == 0)
           direction = true;
       }
       PORTD.OUTSET = (1 << led_idx);
+      PT_SLEEP_MS(pt, 100);
     }
+
+    PT_WAIT_WHILE(pt, btn1.pressed || btn2.pressed);
+  }
+  PT_END(pt);
+}
+
+int main(void) {
+  init_cpu();
+  init_tick();
+
+  PORTD.DIRSET = 0xFF; // PD0..PD7 = outputs
+  PORTD.OUTCLR = 0xFF; // all off
+
+  PORTB.PIN2CTRL |= PORT_PULLUPEN_bm;
+  PORTB.PIN5CTRL |= PORT_PULLUPEN_bm;
+
+  PORTB.DIRCLR = (1 << 2) | (1 << 5);
+
+  static pt_t sweep, control;
+  PT_INIT(&sweep);
+  PT_INIT(&control);
+  sei();
+
+  // Each call runs a coroutine up to its next wait
+  while (1) {
+    debounce_pt(&btn1);
+    debounce_pt(&btn2);
+    control_pt(&control);
+    sweep_pt(&sweep);
   }
   return 0;
 }
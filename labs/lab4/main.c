@@ -8,6 +8,8 @@
 #include <stdint.h>
 #include <util/delay.h>
 
+#include "pt.h"
+
 volatile uint8_t current_freq = 4;
 
 void init_cpu() {
@@ -26,42 +28,67 @@ bool debounceInput(uint8_t port_val, uint8_t pin) {
 
 enum { FREQ_MIN = 1, FREQ_MAX = 10 };
 
-static inline void delay_halfperiod_by_freq(uint8_t f) {
-  switch (f) {
-  case 1:
-    _delay_ms(500.0);
-    break; // 1 Hz  → T=1000 ms → T/2 = 500 ms
-  case 2:
-    _delay_ms(250.0);
-    break; // 2 Hz  → 500 ms → 250 ms
-  case 3:
-    _delay_ms(166.667);
-    break; // 3 Hz  → 333.333 ms → 166.667 ms
-  case 4:
-    _delay_ms(125.0);
-    break; // 4 Hz  → 250 ms → 125 ms
-  case 5:
-    _delay_ms(100.0);
-    break; // 5 Hz  → 200 ms → 100 ms
-  case 6:
-    _delay_ms(83.333);
-    break; // 6 Hz  → 166.667 → 83.333
-  case 7:
-    _delay_ms(71.429);
-    break; // 7 Hz  → 142.857 → 71.429
-  case 8:
-    _delay_ms(62.5);
-    break; // 8 Hz  → 125 → 62.5
-  case 9:
-    _delay_ms(55.556);
-    break; // 9 Hz  → 111.111 → 55.556
-  case 10:
-    _delay_ms(50.0);
-    break; // 10 Hz → 100 → 50
-  default:
-    _delay_ms(125.0);
-    break; // fallback (4 Hz default)
+// Half period in ms, rounded (3 Hz → 166.667 → 167 ms)
+static inline uint16_t halfperiod_ms_by_freq(uint8_t f) {
+  if (f < FREQ_MIN || f > FREQ_MAX) {
+    return 125; // fallback (4 Hz default)
+  }
+  return (500U + f / 2U) / f;
+}
+
+// 1 ms system tick for the coroutines (TCB0 periodic interrupt)
+static volatile uint16_t tick_ms = 0;
+
+void init_tick() {
+  TCB0.CCMP = F_CPU / 2 / 1000 - 1; // CLK_PER/2 → 1 kHz
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  TCB0.CTRLA = TCB_CLKSEL_DIV2_gc | TCB_ENABLE_bm;
+}
+
+ISR(TCB0_INT_vect) {
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  tick_ms++;
+}
+
+uint16_t pt_clock(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t now = tick_ms;
+  SREG = sreg;
+  return now;
+}
+
+// The former delay_halfperiod_by_freq() loop as a coroutine: a new
+// frequency from the button ISR applies from the next half period
+static PT_THREAD(sweep_pt(pt_t *pt)) {
+  static uint8_t led_idx = 0;   // Active LED: 0..7
+  static uint8_t direction = 1; // 1: forward (0->7), 0: backward (7->0)
+  PT_BEGIN(pt);
+
+  // Turn on first LED
+  PORTD.OUTSET = (1 << led_idx);
+
+  while (1) {
+    PT_SLEEP_MS(pt, halfperiod_ms_by_freq(current_freq));
+    PORTD.OUTCLR = (1 << led_idx);
+
+    if (direction) { // Move to next LED position
+      led_idx++;     // Forward direction
+      if (led_idx >= 7) {
+        led_idx = 7;
+        direction = 0; // Change direction to backward
+      }
+    } else {
+      led_idx--; // Backward Direction
+      if (led_idx <= 0) {
+        led_idx = 0;
+        direction = 1; // Change direction to forward
+      }
+    }
+    PORTD.OUTSET = (1 << led_idx);
+    PT_SLEEP_MS(pt, halfperiod_ms_by_freq(current_freq));
   }
+  PT_END(pt);
 }
 
 ISR(PORTB_PORT_vect) {
@@ -104,31 +131,13 @@ int main(void) {
   init_led();
   Ext_Int_Init();
 
-  uint8_t led_idx = 0;   // Active LED: 0..7
-  uint8_t direction = 1; // 1: forward (0->7), 0: backward (7->0)
+  init_tick();
 
-  // Turn on first LED
-  PORTD.OUTSET = (1 << led_idx);
+  pt_t sweep;
+  PT_INIT(&sweep);
 
   while (1) {
-    delay_halfperiod_by_freq(current_freq);
-    PORTD.OUTCLR = (1 << led_idx);
-
-    if (direction) { // Move to next LED position
-      led_idx++;     // Forward direction
-      if (led_idx >= 7) {
-        led_idx = 7;
-        direction = 0; // Change direction to backward
-      }
-    } else {
-      led_idx--; // Backward Direction
-      if (led_idx <= 0) {
-        led_idx = 0;
-        direction = 1; // Change direction to forward
-      }
-    }
-    PORTD.OUTSET = (1 << led_idx);
-    delay_halfperiod_by_freq(current_freq);
+    sweep_pt(&sweep); // Runs up to its next sleep, then returns
   }
 
   return 0;
@@ -0,0 +1,121 @@
+/* pt.h
+ * Stackless cooperative coroutines (protothreads) for AVR-Dx.
+ * - A thread is a function that returns at every wait and resumes at the
+ *   same line on its next call; its whole state is one pt_t (4 bytes).
+ * - Locals do not survive a wait: keep loop counters and the like in
+ *   static or caller-owned variables.
+ * - Waits may not sit inside a switch statement of the thread body, and
+ *   each wait needs a line of its own (the line number is the label).
+ * - The application supplies pt_clock(): a free-running tick counter,
+ *   PT_TICK_MS milliseconds per tick (default 1).
+ */
+
+#ifndef PT_H
+#define PT_H
+
+#include <stdint.h>
+
+#ifndef PT_TICK_MS
+#define PT_TICK_MS 1
+#endif
+
+/* Free-running tick count (wraps), provided by the application */
+uint16_t pt_clock(void);
+
+typedef struct {
+  uint16_t lc; /* Line to resume at, 0 = start */
+  uint16_t t0; /* Tick at which the current PT_SLEEP_MS() began */
+} pt_t;
+
+/* ---- Thread return values ---- */
+#define PT_WAITING 0
+#define PT_YIELDED 1
+#define PT_EXITED 2
+#define PT_ENDED 3
+
+/* Milliseconds to ticks, rounded up (at most 65535 ticks) */
+#define PT_MS(ms) ((uint16_t)(((ms) + PT_TICK_MS - 1) / PT_TICK_MS))
+
+#if defined(__GNUC__) && __GNUC__ >= 7
+#define PT_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define PT_FALLTHROUGH
+#endif
+
+/* ---- Local continuations ---- */
+#define PT_THREAD(name_args) char name_args
+
+#define PT_INIT(pt) ((pt)->lc = 0)
+
+#define PT_BEGIN(pt)                                                          \
+  {                                                                           \
+    char pt_yield_flag = 1;                                                   \
+    (void)pt_yield_flag;                                                      \
+    switch ((pt)->lc) {                                                       \
+    case 0:
+
+#define PT_END(pt)                                                            \
+  }                                                                           \
+  PT_INIT(pt);                                                                \
+  return PT_ENDED;                                                            \
+  }
+
+/* ---- Waiting ---- */
+#define PT_WAIT_UNTIL(pt, condition)                                          \
+  do {                                                                        \
+    (pt)->lc = __LINE__;                                                      \
+    PT_FALLTHROUGH;                                                           \
+  case __LINE__:                                                              \
+    if (!(condition)) {                                                       \
+      return PT_WAITING;                                                      \
+    }                                                                         \
+  } while (0)
+
+#define PT_WAIT_WHILE(pt, condition) PT_WAIT_UNTIL((pt), !(condition))
+
+/* Give the other threads one turn */
+#define PT_YIELD(pt)                                                          \
+  do {                                                                        \
+    pt_yield_flag = 0;                                                        \
+    (pt)->lc = __LINE__;                                                      \
+    PT_FALLTHROUGH;                                                           \
+  case __LINE__:                                                              \
+    if (pt_yield_flag == 0) {                                                 \
+      return PT_YIELDED;                                                      \
+    }                                                                         \
+  } while (0)
+
+/* Let the rest of the program run for at least ms milliseconds */
+#define PT_SLEEP_MS(pt, ms)                                                   \
+  do {                                                                        \
+    (pt)->t0 = pt_clock();                                                    \
+    PT_WAIT_UNTIL((pt), (uint16_t)(pt_clock() - (pt)->t0) >= PT_MS(ms));      \
+  } while (0)
+
+/* ---- Child threads ---- */
+#define PT_SCHEDULE(f) ((f) < PT_EXITED)
+
+/* Run a child thread call until it ends */
+#define PT_WAIT_THREAD(pt, thread) PT_WAIT_WHILE((pt), PT_SCHEDULE(thread))
+
+/* Start a child thread from the top and wait for it */
+#define PT_SPAWN(pt, child, thread)                                           \
+  do {                                                                        \
+    PT_INIT(child);                                                           \
+    PT_WAIT_THREAD((pt), (thread));                                           \
+  } while (0)
+
+/* ---- Leaving ---- */
+#define PT_RESTART(pt)                                                        \
+  do {                                                                        \
+    PT_INIT(pt);                                                              \
+    return PT_WAITING;                                                        \
+  } while (0)
+
+#define PT_EXIT(pt)                                                           \
+  do {                                                                        \
+    PT_INIT(pt);                                                              \
+    return PT_EXITED;                                                         \
+  } while (0)
+
+#endif /* PT_H */
@@ -3,14 +3,22 @@
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <avr/sleep.h>
 #include <avr/xmega.h>
 #include <stdbool.h>
 
 #define PER_VALUE 249 // For 1 kHz PWM with F_CPU=16 MHz, prescaler=64
-#define CMP_MIN ((PER_VALUE + 1) * 5 / 100)  // 5%
-#define CMP_MAX ((PER_VALUE + 1) * 95 / 100) // 95%
+#define DUTY_MIN 50    // 5.0% (duty in permille)
+#define DUTY_MAX 950   // 95.0%
+#define DUTY_STEP 10   // 1.0% per press
 
-volatile uint16_t duty_cmp = (PER_VALUE + 1) * 50 / 100; // start at 50%
+// 250 counts per period, so one count is exactly 4 permille and the
+// compare value is a shift: round(duty * 250 / 1000) == (duty + 2) >> 2
+_Static_assert((PER_VALUE + 1) * 4 == 1000, "duty_to_cmp() needs 250");
+
+static inline uint16_t duty_to_cmp(uint16_t duty) { return (duty + 2) >> 2; }
+
+volatile uint16_t duty_pm = 500; // start at 50%
 
 void init_cpu(void) {
   /* Enable crystal oscillator
@@ -73,7 +81,7 @@ void init_tca0(void) {
 
   // Set period and starting compare
   TCA0.SINGLE.PER = PER_VALUE;
-  TCA0.SINGLE.CMP0 = duty_cmp;
+  TCA0.SINGLE.CMP0 = duty_to_cmp(duty_pm);
 
   // Enable TCA0 with prescaler 64
   TCA0.SINGLE.CTRLA = TCA_SINGLE_CLKSEL_DIV64_gc | TCA_SINGLE_ENABLE_bm;
@@ -81,15 +89,17 @@ void init_tca0(void) {
 
 void update_duty(bool increase) {
   if (increase) {
-    if (duty_cmp < CMP_MAX) {
-      duty_cmp += (PER_VALUE + 1) / 100; // +1%
+    if (duty_pm < DUTY_MAX) {
+      duty_pm += DUTY_STEP; // +1%
     }
   } else {
-    if (duty_cmp > CMP_MIN) {
-      duty_cmp -= (PER_VALUE + 1) / 100; // -1%
+    if (duty_pm > DUTY_MIN) {
+      duty_pm -= DUTY_STEP; // -1%
     }
   }
-  TCA0.SINGLE.CMP0 = duty_cmp;
+  // Through the buffer: CMP0 takes it at the next BOTTOM, so a value below
+  // CNT cannot skip this period's match and hold PD0 high through it
+  TCA0.SINGLE.CMP0BUF = duty_to_cmp(duty_pm);
 }
 
 ISR(PORTB_PORT_vect) {
@@ -110,6 +120,11 @@ int main(void) {
   init_tca0();
   sei();
 
+  // TCA0 needs CLK_PER for the PWM output, so IDLE is the deepest mode;
+  // the button interrupt wakes the CPU and it sleeps again on return
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
   while (1) {
+    sleep_cpu();
   }
 }
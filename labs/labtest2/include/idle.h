@@ -0,0 +1,87 @@
+#ifndef IDLE_H_
+#define IDLE_H_
+
+/**
+ * @file idle.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Tickless idle: sleep the main loop until the next event
+ *
+ * The main loop calls idle_sleep() after a pass that found nothing to do.
+ * Nothing sleeps while deferred timer callbacks, received bytes or work
+ * reported by the idle_set_work_check() hook wait.
+ * Otherwise the next software timer expiry picks the mode:
+ * - none armed: STANDBY until an interrupt (no periodic wakeup at all),
+ * - more than one PIT period away: STANDBY, woken by the RTC PIT,
+ * - closer: IDLE, with the TCA0 period stretched over the ticks in
+ *   between so only the tick that has work wakes the CPU.
+ *
+ * TCA0 does not run in STANDBY; the RTC counter measures the time asleep
+ * and the swtimer wheel is advanced by it on wakeup. A timer started by
+ * the ISR that ends a STANDBY is timed from when the standby began.
+ *
+ * Wake sources in STANDBY: RTC overflow and PIT, USART3 start-of-frame
+ * detection, and any pin interrupt the application enables. The HF
+ * crystal is kept running in STANDBY so the first received byte is not
+ * lost to its 4K-cycle start-up; CPU and peripheral clocks still stop.
+ *
+ * Build with -DAOS_IDLE_PROBE (make IDLE_PROBE=1) to drive PC6 low while
+ * asleep. Scope it against the RX line for wake-up latency, and use its
+ * duty cycle with a current meter to split sleep and run current.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief USART whose start-of-frame detection wakes from STANDBY */
+#define IDLE_USART USART3
+
+/**
+ * @brief Sleep statistics since idle_reset()
+ */
+typedef struct {
+  uint32_t idle_sleeps;    ///< IDLE mode entries
+  uint32_t standby_sleeps; ///< STANDBY mode entries
+  uint32_t ticks_skipped;  ///< TCA0 tick interrupts avoided
+} idle_stats_t;
+
+/**
+ * @brief Set up wake sources (after init_tca0() and RTC_init())
+ * @param f_cpu_hz CPU clock in Hz
+ * @param rtc_hz RTC clock in Hz; the RTC must count it undivided and run
+ *               in standby (RTC_RUNSTDBY_bm)
+ */
+void idle_init(uint32_t f_cpu_hz, uint16_t rtc_hz);
+
+/**
+ * @brief Add an application check for pending work
+ * @param pending Called with interrupts disabled right before sleeping;
+ *                returning true skips the sleep (NULL removes it)
+ */
+void idle_set_work_check(bool (*pending)(void));
+
+/**
+ * @brief Sleep until the next event (call after an idle main-loop pass)
+ * @param allow_standby false while a peripheral that needs CLK_PER is
+ *                      running (for example a WATCH capture)
+ */
+void idle_sleep(bool allow_standby);
+
+/**
+ * @brief Advance the timer wheel (call from ISR(TCA0_OVF_vect))
+ *
+ * Replaces swtimer_tick(); runs every tick covered by a stretched period.
+ */
+void idle_tick(void);
+
+/**
+ * @brief Copy the sleep statistics
+ */
+void idle_get_stats(idle_stats_t *stats);
+
+/**
+ * @brief Clear the sleep statistics
+ */
+void idle_reset(void);
+
+#endif /* IDLE_H_ */
@@ -0,0 +1,125 @@
+/**
+ * @file irq.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Interrupt priority (CPUINT) and service latency probe on TCB1
+ */
+
+#include "irq.h"
+#include <avr/cpufunc.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <string.h>
+
+//================================
+// Internal State
+//================================
+static uint8_t high_vector = IRQ_NONE;
+static volatile uint16_t overruns = 0;
+static bool probe_on = false;
+static bool probe_level1 = false;
+static irq_latency_t probe;
+
+//================================
+// Public Interface
+//================================
+
+void irq_set_high(uint8_t vector_num) {
+  high_vector = vector_num;
+  if (!(probe_on && probe_level1)) {
+    CPUINT.LVL1VEC = vector_num;
+  }
+}
+
+uint8_t irq_high(void) { return high_vector; }
+
+void irq_set_round_robin(bool enable) {
+  uint8_t ctrla = CPUINT.CTRLA;
+  if (enable) {
+    ctrla |= CPUINT_LVL0RR_bm;
+  } else {
+    ctrla &= ~CPUINT_LVL0RR_bm;
+    CPUINT.LVL0PRI = 0; // Back to the reset order
+  }
+  ccp_write_io((uint8_t *)&CPUINT.CTRLA, ctrla);
+}
+
+bool irq_round_robin(void) { return (CPUINT.CTRLA & CPUINT_LVL0RR_bm) != 0; }
+
+void irq_rx_overrun(void) { overruns++; }
+
+uint16_t irq_rx_overruns(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t n = overruns;
+  SREG = sreg;
+  return n;
+}
+
+void irq_probe_start(uint32_t f_clk_per, bool high) {
+  irq_probe_stop();
+  irq_probe_reset();
+
+  probe_level1 = high;
+  if (high) {
+    CPUINT.LVL1VEC = TCB1_INT_vect_num;
+  }
+
+  TCB1.CTRLA = 0;
+  TCB1.CTRLB = TCB_CNTMODE_INT_gc;
+  TCB1.CNT = 0;
+  TCB1.CCMP = (uint16_t)(f_clk_per / IRQ_PROBE_HZ - 1);
+  TCB1.INTFLAGS = TCB_CAPT_bm;
+  TCB1.INTCTRL = TCB_CAPT_bm;
+  TCB1.CTRLA = TCB_CLKSEL_DIV1_gc | TCB_ENABLE_bm;
+  probe_on = true;
+}
+
+void irq_probe_stop(void) {
+  TCB1.CTRLA = 0;
+  TCB1.INTCTRL = 0;
+  TCB1.INTFLAGS = TCB_CAPT_bm;
+  probe_on = false;
+  CPUINT.LVL1VEC = high_vector;
+}
+
+bool irq_probe_running(void) { return probe_on; }
+
+bool irq_probe_high(void) { return probe_level1; }
+
+bool irq_probe_get(irq_latency_t *latency) {
+  uint8_t sreg = SREG;
+  cli();
+  *latency = probe;
+  SREG = sreg;
+  return latency->samples != 0;
+}
+
+void irq_probe_reset(void) {
+  uint8_t sreg = SREG;
+  cli();
+  memset(&probe, 0, sizeof(probe));
+  overruns = 0;
+  SREG = sreg;
+}
+
+//================================
+// Probe ISR
+//================================
+ISR(TCB1_INT_vect) {
+  uint16_t late = TCB1.CNT; // Counted from zero since the request
+  TCB1.INTFLAGS = TCB_CAPT_bm;
+
+  if (probe.samples == 0 || late < probe.min) {
+    probe.min = late;
+  }
+  if (late > probe.max) {
+    probe.max = late;
+  }
+  if (probe.total + late < probe.total) {
+    probe.total >>= 1; // Halve both, as perf.c does
+    probe.samples >>= 1;
+  }
+  probe.total += late;
+  probe.samples++;
+}
@@ -0,0 +1,110 @@
+#ifndef IRQ_H_
+#define IRQ_H_
+
+/**
+ * @file irq.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Interrupt priority (CPUINT) and service latency probe
+ *
+ * At level 0 CPUINT serves pending vectors in fixed order, lowest vector
+ * number first, so USART3 waits behind TCA0, RTC and the ports and behind
+ * whichever handler is already running. One vector may be raised to level
+ * 1: it preempts every level-0 handler, and its latency is then bounded by
+ * the longest interrupts-disabled section rather than the longest ISR.
+ * Round-robin rotates the level-0 order so that no vector waits more than
+ * one turn of each of the others.
+ *
+ * The probe measures what a vector actually waits. TCB1 runs in periodic
+ * interrupt mode at about 1 kHz (a prime rate, so it drifts through the
+ * 10 ms tick and the RTC second) and its counter restarts at the compare
+ * match, so TCB1.CNT read in the ISR is the number of cycles since the
+ * interrupt was requested, including the entry sequence and prologue.
+ * Probing at level 1 lends level 1 to TCB1; the configured vector falls
+ * back to level 0 until the probe stops.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief No vector at level 1 */
+#define IRQ_NONE 0
+
+/** @brief Probe rate in Hz (prime) */
+#define IRQ_PROBE_HZ 1009
+
+/**
+ * @brief Probe latency statistics, in CPU cycles
+ */
+typedef struct {
+  uint32_t samples;
+  uint32_t total;
+  uint16_t min;
+  uint16_t max;
+} irq_latency_t;
+
+/**
+ * @brief Raise one vector to level 1
+ * @param vector_num e.g. USART3_RXC_vect_num, or IRQ_NONE
+ */
+void irq_set_high(uint8_t vector_num);
+
+/**
+ * @brief Vector configured for level 1 (IRQ_NONE if none)
+ */
+uint8_t irq_high(void);
+
+/**
+ * @brief Enable or disable level-0 round-robin scheduling
+ */
+void irq_set_round_robin(bool enable);
+
+/**
+ * @brief Check if level-0 round-robin scheduling is on
+ */
+bool irq_round_robin(void);
+
+/**
+ * @brief Count a receive buffer overflow (RX ISR, RXDATAH.BUFOVF set)
+ */
+void irq_rx_overrun(void);
+
+/**
+ * @brief Receive buffer overflows since boot or irq_probe_reset()
+ */
+uint16_t irq_rx_overruns(void);
+
+/**
+ * @brief Start the latency probe on TCB1 (clears its statistics)
+ * @param f_clk_per Peripheral clock in Hz
+ * @param high Probe level 1 (true) or level 0 (false)
+ */
+void irq_probe_start(uint32_t f_clk_per, bool high);
+
+/**
+ * @brief Stop the probe and give level 1 back to the configured vector
+ */
+void irq_probe_stop(void);
+
+/**
+ * @brief Check if the probe is running
+ */
+bool irq_probe_running(void);
+
+/**
+ * @brief Level the probe runs (or last ran) at
+ */
+bool irq_probe_high(void);
+
+/**
+ * @brief Copy the probe statistics
+ * @return false if there are no samples
+ */
+bool irq_probe_get(irq_latency_t *latency);
+
+/**
+ * @brief Clear the probe statistics and the overrun count
+ */
+void irq_probe_reset(void);
+
+#endif /* IRQ_H_ */
@@ -0,0 +1,35 @@
+/**
+ * @file perf.c
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief 32-bit cycle counter on TCB0
+ */
+
+#include "perf.h"
+
+//================================
+// Internal State
+//================================
+volatile uint16_t perf_overflows = 0;
+
+//================================
+// Public Interface
+//================================
+
+void perf_init(void) {
+  TCB0.CTRLA = 0;
+  TCB0.CNT = 0;
+  TCB0.CCMP = 0xFFFF; // Full 16-bit period
+  TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  TCB0.CTRLA = TCB_CLKSEL_DIV1_gc | TCB_ENABLE_bm;
+}
+
+//================================
+// Cycle Counter Overflow
+//================================
+ISR(TCB0_INT_vect) {
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  perf_overflows++;
+}
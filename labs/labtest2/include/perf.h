@@ -0,0 +1,48 @@
+#ifndef PERF_H_
+#define PERF_H_
+
+/**
+ * @file perf.h
+ * @author Arturo Salinas
+ * @date 2025-10-16
+ * @brief Cycle counter for the CPU load report (SYSINFO)
+ *
+ * TCB0 free-runs at the CPU clock (16-bit, period 65536) and its overflow
+ * interrupt extends it to a 32-bit cycle counter.
+ *
+ * This lab only reads the counter: idle.c times each sleep and loadmon.c
+ * each main loop pass, which gives the load, ISR share and loop-time
+ * histogram. The per-site statistics and PERF command of AOS are left out.
+ */
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <stdint.h>
+
+/** @brief Upper 16 bits of the cycle counter (TCB0 overflows) */
+extern volatile uint16_t perf_overflows;
+
+/**
+ * @brief Read the 32-bit cycle counter
+ *
+ * Safe from ISRs and main code. A pending TCB0 overflow that has not been
+ * serviced yet is accounted for.
+ */
+static inline uint32_t perf_now(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t lo = TCB0.CNT;
+  uint16_t hi = perf_overflows;
+  if ((TCB0.INTFLAGS & TCB_CAPT_bm) && lo < 0x8000) {
+    hi++;
+  }
+  SREG = sreg;
+  return ((uint32_t)hi << 16) | lo;
+}
+
+/**
+ * @brief Start TCB0 as the free-running cycle counter
+ */
+void perf_init(void);
+
+#endif /* PERF_H_ */
@@ -14,6 +14,10 @@
 
 #include "ui.h"
 #include "circularbuff.h"
+#include "dashboard.h"
+#include "idle.h"
+#include "irq.h"
+#include "loadmon.h"
 #include "uart.h"
 #include <avr/cpufunc.h>
 #include <avr/interrupt.h>
@@ -198,6 +202,8 @@ static void cmd_reset(const char *params);
 static void cmd_uart_test(const char *params);
 static void cmd_gpio_test(const char *params);
 static void cmd_timer_info(const char *params);
+static void cmd_dash(const char *params);
+static void cmd_irq(const char *params);
 
 // Legacy RTC commands for backward compatibility
 static void cmd_set_time(const char *params);
@@ -217,7 +223,7 @@ static const command_t commands[] = {
     // System Commands
     {"HELP", cmd_help, "HELP                    - Show all commands"},
     {"SYSINFO", cmd_sysinfo,
-     "SYSINFO                 - Show system information"},
+     "SYSINFO [RESET]         - System info, CPU load, loop times"},
     {"RESET", cmd_reset, "RESET                   - Software reset"},
 
     // Register and Memory Commands
@@ -237,6 +243,9 @@ static const command_t commands[] = {
     {"GPIO", cmd_gpio_test,
      "GPIO <port> <pin> <val> - Test GPIO (D,B,C pin 0-7, val 0/1)"},
     {"TIMER", cmd_timer_info, "TIMER                   - Show timer status"},
+    {"DASH", cmd_dash, "DASH [ON|OFF]           - Live status dashboard"},
+    {"IRQ", cmd_irq,
+     "IRQ [PROBE [LOW]|STOP|RESET] - Priorities and RX latency"},
 
     // RTC Application Commands (legacy)
     {"SET", cmd_set_time, "SET HH:MM:SS            - Set current time"},
@@ -249,6 +258,55 @@ static const command_t commands[] = {
     {NULL, NULL, NULL} // End marker
 };
 
+//================================
+// Dashboard Layout
+//================================
+
+static void dash_time(char *buf) {
+  snprintf(buf, DASH_VALUE_LEN + 1, "%02d:%02d:%02d", current_time.hours,
+           current_time.minutes, current_time.seconds);
+}
+
+static void dash_countdown(char *buf) {
+  if (!countdown_set) {
+    strcpy(buf, "INACTIVE");
+  } else if (countdown_finished) {
+    strcpy(buf, "FINISHED");
+  } else {
+    snprintf(buf, DASH_VALUE_LEN + 1, "%02d:%02d %s", countdown_time.minutes,
+             countdown_time.seconds, countdown_paused ? "PAUSED" : "RUN");
+  }
+}
+
+// LED bar on PORTD (countdown value / finish blink)
+static void dash_leds(char *buf) {
+  uint8_t out = PORTD.OUT;
+  for (int8_t i = 7; i >= 0; i--) {
+    *buf++ = (out & (1 << i)) ? '1' : '0';
+  }
+  *buf = '\0';
+}
+
+static void dash_uart(char *buf) {
+  snprintf(buf, DASH_VALUE_LEN + 1, "tx %u rx %u", uart_tx_free_space(),
+           uart_rx_available());
+}
+
+static void dash_cmdq(char *buf) {
+  snprintf(buf, DASH_VALUE_LEN + 1, "%u/%u",
+           (unsigned)circular_buf_size(cmd_line_buffer), CMD_BUFFER_SIZE);
+}
+
+static const dash_field_t dash_layout[] = {
+    {1, 1, "LAB TEST 2 - COUNTDOWN   p: pause  r: resume", NULL},
+    {2, 1, "Time:      ", dash_time},
+    {2, 30, "Countdown: ", dash_countdown},
+    {3, 1, "LEDs:      ", dash_leds},
+    {3, 30, "UART:      ", dash_uart},
+    {4, 1, "CmdQ:      ", dash_cmdq},
+    {5, 1, "-----------------------------------------------------------",
+     NULL}};
+
 //================================
 // Public Interface Implementation
 //================================
@@ -256,14 +314,18 @@ static const command_t commands[] = {
 void ui_init(void) {
   cmd_line_buffer = circular_buf_init(cmd_line_storage, CMD_BUFFER_SIZE);
   current_cmd_index = 0;
+  dash_init(dash_layout, sizeof(dash_layout) / sizeof(dash_layout[0]));
 }
 
-void ui_process_commands(void) {
+bool ui_process_commands(void) {
+  bool busy = uart_rx_available() || !circular_buf_empty(cmd_line_buffer);
+
   // Collect any new input from UART
   collect_uart_input();
 
   // Execute any queued commands
   execute_next_command();
+  return busy;
 }
 
 void ui_show_welcome(void) {
@@ -490,7 +552,12 @@ static void cmd_help(const char *params) {
 }
 
 static void cmd_sysinfo(const char *params) {
-  (void)params;
+  if (params != NULL && strcasecmp(params, "RESET") == 0) {
+    loadmon_reset();
+    idle_reset();
+    aos_send("Loop statistics cleared\r\n\r\n");
+    return;
+  }
   aos_send("\r\nSYSTEM INFORMATION\r\n");
   aos_send("-----------------------------------------------------------\r\n");
   if (aos_f_cpu_hz) {
@@ -518,6 +585,33 @@ static void cmd_sysinfo(const char *params) {
   aos_printf("Command Buffer: %u/%u used\r\n",
              (unsigned)circular_buf_size(cmd_line_buffer),
              (unsigned)CMD_BUFFER_SIZE);
+
+  // Load and main-loop jitter (SYSINFO RESET clears the histogram)
+  loadmon_stats_t load;
+  loadmon_get(&load);
+  aos_printf("CPU Load: %u.%u%%                ISR Share: %u.%u%%\r\n",
+             load.cpu_permille / 10, load.cpu_permille % 10,
+             load.isr_permille / 10, load.isr_permille % 10);
+  aos_printf("Worst Loop: %lu us           Idle Pass: %u cycles\r\n",
+             (unsigned long)load.worst_us, load.baseline_cycles);
+  idle_stats_t sleep;
+  idle_get_stats(&sleep);
+  aos_printf("Asleep: %u.%u%%  Idle: %lu  Standby: %lu  Ticks Skipped: "
+             "%lu\r\n",
+             load.sleep_permille / 10, load.sleep_permille % 10,
+             (unsigned long)sleep.idle_sleeps,
+             (unsigned long)sleep.standby_sleeps,
+             (unsigned long)sleep.ticks_skipped);
+  aos_send("Loop Time Histogram:\r\n");
+  for (uint8_t i = 0; i < LOADMON_BUCKETS; i++) {
+    uint32_t limit = loadmon_bucket_limit_us(i);
+    if (limit) {
+      aos_printf("  < %6lu us: %u\r\n", (unsigned long)limit, load.hist[i]);
+    } else {
+      aos_printf("  >=%6lu us: %u\r\n",
+                 (unsigned long)loadmon_bucket_limit_us(i - 1), load.hist[i]);
+    }
+  }
   aos_send(
       "-----------------------------------------------------------\r\n\r\n");
 }
@@ -803,6 +897,81 @@ static void cmd_timer_info(const char *params) {
       "-----------------------------------------------------------\r\n\r\n");
 }
 
+static void cmd_dash(const char *params) {
+  if (params == NULL || *params == '\0') {
+    uint32_t updates = dash_update_count();
+    aos_printf("Dashboard: %s\r\n", dash_active() ? "ON" : "OFF");
+    aos_printf("Sent %lu bytes in %lu updates (%lu bytes/update)\r\n\r\n",
+               dash_bytes_sent(), updates,
+               updates ? dash_bytes_sent() / updates : 0UL);
+    return;
+  }
+
+  if (strcasecmp(params, "ON") == 0) {
+    dash_start();
+  } else if (strcasecmp(params, "OFF") == 0) {
+    dash_stop();
+  } else {
+    aos_send("Usage: DASH [ON|OFF]\r\n\r\n");
+  }
+}
+
+static void cmd_irq(const char *params) {
+  if (params != NULL && strncasecmp(params, "PROBE", 5) == 0) {
+    // Probe the level RX runs at unless LOW asks for level 0
+    bool high = irq_high() != IRQ_NONE && strcasecmp(params, "PROBE LOW");
+    irq_probe_start(aos_f_cpu_hz, high);
+    aos_printf("Latency probe running at level %u (IRQ STOP ends it)\r\n\r\n",
+               high ? 1 : 0);
+    return;
+  }
+  if (params != NULL && strcasecmp(params, "STOP") == 0) {
+    irq_probe_stop();
+    aos_send("Latency probe stopped\r\n\r\n");
+    return;
+  }
+  if (params != NULL && strcasecmp(params, "RESET") == 0) {
+    irq_probe_reset();
+    aos_send("Latency samples and overrun count cleared\r\n\r\n");
+    return;
+  }
+
+  aos_send("\r\nINTERRUPT PRIORITY\r\n");
+  aos_send("-----------------------------------------------------------\r\n");
+  uint8_t vector = irq_high();
+  if (vector == USART3_RXC_vect_num) {
+    aos_printf("Level 1 vector: %u (USART3_RXC)\r\n", vector);
+  } else if (vector != IRQ_NONE) {
+    aos_printf("Level 1 vector: %u\r\n", vector);
+  } else {
+    aos_send("Level 1 vector: none\r\n");
+  }
+  aos_printf("Level 0 order:  %s\r\n",
+             irq_round_robin() ? "round-robin" : "fixed (lowest vector first)");
+  aos_printf("RX overruns:    %u\r\n", irq_rx_overruns());
+
+  // One 8N1 frame; the RX FIFO holds two, so a byte is lost when service
+  // is late by more than about two of these
+  uint32_t char_cycles = aos_f_cpu_hz / aos_uart_baud * 10;
+  uint16_t cycles_per_us = aos_f_cpu_hz / 1000000UL;
+  irq_latency_t lat;
+  if (irq_probe_get(&lat)) {
+    aos_printf("Probe level %u%s: %lu samples\r\n", irq_probe_high() ? 1 : 0,
+               irq_probe_running() ? " (running)" : "",
+               (unsigned long)lat.samples);
+    aos_printf("Latency: min %u avg %lu max %u cycles, max %u us\r\n",
+               lat.min, (unsigned long)(lat.total / lat.samples), lat.max,
+               lat.max / cycles_per_us);
+    aos_printf("Worst case: %lu%% of a character time (%lu us)\r\n",
+               (unsigned long)((uint32_t)lat.max * 100 / char_cycles),
+               (unsigned long)(char_cycles / cycles_per_us));
+  } else {
+    aos_send("Latency probe: no samples (IRQ PROBE starts it)\r\n");
+  }
+  aos_send(
+      "-----------------------------------------------------------\r\n\r\n");
+}
+
 //================================
 // Legacy RTC Commands
 //================================
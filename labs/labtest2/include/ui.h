@@ -44,6 +44,7 @@ extern volatile rtc_time_t alarm_time;
 extern volatile rtc_time_t countdown_time;
 extern volatile bool countdown_set;
 extern volatile bool countdown_finished;
+extern volatile bool countdown_paused;
 extern volatile bool alarm_set;
 extern volatile bool alarm_triggered;
 extern volatile uint32_t rtc_interrupt_count;
@@ -66,8 +67,10 @@ void ui_init(void);
  * This function should be called regularly from the main loop.
  * It collects input from UART, builds command lines, and executes
  * any complete commands that have been received.
+ *
+ * @return true if there was input or a queued command to handle
  */
-void ui_process_commands(void);
+bool ui_process_commands(void);
 
 /**
  * @brief Display Arturo's OS boot message and help
@@ -7,6 +7,12 @@
 #define F_CPU 16000000UL // 16 MHz clock speed
 #define __AVR_AVR128DB48__
 #include "include/cpu.h"
+#include "include/dashboard.h"
+#include "include/idle.h"
+#include "include/irq.h"
+#include "include/loadmon.h"
+#include "include/perf.h"
+#include "include/swtimer.h"
 #include "include/uart.h"
 #include "include/ui.h"
 #include <avr/cpufunc.h>
@@ -29,21 +35,32 @@ volatile bool countdown_paused = false;
 volatile uint32_t rtc_interrupt_count = 0;
 
 // Global variable for button pushing
-volatile uint16_t button_counter = 0;
 volatile bool button_pushed = false;
 
-// Timer-based counters
-volatile uint16_t tca_tick_counter = 0;
-volatile uint16_t led_blink_counter = 0;
-volatile uint16_t status_display_counter = 0;
-volatile bool display_status_flag = false;
-
 // LED display state variables
-volatile uint16_t led_display_counter = 0;
 volatile bool display_hours = true;
-volatile uint16_t countdown_blink_counter = 0;
 volatile bool countdown_blink_done = false;
 
+// Periodic activities on the TCA0 tick (see include/swtimer.h)
+static void button_sample(void *ctx);
+static void led_display(void *ctx);
+static void countdown_blink(void *ctx);
+static void countdown_blink_stop(void *ctx);
+static void show_status(void *ctx);
+
+static swtimer_t button_timer = SWTIMER_INIT(button_sample, NULL, SWTIMER_ISR);
+static swtimer_t led_display_timer =
+    SWTIMER_INIT(led_display, NULL, SWTIMER_DEFERRED);
+static swtimer_t blink_timer = SWTIMER_INIT(countdown_blink, NULL, SWTIMER_ISR);
+static swtimer_t blink_stop_timer =
+    SWTIMER_INIT(countdown_blink_stop, NULL, SWTIMER_ISR);
+static swtimer_t status_timer =
+    SWTIMER_INIT(show_status, NULL, SWTIMER_DEFERRED);
+
+// RTC bottom half: the ISR only counts the second (see swtimer_defer())
+static void rtc_seconds(void *ctx);
+static swtimer_t rtc_work = SWTIMER_INIT(rtc_seconds, NULL, SWTIMER_DEFERRED);
+
 //********************************
 // LED Initialization
 // Set up 8 LEDs
@@ -59,11 +76,19 @@ void init_led() {
 
 //*********************************
 // Button Initialization
-// Configure 1 Button at Pin B5 for polling
+// Configure 1 Button at Pin B5; its edges start polling (and wake sleep)
 // ********************************
 void init_button() {
-  PORTB.DIRCLR = PIN5_bm;            // External button - input
-  PORTB.PIN5CTRL = PORT_PULLUPEN_bm; // Enable pull-up only (no interrupts)
+  PORTB.DIRCLR = PIN5_bm; // External button - input
+  PORTB.PIN5CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
+}
+
+// A button edge starts sampling; nothing polls while it is released
+ISR(PORTB_PORT_vect) {
+  PORTB.INTFLAGS = PIN5_bm;
+  if (!swtimer_active(&button_timer)) {
+    swtimer_start(&button_timer, 1, 1);
+  }
 }
 
 //************************************************
@@ -86,86 +111,117 @@ ISR(TCA0_OVF_vect) {
   // Clear interrupt flag
   TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
 
-  if (button_counter < 65535) {
-    if (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
-      button_counter++;
+  idle_tick(); // One or more ticks, see include/idle.h
+}
+
+//*****************************************************************************
+// Software Timer Callbacks
+//*****************************************************************************
+
+// Every tick while the button is down: held for 100 ticks (1 s) counts as
+// a press; stops on release until the next pin edge
+static void button_sample(void *ctx) {
+  static uint8_t held = 0;
+  (void)ctx;
+  if (!(PORTB.IN & PIN2_bm) || !(PORTB.IN & PIN5_bm)) {
+    if (++held >= 100) {
+      button_pushed = true;
+      held = 0;
     }
   } else {
-    button_counter = 0;
-  }
-  if (button_counter >= 100) {
-    button_pushed = true;
-    button_counter = 0;
+    swtimer_stop(&button_timer);
   }
+}
 
-  // Increment 10ms tick counter
-  tca_tick_counter++;
+// Every second, from the main loop: LED binary display, 5 seconds each for
+// hours and minutes
+static void led_display(void *ctx) {
+  static uint8_t phase = 0;
+  (void)ctx;
 
-  // Handle LED blinking when countdown finished (10Hz for 5 seconds)
   if (countdown_finished && !countdown_blink_done) {
-    countdown_blink_counter++;
-    led_blink_counter++;
+    return; // Countdown blink owns the LEDs
+  }
 
-    if (led_blink_counter >= 5) { // 50ms period for 10Hz
-      led_blink_counter = 0;
-      PORTD.OUTTGL = 0xFF; // Toggle all LEDs
-    }
+  if (phase < 5) {
+    display_hours = true;
+    PORTB.OUTCLR = PIN3_bm; // PB3 ON (active low) to indicate hours
+    // Display hours 0-12 in binary across LSB of PORTD (bits 0-3 for 0-15
+    // range)
+    uint8_t hours_12 = current_time.hours % 12; // Convert to 12-hour format
+    PORTD.OUT = (PORTD.OUT & 0xF0) | (hours_12 & 0x0F); // Use bits 0-3
+  } else {
+    display_hours = false;
+    PORTB.OUTSET = PIN3_bm; // PB3 OFF (active low) to indicate minutes
+    // Display minutes 0-59 in binary across full PORTD (bits 0-7)
+    PORTD.OUT = current_time.minutes;
+  }
+  if (++phase >= 10) {
+    phase = 0;
+  }
+}
 
-    // Stop blinking after 5 seconds (500 * 10ms)
-    if (countdown_blink_counter >= 500) {
-      countdown_blink_done = true;
-      PORTD.OUTCLR = 0xFF; // Turn off all LEDs
-    }
+// Every 50 ms after the countdown finishes (10 Hz)
+static void countdown_blink(void *ctx) {
+  (void)ctx;
+  PORTD.OUTTGL = 0xFF; // Toggle all LEDs
+}
+
+// 5 seconds after the countdown finishes
+static void countdown_blink_stop(void *ctx) {
+  (void)ctx;
+  swtimer_stop(&blink_timer);
+  countdown_blink_done = true;
+  PORTD.OUTCLR = 0xFF; // Turn off all LEDs
+}
+
+// Every 2 s, from the main loop (unless the dashboard is on)
+static void show_status(void *ctx) {
+  (void)ctx;
+  if (dash_active()) {
+    return;
   }
 
-  // Handle LED binary display (5 seconds each for hours and minutes)
-  if (!countdown_finished || countdown_blink_done) {
-    led_display_counter++;
-
-    if (led_display_counter < 500) { // First 5 seconds - display hours
-      display_hours = true;
-      PORTB.OUTCLR = PIN3_bm; // PB3 ON (active low) to indicate hours
-      // Display hours 0-12 in binary across LSB of PORTD (bits 0-3 for 0-15
-      // range)
-      uint8_t hours_12 = current_time.hours % 12; // Convert to 12-hour format
-      PORTD.OUT = (PORTD.OUT & 0xF0) | (hours_12 & 0x0F); // Use bits 0-3
-    } else if (led_display_counter < 1000) { // Next 5 seconds - display minutes
-      display_hours = false;
-      PORTB.OUTSET = PIN3_bm; // PB3 OFF (active low) to indicate minutes
-      // Display minutes 0-59 in binary across full PORTD (bits 0-7)
-      PORTD.OUT = current_time.minutes &
-                  0xFF; // Use all 8 bits (0-255 range, perfect for 0-59)
+  aos_send("\r\n=== AOS System Status ===\r\n");
+  ui_display_time();
+
+  // Show countdown status
+  if (countdown_set) {
+    if (countdown_finished) {
+      aos_send("Countdown: FINISHED (00:00) - Press B5 for new countdown\r\n");
     } else {
-      led_display_counter = 0; // Reset cycle
+      aos_printf("Countdown: %02d:%02d ", countdown_time.minutes,
+                 countdown_time.seconds);
+      if (countdown_paused) {
+        aos_send("- PAUSED (press 'r' to resume)\r\n");
+      } else {
+        aos_send("- COUNTING DOWN (press 'p' to pause)\r\n");
+      }
     }
+  } else {
+    aos_send("Countdown: INACTIVE - Press button B5 to start\r\n");
   }
 
-  // Handle periodic status display (every 200 ticks = 2 seconds)
-  status_display_counter++;
-  if (status_display_counter >= 200) { // 2 seconds
-    status_display_counter = 0;
-    // Set flag for main loop to display status
-    display_status_flag = true;
-  }
+  aos_send("AOS> ");
 }
 
 //*****************************************************************************
 // RTC Initialization
 // Set up RTC to overflow every 1 second.
-// Utilize a 1kHz oscillator and a divisor of 128
+// Utilize a 1kHz oscillator, undivided so the counter also times sleep
 //*****************************************************************************
 void RTC_init(void) {
   // 1. Select internal 1.024kHz oscillator
   RTC.CLKSEL = RTC_CLKSEL_OSC1K_gc;
 
-  // 2. Set overflow period: 128*(1+PER) / 1024Hz  => 1 second
-  RTC.PER = 7;
+  // 2. Set overflow period: (1+PER) / 1024Hz  => 1 second
+  RTC.PER = 1023;
 
   // 3. Enable overflow interrupt
   RTC.INTCTRL = RTC_OVF_bm;
 
-  // 4. Enable RTC with 128 prescaler
-  RTC.CTRLA = RTC_RTCEN_bm | RTC_PRESCALER_DIV128_gc;
+  // 4. Enable RTC with no prescaler, also counting in standby sleep
+  RTC.CTRLA = RTC_RTCEN_bm | RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm;
 
   // 5. Global interrupts will be enabled in main()
 }
@@ -180,35 +236,54 @@ ISR(RTC_CNT_vect) {
   rtc_interrupt_count++;
   PORTC.OUTTGL = PIN7_bm;
 
-  // Increment current time
-  current_time.seconds++;
-  if (current_time.seconds >= 60) {
-    current_time.seconds = 0;
-    current_time.minutes++;
+  swtimer_defer(&rtc_work); // Clock and countdown run in rtc_seconds()
+}
+
+// Once per RTC overflow not yet handled, from the main loop
+static void rtc_seconds(void *ctx) {
+  static uint32_t handled = 0;
+  (void)ctx;
+
+  while (1) {
+    cli();
+    bool behind = handled != rtc_interrupt_count;
+    sei();
+    if (!behind) {
+      break;
+    }
+    handled++;
 
-    if (current_time.minutes >= 60) {
-      current_time.minutes = 0;
-      current_time.hours++;
+    // Increment current time
+    current_time.seconds++;
+    if (current_time.seconds >= 60) {
+      current_time.seconds = 0;
+      current_time.minutes++;
 
-      if (current_time.hours >= 24) {
-        current_time.hours = 0;
+      if (current_time.minutes >= 60) {
+        current_time.minutes = 0;
+        current_time.hours++;
+
+        if (current_time.hours >= 24) {
+          current_time.hours = 0;
+        }
       }
     }
-  }
 
-  // Handle countdown logic
-  if (countdown_set && !countdown_paused && !countdown_finished) {
-    // Decrement countdown time
-    if (countdown_time.seconds > 0) {
-      countdown_time.seconds--;
-    } else if (countdown_time.minutes > 0) {
-      countdown_time.minutes--;
-      countdown_time.seconds = 59;
-    } else {
-      // Countdown reached 00:00
-      countdown_finished = true;
-      countdown_blink_done = false;
-      countdown_blink_counter = 0;
+    // Handle countdown logic
+    if (countdown_set && !countdown_paused && !countdown_finished) {
+      // Decrement countdown time
+      if (countdown_time.seconds > 0) {
+        countdown_time.seconds--;
+      } else if (countdown_time.minutes > 0) {
+        countdown_time.minutes--;
+        countdown_time.seconds = 59;
+      } else {
+        // Countdown reached 00:00
+        countdown_finished = true;
+        countdown_blink_done = false;
+        swtimer_start(&blink_timer, SWTIMER_MS(50), SWTIMER_MS(50));
+        swtimer_start(&blink_stop_timer, SWTIMER_MS(5000), 0);
+      }
     }
   }
 }
@@ -217,6 +292,14 @@ ISR(RTC_CNT_vect) {
 // USART Interrupt Service Routines
 // ********************************
 ISR(USART3_RXC_vect) {
+  // Start-of-frame wakeup from standby shares this vector
+  USART3.STATUS = USART_RXSIF_bm;
+  if (!(USART3.STATUS & USART_RXCIF_bm)) {
+    return;
+  }
+  if (USART3.RXDATAH & USART_BUFOVF_bm) {
+    irq_rx_overrun(); // A byte was lost before this one
+  }
   char receivedChar = USART3.RXDATAL;
   uart_rx_isr_handler(receivedChar);
 }
@@ -224,6 +307,7 @@ ISR(USART3_RXC_vect) {
 ISR(USART3_DRE_vect) {
   char data_to_send;
   if (uart_tx_isr_handler(&data_to_send)) {
+    USART3.STATUS = USART_TXCIF_bm; // Set again once this frame is out
     USART3.TXDATAL = data_to_send;
   } else {
     USART3.CTRLA &= ~USART_DREIE_bm;
@@ -241,7 +325,8 @@ void init_countdown() {
   countdown_finished = false;
   countdown_paused = false;
   countdown_blink_done = false;
-  countdown_blink_counter = 0;
+  swtimer_stop(&blink_timer);
+  swtimer_stop(&blink_stop_timer);
 }
 
 //*****************************************************************************
@@ -295,54 +380,63 @@ int main(void) {
   uart_init(3, BAUD_RATE, F_CLK_PER, NULL);
   ui_set_system_info(F_CLK_PER, BAUD_RATE);
 
+  // RX preempts the tick and RTC handlers; the rest take turns (irq.h)
+  irq_set_high(USART3_RXC_vect_num);
+  irq_set_round_robin(true);
+
   // Initialize TCA0 timer for periodic tasks
   init_tca0();
+  swtimer_start(&led_display_timer, 1, SWTIMER_MS(1000));
+  swtimer_start(&status_timer, SWTIMER_MS(2000), SWTIMER_MS(2000));
 
   // Initialize RTC for timekeeping
   RTC_init();
 
+  // Sleep between events (RTC counts the undivided 1.024 kHz clock)
+  idle_init(F_CLK_PER, 1024);
+
+  // TCB0 cycle counter for the CPU load meter
+  perf_init();
+  loadmon_init(F_CLK_PER);
+
   // Enable global interrupts
   sei();
 
   // Show welcome message
   ui_show_welcome();
+  uint32_t dash_last_second = 0;
+
   // Main loop
   while (1) {
     // Process UART commands (non-blocking)
-    ui_process_commands();
+    bool busy = ui_process_commands();
     if (button_pushed && !(PORTB.IN & PIN5_bm)) {
       aos_printf("\r\nButton Pressed! Countdown Started!\r\n");
       aos_printf("Starting countdown from: %02d:%02d\r\n", current_time.minutes,
                  current_time.seconds);
       init_countdown();
       button_pushed = false; // Reset flag after handling
+      busy = true;
     }
 
-    // Display periodic status including countdown
-    if (display_status_flag) {
-      display_status_flag = false;
-      aos_send("\r\n=== AOS System Status ===\r\n");
-      ui_display_time();
-
-      // Show countdown status
-      if (countdown_set) {
-        if (countdown_finished) {
-          aos_send(
-              "Countdown: FINISHED (00:00) - Press B5 for new countdown\r\n");
-        } else {
-          aos_printf("Countdown: %02d:%02d ", countdown_time.minutes,
-                     countdown_time.seconds);
-          if (countdown_paused) {
-            aos_send("- PAUSED (press 'r' to resume)\r\n");
-          } else {
-            aos_send("- COUNTING DOWN (press 'p' to pause)\r\n");
-          }
-        }
-      } else {
-        aos_send("Countdown: INACTIVE - Press button B5 to start\r\n");
-      }
+    // Dashboard sends only changed fields, once per RTC second
+    if (dash_active() && rtc_interrupt_count != dash_last_second) {
+      dash_last_second = rtc_interrupt_count;
+      dash_update();
+      busy = true;
+    }
+
+    // ISR bottom halves and deferred timer callbacks (clock, LEDs, status)
+    if (swtimer_process()) {
+      busy = true;
+    }
+
+    // Idle passes calibrate the load meter, busy ones count as load
+    loadmon_loop(busy);
 
-      aos_send("AOS> ");
+    // Nothing left to do: sleep until the next interrupt or timer
+    if (!busy) {
+      idle_sleep(true);
     }
   }
 